@@ -0,0 +1,17 @@
+# Find liburing
+# Once done this will define
+#  URING_FOUND - liburing found
+#  URING_LIBRARY - library to link against
+#  URING_INCLUDE_DIR - directory containing liburing.h
+if(NOT URING_FOUND)
+  find_library(URING_LIBRARY NAMES uring PATH_SUFFIXES lib lib64)
+  find_path(URING_INCLUDE_DIR liburing.h)
+  if(URING_LIBRARY AND URING_INCLUDE_DIR)
+    include(CheckLibraryExists)
+    check_library_exists(${URING_LIBRARY} io_uring_queue_init "" URING_FOUND_INTERNAL)
+  endif()
+
+  include(FindPackageHandleStandardArgs)
+  find_package_handle_standard_args(URING DEFAULT_MSG URING_LIBRARY URING_INCLUDE_DIR URING_FOUND_INTERNAL)
+  mark_as_advanced(URING_FOUND URING_LIBRARY URING_INCLUDE_DIR)
+endif()
@@ -136,6 +136,17 @@ class ReadMasterAssignment : public PartitioningScaffold {
    * assignment phase.
    */
   bool addMasterMapping(uint32_t, uint32_t) { return false; }
+
+  /**
+   * No-op: masters are given by the read assignment saved with
+   * saveGIDToHost.
+   */
+  void serializeMasters(galois::runtime::SendBuffer&) const {}
+  /**
+   * No-op: masters are given by the read assignment saved with
+   * saveGIDToHost.
+   */
+  void deserializeMasters(galois::runtime::RecvBuffer&) {}
 };
 
 /**
@@ -330,6 +341,42 @@ class CustomMasterAssignment : public PartitioningScaffold {
       return false;
     }
   }
+
+  /**
+   * Serializes the master assignment so that getMaster answers the same after
+   * deserializeMasters.
+   *
+   * @param b buffer to serialize into
+   */
+  void serializeMasters(galois::runtime::SendBuffer& b) const {
+    std::vector<uint64_t> gids;
+    std::vector<uint32_t> masters;
+    gids.reserve(_gid2masters.size());
+    masters.reserve(_gid2masters.size());
+    for (auto& m : _gid2masters) {
+      gids.push_back(m.first);
+      masters.push_back(m.second);
+    }
+    galois::runtime::gSerialize(b, _status, _localNodeToMaster, gids, masters,
+                                _nodeOffset);
+  }
+
+  /**
+   * Restores a master assignment serialized by serializeMasters.
+   *
+   * @param b buffer to deserialize from
+   */
+  void deserializeMasters(galois::runtime::RecvBuffer& b) {
+    std::vector<uint64_t> gids;
+    std::vector<uint32_t> masters;
+    galois::runtime::gDeserialize(b, _status, _localNodeToMaster, gids,
+                                  masters, _nodeOffset);
+    _gid2masters.clear();
+    _gid2masters.reserve(gids.size());
+    for (size_t i = 0; i < gids.size(); ++i) {
+      _gid2masters[gids[i]] = masters[i];
+    }
+  }
 };
 
 } // end namespace graphs
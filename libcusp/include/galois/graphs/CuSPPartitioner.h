@@ -61,6 +61,13 @@ namespace galois {
    * this argument assigns a weight to give each node.
    * @param edgeWeight When using a read policy that involves nodes and edges,
    * this argument assigns a weight to give each edge.
+   * @param readFromFile Load the partition of each host from the local graph
+   * files saved by an earlier run with the same input, host count and
+   * partitioning; partitions as usual if they do not match
+   * @param localGraphFileName Prefix of the local graph files; the host ID is
+   * appended to it
+   * @param saveLocalGraph Save the partition of each host to a local graph
+   * file after partitioning
    *
    * @tparam PartitionPolicy Partitioning policy object that specifies the
    * placement of nodes/edges during partitioning.
@@ -82,15 +89,15 @@ namespace galois {
         std::string transposeGraphFile="",
         bool cuspAsync=true, uint32_t cuspStateRounds=100,
         galois::graphs::MASTERS_DISTRIBUTION readPolicy=galois::graphs::BALANCED_EDGES_OF_MASTERS,
-        uint32_t nodeWeight=0, uint32_t edgeWeight=0
+        uint32_t nodeWeight=0, uint32_t edgeWeight=0,
+        bool readFromFile=false,
+        std::string localGraphFileName="local_graph",
+        bool saveLocalGraph=false
   ) {
     auto& net = galois::runtime::getSystemNetworkInterface();
     using DistGraphConstructor = galois::graphs::NewDistGraphGeneric<NodeData,
                                     EdgeData, PartitionPolicy>;
 
-    // TODO @todo bring back graph saving/reading functionality?
-    std::string localGraphName = "";
-
     if (!symmetricGraph) {
       // out edges or in edges
       std::string inputToUse;
@@ -122,13 +129,15 @@ namespace galois {
 
       return new DistGraphConstructor(inputToUse, net.ID, net.Num, cuspAsync,
                                       cuspStateRounds, useTranspose, readPolicy,
-                                      nodeWeight, edgeWeight);
+                                      nodeWeight, edgeWeight, readFromFile,
+                                      localGraphFileName, 1, saveLocalGraph);
     } else {
       // symmetric graph path: assume the passed in graphFile is a symmetric
       // graph; output is also symmetric
       return new DistGraphConstructor(graphFile, net.ID, net.Num, cuspAsync,
                                       cuspStateRounds, false, readPolicy,
-                                      nodeWeight, edgeWeight);
+                                      nodeWeight, edgeWeight, readFromFile,
+                                      localGraphFileName, 1, saveLocalGraph);
     }
   }
 } // end namespace galois
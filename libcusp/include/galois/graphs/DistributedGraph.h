@@ -29,25 +29,19 @@
 
 #include <unordered_map>
 #include <fstream>
+#include <numeric>
+#include <type_traits>
 
 #include "galois/graphs/LC_CSR_Graph.h"
 #include "galois/graphs/BufferedGraph.h"
+#include "galois/graphs/GlobalToLocalIndex.h"
+#include "galois/graphs/LocalGraphFile.h"
+#include "galois/DReducible.h"
 #include "galois/runtime/DistStats.h"
 #include "galois/graphs/OfflineGraph.h"
 #include "galois/DynamicBitset.h"
 #include "llvm/Support/CommandLine.h"
 
-/*
- * Headers for boost serialization
- */
-//#include <boost/archive/binary_oarchive.hpp>
-//#include <boost/archive/binary_iarchive.hpp>
-//#include <boost/serialization/split_member.hpp>
-//#include <boost/serialization/binary_object.hpp>
-//#include <boost/serialization/serialization.hpp>
-//#include <boost/serialization/vector.hpp>
-//#include <boost/serialization/unordered_map.hpp>
-
 namespace galois {
 namespace graphs {
 /**
@@ -106,11 +100,14 @@ protected:
   std::vector<std::pair<uint64_t, uint64_t>> gid2host;
   //! Mirror nodes from different hosts. For reduce
   std::vector<std::vector<size_t>> mirrorNodes;
+  //! Master nodes with mirrors on different hosts; only kept when read from
+  //! a local graph file
+  std::vector<std::vector<size_t>> masterNodes;
 
   //! GID = localToGlobalVector[LID]
   std::vector<uint64_t> localToGlobalVector;
-  //! LID = globalToLocalMap[GID]
-  std::unordered_map<uint64_t, uint32_t> globalToLocalMap;
+  //! LID = globalToLocalMap.getLID(GID)
+  GlobalToLocalIndex globalToLocalMap;
 
 
 private:
@@ -471,7 +468,29 @@ protected:
 
   uint32_t G2L(uint64_t gid) const {
     assert(isLocal(gid));
-    return globalToLocalMap.at(gid);
+    return globalToLocalMap.getLID(gid);
+  }
+
+  /**
+   * Builds globalToLocalMap from all of localToGlobalVector once the proxies
+   * on this host are final, and reports its size next to the size an
+   * unordered_map would have had.
+   */
+  void buildGlobalToLocalMap() {
+    galois::CondStatTimer<MORE_DIST_STATS> timer("GlobalToLocalMapTime",
+                                                 GRNAME);
+    timer.start();
+    globalToLocalMap.build(localToGlobalVector, numNodes, beginMaster,
+                           numOwned);
+    timer.stop();
+    assert(globalToLocalMap.size() == numNodes);
+
+    size_t bytes     = globalToLocalMap.bytes();
+    size_t hashBytes = GlobalToLocalIndex::hashMapBytes(numNodes);
+    galois::runtime::reportStat_Single(GRNAME, "GlobalToLocalMapBytes", bytes);
+    galois::runtime::reportStat_Single(
+        GRNAME, "GlobalToLocalMapBytesSaved",
+        hashBytes > bytes ? hashBytes - bytes : 0);
   }
 
   uint64_t L2G(uint32_t lid) const {
@@ -501,6 +520,7 @@ public:
     mirrorNodes.resize(numHosts);
     numGlobalNodes = 0;
     numGlobalEdges = 0;
+    beginMaster    = 0;
 
     // report edge buffer size
     //if (host == 0) {
@@ -820,127 +840,350 @@ protected:
    */
   void edgesEqualMasters() { specificRanges[2] = specificRanges[1]; }
 
-public:
-  // TODO make these work again
+private:
   /**
-   * Write the local LC_CSR graph to the file on a disk.
+   * Sends the mirrors of each host to the host of their masters and returns
+   * the masters other hosts have mirrors of, as GluonSubstrate does when it
+   * sets up communication. Must be called by all hosts while mirrorNodes
+   * still holds global IDs.
    *
-   * @param localGraphFileName file name to write local graph to.
-   * @todo revive this
+   * @param masters OUTPUT: global IDs of the masters with a mirror on each
+   * host
    */
-  void save_local_graph_to_file(std::string localGraphFileName = "local_graph") {
-    galois::gWarn("Currently not implemented. TODO");
-    //using namespace boost::archive;
-    //galois::StatTimer dGraphTimerSaveLocalGraph("TimerSaveLocalGraph", GRNAME);
-    //dGraphTimerSaveLocalGraph.start();
+  void exchangeMirrors(std::vector<std::vector<size_t>>& masters) {
+    auto& net = galois::runtime::getSystemNetworkInterface();
+    masters.clear();
+    masters.resize(numHosts);
 
-    //std::string fileName = localGraphFileName + "_" + std::to_string(id);
+    for (unsigned x = 0; x < numHosts; ++x) {
+      if (x == id)
+        continue;
+      galois::runtime::SendBuffer b;
+      galois::runtime::gSerialize(b, mirrorNodes[x]);
+      net.sendTagged(x, galois::runtime::evilPhase, b);
+    }
+    for (unsigned x = 0; x < numHosts; ++x) {
+      if (x == id)
+        continue;
+      decltype(net.recieveTagged(galois::runtime::evilPhase, nullptr)) p;
+      do {
+        p = net.recieveTagged(galois::runtime::evilPhase, nullptr);
+      } while (!p);
+      galois::runtime::gDeserialize(p->second, masters[p->first]);
+    }
+    increment_evilPhase();
+  }
 
-    //galois::gDebug("[", id, "] inside save_local_graph_to_file \n");
+  //! Writes one list per host as a section of counts and one of elements
+  void writeHostLists(LocalGraphFile::Writer& out,
+                      LocalGraphFile::Section countSection,
+                      LocalGraphFile::Section listSection,
+                      const std::vector<std::vector<size_t>>& lists) {
+    std::vector<uint64_t> counts;
+    for (auto& l : lists) {
+      counts.push_back(l.size());
+    }
+    out.add(countSection, counts.data(), counts.size() * sizeof(uint64_t));
+    out.begin(listSection);
+    for (auto& l : lists) {
+      out.append(l.data(), l.size() * sizeof(size_t));
+    }
+  }
 
-    //std::ofstream outputStream(fileName, std::ios::binary);
-    //if (!outputStream.is_open()) {
-    //  std::cerr << "ERROR: Could not open " << fileName
-    //            << " to save local graph!!!\n";
-    //}
+  //! @returns true if the lists of the count and list sections add up
+  bool checkHostLists(const LocalGraphFile& in,
+                      LocalGraphFile::Section countSection,
+                      LocalGraphFile::Section listSection) const {
+    if (in.count<uint64_t>(countSection) != numHosts) {
+      return false;
+    }
+    const uint64_t* counts = in.get<uint64_t>(countSection);
+    uint64_t total = std::accumulate(counts, counts + numHosts, (uint64_t)0);
+    return in.bytes(listSection) == total * sizeof(uint64_t);
+  }
 
-    //boost::archive::binary_oarchive ar(outputStream, boost::archive::no_header);
+  void readHostLists(const LocalGraphFile& in,
+                     LocalGraphFile::Section countSection,
+                     LocalGraphFile::Section listSection,
+                     std::vector<std::vector<size_t>>& lists) {
+    const uint64_t* counts = in.get<uint64_t>(countSection);
+    const uint64_t* list   = in.get<uint64_t>(listSection);
+    lists.resize(numHosts);
+    for (unsigned h = 0; h < numHosts; ++h) {
+      lists[h].assign(list, list + counts[h]);
+      list += counts[h];
+    }
+  }
 
-    //// graph topology
-    //ar << graph;
-    //ar << numGlobalNodes;
-    //ar << numGlobalEdges;
+  //! Number of edges copied at a time when saving
+  static const uint64_t saveChunkEdges = 1 << 20;
 
-    //// bool
-    //ar << transposed;
+  template <typename T = EdgeTy,
+            typename std::enable_if<std::is_void<T>::value>::type* = nullptr>
+  void writeEdgeData(LocalGraphFile::Writer&) {}
 
-    //// Proxy information
-    //// TODO: Find better way to serialize vector of vectors in boost
-    //// serialization
-    //for (uint32_t i = 0; i < numHosts; ++i) {
-    //  ar << masterNodes[i];
-    //  ar << mirrorNodes[i];
-    //}
+  template <typename T = EdgeTy,
+            typename std::enable_if<!std::is_void<T>::value>::type* = nullptr>
+  void writeEdgeData(LocalGraphFile::Writer& out) {
+    if (!std::is_trivially_copyable<T>::value) {
+      GALOIS_DIE("cannot save edge data that is not trivially copyable");
+    }
+    std::vector<T> buf;
+    out.begin(LocalGraphFile::edgeData);
+    for (uint64_t first = 0; first < numEdges; first += saveChunkEdges) {
+      buf.resize(std::min(saveChunkEdges, numEdges - first));
+      galois::do_all(galois::iterate(first, first + buf.size()),
+                     [&](uint64_t e) {
+                       buf[e - first] = graph.getEdgeData(edge_iterator(e));
+                     },
+                     galois::no_stats());
+      out.append(buf.data(), buf.size() * sizeof(T));
+    }
+  }
 
-    //ar << numOwned;
-    //ar << beginMaster;
-    //ar << numNodesWithEdges;
-    //ar << gid2host;
+  template <typename T = EdgeTy,
+            typename std::enable_if<std::is_void<T>::value>::type* = nullptr>
+  void readEdges(const LocalGraphFile& in) {
+    const uint32_t* dsts = in.get<uint32_t>(LocalGraphFile::edgeDsts);
+    galois::do_all(galois::iterate((uint64_t)0, numEdges),
+                   [&](uint64_t e) { graph.constructEdge(e, dsts[e]); },
+                   galois::no_stats());
+  }
 
-    //// Serialize partitioning scheme specific data structures.
-    //boostSerializeLocalGraph(ar);
+  template <typename T = EdgeTy,
+            typename std::enable_if<!std::is_void<T>::value>::type* = nullptr>
+  void readEdges(const LocalGraphFile& in) {
+    const uint32_t* dsts = in.get<uint32_t>(LocalGraphFile::edgeDsts);
+    const T* data        = in.get<T>(LocalGraphFile::edgeData);
+    galois::do_all(
+        galois::iterate((uint64_t)0, numEdges),
+        [&](uint64_t e) { graph.constructEdge(e, dsts[e], data[e]); },
+        galois::no_stats());
+  }
 
-    //outputStream.close();
-    //dGraphTimerSaveLocalGraph.stop();
+  //! @returns size of the data of one edge, 0 for void
+  static uint32_t sizeofEdgeData() {
+    return std::is_void<EdgeTy>::value
+               ? 0
+               : sizeof(typename std::conditional<std::is_void<EdgeTy>::value,
+                                                  char, EdgeTy>::type);
   }
 
   /**
-   * Read the local LC_CSR graph from the file on a disk.
+   * Checks that a local graph file belongs to this host and run and that
+   * its sections have consistent sizes.
    *
-   * @param localGraphFileName file name to read local graph from.
-   * @todo revive this
-   */
-  void
-  read_local_graph_from_file(std::string localGraphFileName = "local_graph") {
-    galois::gWarn("Currently not implemented. TODO");
-    //using namespace boost::archive;
-    //galois::StatTimer dGraphTimerReadLocalGraph("TimerReadLocalGraph", GRNAME);
-    //dGraphTimerReadLocalGraph.start();
-
-    //std::string fileName = localGraphFileName + "_" + std::to_string(id);
-
-    //std::ifstream inputStream(fileName, std::ios::binary);
-    //if (!inputStream.is_open()) {
-    //  std::cerr << "ERROR: Could not open " << fileName
-    //            << " to read local graph!!!\n";
-    //}
-
-    //galois::gPrint("[", id, "] inside read_local_graph_from_file \n");
-
-    //boost::archive::binary_iarchive ar(inputStream, boost::archive::no_header);
+   * @param in mapped local graph file
+   * @param key key the file must have been saved with
+   * @returns true if the graph can be read from the file
+   */
+  bool checkLocalGraphFile(const LocalGraphFile& in,
+                           const std::string& key) const {
+    if (!in.valid() ||
+        in.count<LocalGraphFile::Scalars>(LocalGraphFile::scalars) != 1 ||
+        in.bytes(LocalGraphFile::key) != key.size() ||
+        !std::equal(key.begin(), key.end(),
+                    in.get<char>(LocalGraphFile::key))) {
+      return false;
+    }
 
-    //// Graph topology
-    //ar >> graph;
-    //ar >> numGlobalNodes;
-    //ar >> numGlobalEdges;
+    const auto& s = *in.get<LocalGraphFile::Scalars>(LocalGraphFile::scalars);
+    const uint64_t* ends = in.get<uint64_t>(LocalGraphFile::edgeEnds);
+    return s.hostID == id && s.numHosts == numHosts &&
+           s.sizeofEdgeData == sizeofEdgeData() &&
+           s.numOwned <= s.numNodes && s.numNodesWithEdges <= s.numNodes &&
+           in.bytes(LocalGraphFile::gid2host) ==
+               numHosts * 2 * sizeof(uint64_t) &&
+           in.count<uint64_t>(LocalGraphFile::localToGlobal) == s.numNodes &&
+           in.count<uint64_t>(LocalGraphFile::edgeEnds) == s.numNodes &&
+           (s.numNodes == 0 ? s.numEdges == 0
+                            : ends[s.numNodes - 1] == s.numEdges) &&
+           in.bytes(LocalGraphFile::edgeDsts) ==
+               s.numEdges * sizeof(uint32_t) &&
+           in.bytes(LocalGraphFile::edgeData) ==
+               s.numEdges * s.sizeofEdgeData &&
+           checkHostLists(in, LocalGraphFile::mirrorCounts,
+                          LocalGraphFile::mirrors) &&
+           checkHostLists(in, LocalGraphFile::masterCounts,
+                          LocalGraphFile::masters);
+  }
 
-    //// bool
-    //ar >> transposed;
+protected:
+  /**
+   * Saves the state a partitioning policy needs to answer getHostID after
+   * the graph has been read from a local graph file.
+   */
+  virtual void serializePartitionState(galois::runtime::SendBuffer&) const {}
 
-    //// Proxy information
-    //// TODO: Find better way to Deserialize vector of vectors in boost
-    //// serialization
-    //for (uint32_t i = 0; i < numHosts; ++i) {
-    //  ar >> masterNodes[i];
-    //  ar >> mirrorNodes[i];
-    //}
+  /**
+   * Restores the state saved by serializePartitionState.
+   */
+  virtual void deserializePartitionState(galois::runtime::RecvBuffer&) {}
 
-    //ar >> numOwned;
-    //ar >> beginMaster;
-    //ar >> numNodesWithEdges;
-    //ar >> gid2host;
+public:
+  /**
+   * Writes the partition on this host to localGraphFileName_<host id> (see
+   * LocalGraphFile): the local CSR, the global ID of each local node, the
+   * nodes each host read, the mirrors and masters shared with each host, and
+   * the state of the partitioning policy. Must be called by all hosts right
+   * after partitioning, before a GluonSubstrate is made for the graph.
+   *
+   * @param localGraphFileName prefix of the file to write
+   * @param key identifies the input and partitioning; the file is only read
+   * back with the same key
+   */
+  void save_local_graph_to_file(std::string localGraphFileName = "local_graph",
+                                const std::string& key = "") {
+    static_assert(sizeof(size_t) == sizeof(uint64_t),
+                  "proxy lists are saved as 64-bit global IDs");
+    galois::StatTimer dGraphTimerSaveLocalGraph("TimerSaveLocalGraph", GRNAME);
+    dGraphTimerSaveLocalGraph.start();
+
+    std::vector<std::vector<size_t>> sharedMasters;
+    exchangeMirrors(sharedMasters);
+
+    std::string fileName = localGraphFileName + "_" + std::to_string(id);
+    LocalGraphFile::Writer out(fileName);
+    out.add(LocalGraphFile::key, key.data(), key.size());
+
+    LocalGraphFile::Scalars s;
+    std::memset(&s, 0, sizeof(s));
+    s.numGlobalNodes    = numGlobalNodes;
+    s.numGlobalEdges    = numGlobalEdges;
+    s.numEdges          = numEdges;
+    s.numNodes          = numNodes;
+    s.numOwned          = numOwned;
+    s.beginMaster       = beginMaster;
+    s.numNodesWithEdges = numNodesWithEdges;
+    s.hostID            = id;
+    s.numHosts          = numHosts;
+    s.transposed        = transposed;
+    s.sizeofEdgeData    = sizeofEdgeData();
+    out.add(LocalGraphFile::scalars, &s, sizeof(s));
+
+    std::vector<uint64_t> readRanges;
+    for (auto& r : gid2host) {
+      readRanges.push_back(r.first);
+      readRanges.push_back(r.second);
+    }
+    out.add(LocalGraphFile::gid2host, readRanges.data(),
+            readRanges.size() * sizeof(uint64_t));
+    out.add(LocalGraphFile::localToGlobal, localToGlobalVector.data(),
+            numNodes * sizeof(uint64_t));
+    out.add(LocalGraphFile::edgeEnds, graph.getEdgePrefixSum().data(),
+            numNodes * sizeof(uint64_t));
+
+    std::vector<uint32_t> dsts;
+    out.begin(LocalGraphFile::edgeDsts);
+    for (uint64_t first = 0; first < numEdges; first += saveChunkEdges) {
+      dsts.resize(std::min(saveChunkEdges, numEdges - first));
+      galois::do_all(galois::iterate(first, first + dsts.size()),
+                     [&](uint64_t e) {
+                       dsts[e - first] = graph.getEdgeDst(edge_iterator(e));
+                     },
+                     galois::no_stats());
+      out.append(dsts.data(), dsts.size() * sizeof(uint32_t));
+    }
+    writeEdgeData(out);
 
-    //// Serialize partitioning scheme specific data structures.
-    //boostDeSerializeLocalGraph(ar);
+    writeHostLists(out, LocalGraphFile::mirrorCounts, LocalGraphFile::mirrors,
+                   mirrorNodes);
+    writeHostLists(out, LocalGraphFile::masterCounts, LocalGraphFile::masters,
+                   sharedMasters);
 
-    //allNodesRanges.clear();
-    //masterRanges.clear();
-    //withEdgeRanges.clear();
-    //specificRanges.clear();
+    galois::runtime::SendBuffer b;
+    serializePartitionState(b);
+    out.add(LocalGraphFile::partitionState, b.linearData(), b.size());
+    out.finish();
 
-    //// find ranges again
-    //determineThreadRanges();
-    //determineThreadRangesMaster();
-    //determineThreadRangesWithEdges();
-    //initializeSpecificRanges();
+    dGraphTimerSaveLocalGraph.stop();
+    galois::gPrint("[", id, "] Saved local graph to ", fileName, "\n");
+  }
 
-    //// Exchange information among hosts
-    //// send_info_to_host();
+  /**
+   * Reads the partition on this host from a file written by
+   * save_local_graph_to_file. Must be called by all hosts on a graph that
+   * has not been constructed; either all of them read their files or none
+   * does.
+   *
+   * @param localGraphFileName prefix of the file to read
+   * @param key must equal the key the file was saved with
+   * @returns true if the graph was read; false if the file of some host is
+   * missing or was saved for another input, partitioning or host count
+   */
+  bool
+  read_local_graph_from_file(std::string localGraphFileName = "local_graph",
+                             const std::string& key = "") {
+    galois::StatTimer dGraphTimerReadLocalGraph("TimerReadLocalGraph", GRNAME);
+    dGraphTimerReadLocalGraph.start();
+
+    std::string fileName = localGraphFileName + "_" + std::to_string(id);
+    LocalGraphFile in(fileName);
+    galois::DGAccumulator<uint32_t> unusable;
+    unusable.reset();
+    if (!checkLocalGraphFile(in, key)) {
+      galois::gPrint("[", id, "] ", fileName,
+                     " is missing or does not match this run\n");
+      unusable += 1;
+    }
+    if (unusable.reduce()) {
+      dGraphTimerReadLocalGraph.stop();
+      return false;
+    }
 
-    //inputStream.close();
-    //dGraphTimerReadLocalGraph.stop();
+    const auto& s = *in.get<LocalGraphFile::Scalars>(LocalGraphFile::scalars);
+    numGlobalNodes    = s.numGlobalNodes;
+    numGlobalEdges    = s.numGlobalEdges;
+    numNodes          = s.numNodes;
+    numEdges          = s.numEdges;
+    numOwned          = s.numOwned;
+    beginMaster       = s.beginMaster;
+    numNodesWithEdges = s.numNodesWithEdges;
+    transposed        = s.transposed;
+
+    const uint64_t* readRanges = in.get<uint64_t>(LocalGraphFile::gid2host);
+    gid2host.resize(numHosts);
+    for (unsigned h = 0; h < numHosts; ++h) {
+      gid2host[h] = std::make_pair(readRanges[2 * h], readRanges[2 * h + 1]);
+    }
+    const uint64_t* l2g = in.get<uint64_t>(LocalGraphFile::localToGlobal);
+    localToGlobalVector.assign(l2g, l2g + numNodes);
+    readHostLists(in, LocalGraphFile::mirrorCounts, LocalGraphFile::mirrors,
+                  mirrorNodes);
+    readHostLists(in, LocalGraphFile::masterCounts, LocalGraphFile::masters,
+                  masterNodes);
+
+    graph.allocateFrom(numNodes, numEdges);
+    graph.constructNodes();
+    const uint64_t* ends = in.get<uint64_t>(LocalGraphFile::edgeEnds);
+    galois::do_all(galois::iterate((uint32_t)0, numNodes),
+                   [&](uint32_t n) { graph.fixEndEdge(n, ends[n]); },
+                   galois::no_stats());
+    readEdges(in);
+
+    const uint8_t* state = in.get<uint8_t>(LocalGraphFile::partitionState);
+    galois::runtime::RecvBuffer b(
+        state, state + in.bytes(LocalGraphFile::partitionState));
+    deserializePartitionState(b);
+
+    buildGlobalToLocalMap();
+    determineThreadRanges();
+    determineThreadRangesMaster();
+    determineThreadRangesWithEdges();
+    initializeSpecificRanges();
+
+    dGraphTimerReadLocalGraph.stop();
+    printStatistics();
+    return true;
   }
 
+  /**
+   * Returns the masters with a mirror on each host as global IDs. Only
+   * filled when the graph was read from a local graph file, so that
+   * GluonSubstrate does not have to exchange them; empty otherwise.
+   */
+  std::vector<std::vector<size_t>>& getMasterNodes() { return masterNodes; }
+
   /**
    * Deallocates underlying LC CSR Graph
    */
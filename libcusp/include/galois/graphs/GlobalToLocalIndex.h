@@ -0,0 +1,185 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GlobalToLocalIndex.h
+ *
+ * Contains GlobalToLocalIndex, the compact global to local ID map of
+ * DistGraph.
+ */
+
+#ifndef _GALOIS_GRAPHS_GLOBALTOLOCALINDEX_H_
+#define _GALOIS_GRAPHS_GLOBALTOLOCALINDEX_H_
+
+#include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Maps the global IDs of the proxies on a host to their local IDs.
+ *
+ * One range of local IDs whose global IDs are consecutive (usually the
+ * masters) is stored as just its bounds. The remaining global IDs are kept
+ * sorted next to their local IDs, 12 bytes per proxy instead of the 40 or
+ * more bytes of an unordered_map node plus bucket, and found with a few
+ * interpolation steps followed by binary search.
+ */
+class GlobalToLocalIndex {
+  //! global IDs [rangeBegin, rangeEnd) map to local IDs from rangeLID on
+  uint64_t rangeBegin = 0;
+  uint64_t rangeEnd   = 0;
+  uint32_t rangeLID   = 0;
+
+  //! global IDs outside the range, sorted
+  std::vector<uint64_t> gids;
+  //! lids[i] is the local ID of gids[i]
+  std::vector<uint32_t> lids;
+
+  //! Interpolation steps before falling back to binary search
+  static const unsigned interpolationSteps = 3;
+
+  //! @returns position of gid in gids, or gids.size() if it is not there
+  size_t find(uint64_t gid) const {
+    size_t lo = 0;
+    size_t hi = gids.size();
+    for (unsigned step = 0; step < interpolationSteps && hi - lo > 16;
+         ++step) {
+      uint64_t first = gids[lo];
+      uint64_t last  = gids[hi - 1];
+      if (gid < first || gid > last)
+        return gids.size();
+      double frac  = static_cast<double>(gid - first) /
+                    static_cast<double>(last - first + 1);
+      size_t guess =
+          std::min(lo + static_cast<size_t>(frac * (hi - lo)), hi - 1);
+      if (gids[guess] < gid) {
+        lo = guess + 1;
+      } else if (gids[guess] > gid) {
+        hi = guess;
+      } else {
+        return guess;
+      }
+    }
+    auto ii = std::lower_bound(gids.begin() + lo, gids.begin() + hi, gid);
+    if (ii == gids.begin() + hi || *ii != gid)
+      return gids.size();
+    return ii - gids.begin();
+  }
+
+public:
+  /**
+   * Replaces the contents of the index with local IDs [0, numLocal). Cannot
+   * be called during parallel execution.
+   *
+   * @param localToGlobal global ID of each local ID
+   * @param numLocal number of local IDs to index
+   * @param rangeHint first local ID of a range whose global IDs may be
+   * consecutive (e.g., the masters)
+   * @param rangeSize size of that range
+   */
+  template <typename VecTy>
+  void build(const VecTy& localToGlobal, uint32_t numLocal, uint32_t rangeHint,
+             uint32_t rangeSize) {
+    rangeSize = std::min(rangeSize, numLocal - std::min(rangeHint, numLocal));
+    if (rangeSize) {
+      galois::GAccumulator<uint32_t> gaps;
+      uint64_t first = localToGlobal[rangeHint];
+      galois::do_all(galois::iterate(rangeHint, rangeHint + rangeSize),
+                     [&](uint32_t lid) {
+                       if (localToGlobal[lid] != first + (lid - rangeHint))
+                         gaps += 1;
+                     },
+                     galois::no_stats());
+      if (gaps.reduce())
+        rangeSize = 0;
+    }
+    rangeLID   = rangeSize ? rangeHint : 0;
+    rangeBegin = rangeSize ? localToGlobal[rangeHint] : 0;
+    rangeEnd   = rangeBegin + rangeSize;
+
+    // local IDs outside the range, sorted by global ID
+    lids.resize(numLocal - rangeSize);
+    gids.resize(numLocal - rangeSize);
+    galois::do_all(galois::iterate((uint32_t)0, (uint32_t)lids.size()),
+                   [&](uint32_t i) {
+                     lids[i] = i < rangeLID ? i : i + rangeSize;
+                   },
+                   galois::no_stats());
+    galois::ParallelSTL::sort(lids.begin(), lids.end(),
+                              [&](uint32_t a, uint32_t b) {
+                                return localToGlobal[a] < localToGlobal[b];
+                              });
+    galois::do_all(galois::iterate((size_t)0, lids.size()),
+                   [&](size_t i) { gids[i] = localToGlobal[lids[i]]; },
+                   galois::no_stats());
+    lids.shrink_to_fit();
+    gids.shrink_to_fit();
+  }
+
+  //! @returns true if gid has a local ID
+  bool isLocal(uint64_t gid) const {
+    return (gid >= rangeBegin && gid < rangeEnd) || find(gid) != gids.size();
+  }
+
+  //! @returns local ID of gid, which must be local
+  uint32_t getLID(uint64_t gid) const {
+    if (gid >= rangeBegin && gid < rangeEnd)
+      return rangeLID + (gid - rangeBegin);
+    size_t pos = find(gid);
+    assert(pos != gids.size());
+    return lids[pos];
+  }
+
+  //! @returns number of indexed IDs
+  size_t size() const { return (rangeEnd - rangeBegin) + gids.size(); }
+
+  //! @returns bytes used by the index
+  size_t bytes() const {
+    return sizeof(*this) + gids.capacity() * sizeof(uint64_t) +
+           lids.capacity() * sizeof(uint32_t);
+  }
+
+  //! @returns approximate bytes used by an unordered_map<uint64_t, uint32_t>
+  //! holding n IDs: a node with a next pointer and the pair, the allocator's
+  //! header, plus one bucket pointer per entry
+  static size_t hashMapBytes(size_t n) {
+    return n * (sizeof(void*) + 2 * sizeof(uint64_t) + sizeof(size_t) +
+                sizeof(void*));
+  }
+
+  void clear() {
+    rangeBegin = rangeEnd = 0;
+    rangeLID              = 0;
+    std::vector<uint64_t>().swap(gids);
+    std::vector<uint32_t>().swap(lids);
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,271 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file LocalGraphFile.h
+ *
+ * Binary file holding the partition of a distributed graph on one host, so
+ * that later runs with the same input and partitioning can load it instead
+ * of partitioning again.
+ *
+ * The file starts with a header page that gives the format version and the
+ * offset and size of every section. Sections are arrays in the byte order
+ * of the writing machine and start on page boundaries, so the file is
+ * mapped and the arrays are read in place.
+ */
+
+#ifndef _GALOIS_LOCALGRAPHFILE_H_
+#define _GALOIS_LOCALGRAPHFILE_H_
+
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * A local graph file mapped read-only.
+ */
+class LocalGraphFile {
+public:
+  //! Layout version; files with another version are not read
+  static const uint64_t version = 1;
+
+  //! Sections of a local graph file
+  enum Section {
+    key,             //!< chars identifying the input and the partitioning
+    scalars,         //!< one Scalars
+    gid2host,        //!< uint64_t pairs: nodes each host read
+    localToGlobal,   //!< uint64_t: global ID of each local ID
+    edgeEnds,        //!< uint64_t: end of the edges of each node
+    edgeDsts,        //!< uint32_t: local destination of each edge
+    edgeData,        //!< data of each edge; empty for void edge data
+    mirrorCounts,    //!< uint64_t: mirrors whose master is on each host
+    mirrors,         //!< uint64_t: global IDs of the mirrors, host by host
+    masterCounts,    //!< uint64_t: masters with a mirror on each host
+    masters,         //!< uint64_t: global IDs of the masters, host by host
+    partitionState,  //!< serialized state of the partitioning policy
+    numSections
+  };
+
+  //! Sizes and flags of the partition
+  struct Scalars {
+    uint64_t numGlobalNodes;
+    uint64_t numGlobalEdges;
+    uint64_t numEdges;
+    uint32_t numNodes;
+    uint32_t numOwned;
+    uint32_t beginMaster;
+    uint32_t numNodesWithEdges;
+    uint32_t hostID;
+    uint32_t numHosts;
+    uint32_t transposed;
+    uint32_t sizeofEdgeData;
+  };
+
+private:
+  //! Sections start at multiples of this
+  static const uint64_t alignment = 4096;
+
+  struct Header {
+    char magic[8];
+    uint64_t version;
+    uint64_t sections;
+    uint64_t offset[numSections];
+    uint64_t size[numSections];
+  };
+  static_assert(sizeof(Header) <= alignment, "header must fit its page");
+
+  static const char* magic() { return "GALOISLG"; }
+
+  const char* base = nullptr;
+  uint64_t length  = 0;
+  const Header* header = nullptr;
+
+public:
+  /**
+   * Maps a local graph file. If it is missing, is not a local graph file or
+   * has another version, the object is left invalid.
+   *
+   * @param filename file to map
+   */
+  explicit LocalGraphFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) == 0 && (uint64_t)buf.st_size >= sizeof(Header)) {
+      void* m = mmap(nullptr, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m != MAP_FAILED) {
+        base   = static_cast<const char*>(m);
+        length = buf.st_size;
+      }
+    }
+    close(fd);
+    if (!base) {
+      return;
+    }
+
+    const Header* h = reinterpret_cast<const Header*>(base);
+    bool ok = std::memcmp(h->magic, magic(), sizeof(h->magic)) == 0 &&
+              h->version == version && h->sections == numSections;
+    for (unsigned s = 0; ok && s < numSections; ++s) {
+      // an empty last section may start past the end of the file
+      ok = h->offset[s] % alignment == 0 &&
+           (h->size[s] == 0 ||
+            (h->offset[s] <= length && h->size[s] <= length - h->offset[s]));
+    }
+    if (ok) {
+      header = h;
+    }
+  }
+
+  ~LocalGraphFile() {
+    if (base) {
+      munmap(const_cast<char*>(base), length);
+    }
+  }
+
+  LocalGraphFile(const LocalGraphFile&) = delete;
+  LocalGraphFile& operator=(const LocalGraphFile&) = delete;
+
+  //! @returns true if the file was mapped and its header is usable
+  bool valid() const { return header != nullptr; }
+
+  //! @returns first element of section s
+  template <typename T>
+  const T* get(Section s) const {
+    return reinterpret_cast<const T*>(base + header->offset[s]);
+  }
+
+  //! @returns number of elements of type T in section s
+  template <typename T>
+  size_t count(Section s) const {
+    return header->size[s] / sizeof(T);
+  }
+
+  //! @returns size of section s in bytes
+  uint64_t bytes(Section s) const { return header->size[s]; }
+
+  /**
+   * Writes a local graph file section by section. The file is written under
+   * a temporary name and renamed by finish(), so an interrupted write never
+   * leaves a file that looks complete. Dies on I/O errors.
+   */
+  class Writer {
+    std::string filename;
+    std::string tmpName;
+    int fd;
+    Header header;
+    uint64_t end = alignment;
+    int current  = -1;
+
+    void writeAll(const char* src, uint64_t offset, uint64_t len) {
+      const uint64_t chunk = 8 * 1024 * 1024;
+      while (len) {
+        ssize_t n = pwrite(fd, src, std::min(len, chunk), offset);
+        if (n < 0 && errno == EINTR)
+          continue;
+        if (n <= 0) {
+          GALOIS_SYS_DIE("failed writing '", tmpName, "'");
+        }
+        src += n;
+        offset += n;
+        len -= n;
+      }
+    }
+
+  public:
+    //! Creates the temporary file for filename
+    explicit Writer(const std::string& _filename)
+        : filename(_filename), tmpName(_filename + ".tmp") {
+      fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        GALOIS_SYS_DIE("failed creating '", tmpName, "'");
+      }
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, magic(), sizeof(header.magic));
+      header.version     = version;
+      header.sections    = numSections;
+    }
+
+    ~Writer() {
+      if (fd >= 0) {
+        close(fd);
+        unlink(tmpName.c_str());
+      }
+    }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    //! Starts section s; sections are written one after the other
+    void begin(Section s) {
+      current          = s;
+      end              = (end + alignment - 1) / alignment * alignment;
+      header.offset[s] = end;
+      header.size[s]   = 0;
+    }
+
+    //! Appends bytes to the current section
+    void append(const void* data, uint64_t len) {
+      assert(current >= 0);
+      writeAll(static_cast<const char*>(data), end, len);
+      end += len;
+      header.size[current] += len;
+    }
+
+    //! Writes section s in one piece
+    void add(Section s, const void* data, uint64_t len) {
+      begin(s);
+      append(data, len);
+    }
+
+    //! Writes the header and moves the file to its final name
+    void finish() {
+      writeAll(reinterpret_cast<const char*>(&header), 0, sizeof(header));
+      if (close(fd) != 0) {
+        GALOIS_SYS_DIE("failed writing '", tmpName, "'");
+      }
+      fd = -1;
+      if (std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+        GALOIS_SYS_DIE("failed renaming '", tmpName, "' to '", filename, "'");
+      }
+    }
+  };
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -55,7 +55,7 @@ class MiningGraph : public DistGraph<NodeTy, EdgeTy> {
     if (gid >= globalOffset && gid < globalOffset + base_DistGraph::numOwned)
       return gid - globalOffset;
 
-    return base_DistGraph::globalToLocalMap.at(gid);
+    return base_DistGraph::globalToLocalMap.getLID(gid);
   }
 
   /**
@@ -186,8 +186,7 @@ class MiningGraph : public DistGraph<NodeTy, EdgeTy> {
 
   virtual bool isLocal(uint64_t gid) const {
     assert(gid < base_DistGraph::numGlobalNodes);
-    return (base_DistGraph::globalToLocalMap.find(gid) !=
-            base_DistGraph::globalToLocalMap.end());
+    return base_DistGraph::globalToLocalMap.isLocal(gid);
   }
 
   /**
@@ -539,12 +538,7 @@ class MiningGraph : public DistGraph<NodeTy, EdgeTy> {
            base_DistGraph::numNodes);
 
     // g2l mapping
-    base_DistGraph::globalToLocalMap.reserve(base_DistGraph::numNodes);
-    for (unsigned i = 0; i < base_DistGraph::numNodes; i++) {
-      // global to local map construction
-      base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] = i;
-    }
-    assert(base_DistGraph::globalToLocalMap.size() == base_DistGraph::numNodes);
+    base_DistGraph::buildGlobalToLocalMap();
 
     return incomingMirrors;
   }
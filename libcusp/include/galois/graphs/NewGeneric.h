@@ -29,6 +29,7 @@
 #include "galois/graphs/DistributedGraph.h"
 #include "galois/DReducible.h"
 #include <sstream>
+#include <typeinfo>
 
 #define CUSP_PT_TIMER 0
 
@@ -46,7 +47,7 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
   //! size used to buffer edge sends during partitioning
   constexpr static unsigned edgePartitionSendBufSize = 8388608;
   constexpr static const char* const GRNAME = "dGraph_Generic";
-  Partitioner* graphPartitioner;
+  Partitioner* graphPartitioner = nullptr;
 
   //! How many rounds to sync state during edge assignment phase
   uint32_t _edgeStateRounds;
@@ -59,7 +60,7 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     if (gid >= globalOffset && gid < globalOffset + base_DistGraph::numOwned)
       return gid - globalOffset;
 
-    return base_DistGraph::globalToLocalMap.at(gid);
+    return base_DistGraph::globalToLocalMap.getLID(gid);
   }
 
   /**
@@ -89,8 +90,7 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
 
   virtual bool isLocal(uint64_t gid) const {
     assert(gid < base_DistGraph::numGlobalNodes);
-    return (base_DistGraph::globalToLocalMap.find(gid) !=
-            base_DistGraph::globalToLocalMap.end());
+    return base_DistGraph::globalToLocalMap.isLocal(gid);
   }
 
   // TODO current uses graph partitioner
@@ -148,6 +148,29 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     }
   }
 
+  /**
+   * Builds the key a local graph file is saved with: a file is only read back
+   * for the same input, host count, policy and partitioning options.
+   */
+  std::string localGraphKey(const std::string& filename, bool cuspAsync,
+                            uint32_t stateRounds, bool transpose,
+                            galois::graphs::MASTERS_DISTRIBUTION md,
+                            uint32_t nodeWeight, uint32_t edgeWeight) const {
+    std::ostringstream key;
+    key << filename;
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) == 0) {
+      key << " size " << buf.st_size << " mtime " << buf.st_mtime;
+    }
+    key << " hosts " << base_DistGraph::numHosts << " policy "
+        << typeid(Partitioner).name() << " edge "
+        << typeid(EdgeTy*).name() << " transpose " << transpose << " md "
+        << (int)md << " weights " << nodeWeight << " " << edgeWeight
+        << " async " << cuspAsync << " rounds " << stateRounds << " "
+        << _edgeStateRounds;
+    return key.str();
+  }
+
   /**
    * Constructor
    */
@@ -158,20 +181,28 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
              uint32_t nodeWeight=0, uint32_t edgeWeight=0,
              bool readFromFile=false,
              std::string localGraphFileName="local_graph",
-             uint32_t edgeStateRounds=1)
+             uint32_t edgeStateRounds=1, bool saveLocalGraph=false)
       : base_DistGraph(host, _numHosts), _edgeStateRounds(edgeStateRounds) {
     galois::runtime::reportParam("dGraph", "GenericPartitioner", "0");
     galois::CondStatTimer<MORE_DIST_STATS> Tgraph_construct(
         "GraphPartitioningTime", GRNAME);
     Tgraph_construct.start();
 
+    std::string key = localGraphKey(filename, cuspAsync, stateRounds,
+                                    transpose, md, nodeWeight, edgeWeight);
     if (readFromFile) {
       galois::gPrint("[", base_DistGraph::id,
                      "] Reading local graph from file ",
                      localGraphFileName, "\n");
-      base_DistGraph::read_local_graph_from_file(localGraphFileName);
-      Tgraph_construct.stop();
-      return;
+      if (base_DistGraph::read_local_graph_from_file(localGraphFileName,
+                                                     key)) {
+        Tgraph_construct.stop();
+        return;
+      }
+      if (base_DistGraph::id == 0) {
+        galois::gWarn("Local graph files do not match this run; "
+                      "partitioning ", filename, " instead");
+      }
     }
 
     galois::graphs::OfflineGraph g(filename);
@@ -349,6 +380,10 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     Tgraph_construct.stop();
     galois::gPrint("[", base_DistGraph::id, "] Graph construction complete.\n");
 
+    if (saveLocalGraph) {
+      base_DistGraph::save_local_graph_to_file(localGraphFileName, key);
+    }
+
     // report state rounds
     if (base_DistGraph::id == 0) {
       galois::runtime::reportStat_Single(GRNAME, "CuSPStateRounds",
@@ -1606,12 +1641,7 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     assert(prefixSumOfEdges.size() == base_DistGraph::numNodes);
 
     // g2l mapping
-    base_DistGraph::globalToLocalMap.reserve(base_DistGraph::numNodes);
-    for (unsigned i = 0; i < base_DistGraph::numNodes; i++) {
-      // global to local map construction
-      base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] = i;
-    }
-    assert(base_DistGraph::globalToLocalMap.size() == base_DistGraph::numNodes);
+    base_DistGraph::buildGlobalToLocalMap();
 
     base_DistGraph::numNodesWithEdges = base_DistGraph::numOwned;
   }
@@ -2491,13 +2521,12 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     if (base_DistGraph::numNodes == 0) {
       return;
     }
-    base_DistGraph::globalToLocalMap.reserve(base_DistGraph::numNodesWithEdges +
-                                             incomingEstimate);
-    base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[0]] = 0;
     // global to local map construction using num nodes with edges
+    base_DistGraph::globalToLocalMap.build(
+        base_DistGraph::localToGlobalVector, base_DistGraph::numNodesWithEdges,
+        0, base_DistGraph::numOwned);
     for (unsigned i = 1; i < base_DistGraph::numNodesWithEdges; i++) {
       prefixSumOfEdges[i] += prefixSumOfEdges[i - 1];
-      base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] = i;
     }
   }
 
@@ -2523,7 +2552,7 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
           // only count if doesn't exist in global/local map + is incoming
           // edge
           if (hasIncomingEdge.test(i) &&
-              !base_DistGraph::globalToLocalMap.count(i)) ++count;
+              !base_DistGraph::globalToLocalMap.isLocal(i)) ++count;
         }
         threadPrefixSums[tid] = count;
       }
@@ -2563,7 +2592,8 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
           uint32_t handledNodes = 0;
 
           for (size_t i = beginNode; i < endNode; i++) {
-            if (hasIncomingEdge.test(i) && !base_DistGraph::globalToLocalMap.count(i)) {
+            if (hasIncomingEdge.test(i) &&
+                !base_DistGraph::globalToLocalMap.isLocal(i)) {
               prefixSumOfEdges[startingNodeIndex + threadStartLocation +
                                handledNodes] = 0;
               base_DistGraph::localToGlobalVector[startingNodeIndex +
@@ -2582,14 +2612,12 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
    * finalize metadata maps
    */
   void finalizeInspection(galois::gstl::Vector<uint64_t>& prefixSumOfEdges) {
-    // reserve rest of memory needed
-    base_DistGraph::globalToLocalMap.reserve(base_DistGraph::numNodes);
     for (unsigned i = base_DistGraph::numNodesWithEdges; i < base_DistGraph::numNodes; i++) {
       // finalize prefix sum
       prefixSumOfEdges[i] += prefixSumOfEdges[i - 1];
-      // global to local map construction
-      base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] = i;
     }
+    // global to local map construction
+    base_DistGraph::buildGlobalToLocalMap();
     if (prefixSumOfEdges.size() != 0) {
       base_DistGraph::numEdges = prefixSumOfEdges.back();
     } else {
@@ -3041,38 +3069,18 @@ class NewDistGraphGeneric : public DistGraph<NodeTy, EdgeTy> {
     }
   }
 
- //public:
-  //virtual void boostSerializeLocalGraph(boost::archive::binary_oarchive& ar,
-  //                                      const unsigned int version = 0) const {
-  //  // unsigned ints
-  //  ar << base_DistGraph::numNodes;
-
-  //  // partition specific
-  //  graphPartitioner->serializePartition(ar);
-
-  //  // maps and vectors
-  //  ar << base_DistGraph::localToGlobalVector;
-  //  ar << base_DistGraph::globalToLocalMap;
-  //}
-
-  //virtual void boostDeSerializeLocalGraph(boost::archive::binary_iarchive& ar,
-  //                                        const unsigned int version = 0) {
-  //  graphPartitioner = new Partitioner(base_DistGraph::id, base_DistGraph::numHosts,
-  //                                     base_DistGraph::numGlobalNodes,
-  //                                     base_DistGraph::numGlobalEdges);
-
-  //  graphPartitioner->saveGIDToHost(base_DistGraph::gid2host);
-
-  //  // unsigned ints
-  //  ar >> base_DistGraph::numNodes;
-
-  //  // partition specific
-  //  graphPartitioner->deserializePartition(ar);
+ protected:
+  void serializePartitionState(galois::runtime::SendBuffer& b) const {
+    graphPartitioner->serializeMasters(b);
+  }
 
-  //  // maps and vectors
-  //  ar >> base_DistGraph::localToGlobalVector;
-  //  ar >> base_DistGraph::globalToLocalMap;
-  //}
+  void deserializePartitionState(galois::runtime::RecvBuffer& b) {
+    graphPartitioner = new Partitioner(
+        base_DistGraph::id, base_DistGraph::numHosts,
+        base_DistGraph::numGlobalNodes, base_DistGraph::numGlobalEdges);
+    graphPartitioner->saveGIDToHost(base_DistGraph::gid2host);
+    graphPartitioner->deserializeMasters(b);
+  }
 };
 
 // make GRNAME visible to public
@@ -29,6 +29,7 @@
 #include "galois/runtime/Network.h"
 #include "galois/runtime/NetworkIO.h"
 #include "galois/runtime/Tracer.h"
+#include "galois/substrate/EnvCheck.h"
 
 #ifdef GALOIS_USE_LWCI
 #define NO_AGG
@@ -385,7 +386,13 @@ class NetworkInterfaceBuffered : public NetworkInterface {
     }
 
     galois::gDebug("[", NetworkInterface::ID, "] MPI initialized");
-    std::tie(netio, ID, Num) = makeNetworkIOMPI(memUsageTracker, inflightSends, inflightRecvs);
+    if (EnvCheck("GALOIS_SHM_NETWORK")) {
+      std::tie(netio, ID, Num) =
+          makeNetworkIOSHM(memUsageTracker, inflightSends, inflightRecvs);
+    } else {
+      std::tie(netio, ID, Num) =
+          makeNetworkIOMPI(memUsageTracker, inflightSends, inflightRecvs);
+    }
 
     assert(ID == (unsigned)rank);
     assert(Num == (unsigned)hostSize);
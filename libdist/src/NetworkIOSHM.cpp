@@ -0,0 +1,396 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file NetworkIOSHM.cpp
+ *
+ * Contains an implementation of network IO that passes messages between
+ * processes on the same machine through rings in POSIX shared memory.
+ */
+
+#include "galois/runtime/NetworkIO.h"
+#include "galois/runtime/Tracer.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared memory rings need address-free 64-bit atomics");
+
+namespace {
+
+/**
+ * Positions of a single-producer single-consumer byte ring. Both count bytes
+ * since the ring was created, so head - tail bytes are readable. They sit on
+ * separate cache lines since different processes write them.
+ */
+struct RingHeader {
+  alignas(64) std::atomic<uint64_t> head; //!< written by the producer
+  alignas(64) std::atomic<uint64_t> tail; //!< written by the consumer
+};
+
+/**
+ * A ring mapped into this process: the header followed by capacity bytes.
+ */
+class Ring {
+  RingHeader* header = nullptr;
+  uint8_t* ring      = nullptr;
+  uint64_t capacity  = 0;
+
+public:
+  Ring() = default;
+  Ring(void* base, uint64_t _capacity)
+      : header(static_cast<RingHeader*>(base)),
+        ring(static_cast<uint8_t*>(base) + sizeof(RingHeader)),
+        capacity(_capacity) {}
+
+  //! Producer: bytes that can be written without overwriting unread ones
+  uint64_t writable() const {
+    return capacity - (header->head.load(std::memory_order_relaxed) -
+                       header->tail.load(std::memory_order_acquire));
+  }
+
+  //! Consumer: bytes written but not read yet
+  uint64_t readable() const {
+    return header->head.load(std::memory_order_acquire) -
+           header->tail.load(std::memory_order_relaxed);
+  }
+
+  //! Producer: position after the last byte written
+  uint64_t written() const {
+    return header->head.load(std::memory_order_relaxed);
+  }
+
+  //! Producer: position after the last byte the consumer has read
+  uint64_t read() const {
+    return header->tail.load(std::memory_order_acquire);
+  }
+
+  //! Producer: appends n <= writable() bytes
+  void write(const void* src, uint64_t n) {
+    uint64_t head  = header->head.load(std::memory_order_relaxed);
+    uint64_t at    = head % capacity;
+    uint64_t first = std::min(n, capacity - at);
+    std::memcpy(ring + at, src, first);
+    std::memcpy(ring, static_cast<const uint8_t*>(src) + first, n - first);
+    header->head.store(head + n, std::memory_order_release);
+  }
+
+  //! Consumer: removes n <= readable() bytes
+  void read(void* dst, uint64_t n) {
+    uint64_t tail  = header->tail.load(std::memory_order_relaxed);
+    uint64_t at    = tail % capacity;
+    uint64_t first = std::min(n, capacity - at);
+    std::memcpy(dst, ring + at, first);
+    std::memcpy(static_cast<uint8_t*>(dst) + first, ring, n - first);
+    header->tail.store(tail + n, std::memory_order_release);
+  }
+};
+
+//! Precedes each message in a ring
+struct FrameHeader {
+  uint32_t tag;
+  uint32_t unused;
+  uint64_t size;
+};
+
+} // namespace
+
+/**
+ * Shared memory implementation of network IO. All hosts must run on the same
+ * machine. MPI is only used to find the host ID, the number of hosts, and to
+ * set up the shared memory, so it must be initialized upon creation of this
+ * object, as for NetworkIOMPI.
+ *
+ * Every host creates one segment holding a ring per sender (including
+ * itself) and maps the ring for it in every other host's segment. Messages
+ * larger than a ring are streamed through it as the receiver drains it.
+ * As with MPI_Issend in NetworkIOMPI, a send only completes once the
+ * receiver has taken the message out of the ring.
+ */
+class NetworkIOSHM : public galois::runtime::NetworkIO {
+  //! Default bytes per ring; GALOIS_SHM_RING_MB overrides it
+  static const uint64_t defaultRingBytes = 8 * 1024 * 1024;
+
+  /**
+   * Sends to one host.
+   */
+  struct sendQueueTy {
+    Ring ring;
+    //! messages not completely written yet; the front one may be partially
+    std::deque<message> pending;
+    bool frameWritten = false;
+    uint64_t dataWritten = 0;
+    //! end of each written message in the ring and its size
+    std::deque<std::pair<uint64_t, size_t>> unread;
+  };
+
+  /**
+   * Receives from one host.
+   */
+  struct recvQueueTy {
+    Ring ring;
+    bool inMessage = false;
+    message current;
+    uint64_t dataRead = 0;
+  };
+
+  uint32_t id;
+  uint32_t numHosts;
+  //! true if there are more hosts than cores, so polling should yield
+  bool oversubscribed;
+  uint64_t ringBytes;
+  size_t mapBytes;
+  std::vector<sendQueueTy> sendQueues;
+  std::vector<recvQueueTy> recvQueues;
+  std::deque<message> done;
+  //! mappings to unmap on destruction
+  std::vector<void*> mappings;
+
+  static std::string segmentName(uint64_t job, uint32_t host) {
+    return "/galois-" + std::to_string(job) + "-" + std::to_string(host);
+  }
+
+  void* mapSegment(const std::string& name, int flags, size_t offset,
+                   size_t length) {
+    int fd = shm_open(name.c_str(), flags, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      GALOIS_SYS_DIE("opening shared memory ", name);
+    }
+    if ((flags & O_CREAT) && ftruncate(fd, offset + length)) {
+      GALOIS_SYS_DIE("sizing shared memory ", name);
+    }
+    void* base =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    close(fd);
+    if (base == MAP_FAILED) {
+      GALOIS_SYS_DIE("mapping shared memory ", name);
+    }
+    mappings.push_back(base);
+    return base;
+  }
+
+  void setupSegments() {
+    MPI_Comm local;
+    int numLocal;
+    handleError(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                                    MPI_INFO_NULL, &local));
+    handleError(MPI_Comm_size(local, &numLocal));
+    handleError(MPI_Comm_free(&local));
+    if ((uint32_t)numLocal != numHosts) {
+      GALOIS_DIE("GALOIS_SHM_NETWORK needs all ", numHosts,
+                 " hosts on one machine; found ", numLocal);
+    }
+
+    // host 0's pid names the segments of this job; its ring size is used
+    uint64_t setup[2] = {(uint64_t)getpid(), defaultRingBytes};
+    int ringMB;
+    if (galois::substrate::EnvCheck("GALOIS_SHM_RING_MB", ringMB) &&
+        ringMB > 0) {
+      setup[1] = (uint64_t)ringMB * 1024 * 1024;
+    }
+    handleError(MPI_Bcast(setup, 2, MPI_UINT64_T, 0, MPI_COMM_WORLD));
+    uint64_t job = setup[0];
+    ringBytes    = setup[1];
+    size_t page  = sysconf(_SC_PAGESIZE);
+    mapBytes = (sizeof(RingHeader) + ringBytes + page - 1) / page * page;
+
+    // create the rings this host receives on
+    std::string own = segmentName(job, id);
+    uint8_t* base   = static_cast<uint8_t*>(mapSegment(
+        own, O_CREAT | O_EXCL | O_RDWR, 0, mapBytes * numHosts));
+    for (uint32_t h = 0; h < numHosts; ++h) {
+      new (base + h * mapBytes) RingHeader{{0}, {0}};
+      recvQueues[h].ring = Ring(base + h * mapBytes, ringBytes);
+    }
+    handleError(MPI_Barrier(MPI_COMM_WORLD));
+
+    // map the ring for this host in every segment
+    for (uint32_t h = 0; h < numHosts; ++h) {
+      void* ring = h == id ? base + h * mapBytes
+                           : mapSegment(segmentName(job, h), O_RDWR,
+                                        id * mapBytes, mapBytes);
+      sendQueues[h].ring = Ring(ring, ringBytes);
+    }
+    handleError(MPI_Barrier(MPI_COMM_WORLD));
+
+    // the mappings keep the memory alive; nothing is left behind on exit
+    shm_unlink(own.c_str());
+  }
+
+  //! @returns true if any send completed or any byte was written
+  bool progressSend(uint32_t host) {
+    sendQueueTy& q = sendQueues[host];
+    bool moved     = false;
+
+    while (!q.unread.empty() && q.ring.read() >= q.unread.front().first) {
+      memUsageTracker.decrementMemUsage(q.unread.front().second);
+      q.unread.pop_front();
+      --inflightSends;
+      moved = true;
+    }
+
+    while (!q.pending.empty()) {
+      message& m = q.pending.front();
+      if (!q.frameWritten) {
+        if (q.ring.writable() < sizeof(FrameHeader))
+          return moved;
+        FrameHeader frame{m.tag, 0, m.data.size()};
+        q.ring.write(&frame, sizeof(frame));
+        q.frameWritten = true;
+        moved          = true;
+      }
+      uint64_t n = std::min(q.ring.writable(), m.data.size() - q.dataWritten);
+      q.ring.write(m.data.data() + q.dataWritten, n);
+      q.dataWritten += n;
+      moved = moved || n;
+      if (q.dataWritten != m.data.size())
+        return moved;
+
+      galois::runtime::trace("SHM SEND", host, m.tag, m.data.size());
+      q.unread.emplace_back(q.ring.written(), m.data.size());
+      q.pending.pop_front();
+      q.frameWritten = false;
+      q.dataWritten  = 0;
+    }
+    return moved;
+  }
+
+  //! @returns true if any byte was read
+  bool progressRecv(uint32_t host) {
+    recvQueueTy& q = recvQueues[host];
+    bool moved     = false;
+
+    while (true) {
+      if (!q.inMessage) {
+        if (q.ring.readable() < sizeof(FrameHeader))
+          return moved;
+        FrameHeader frame;
+        q.ring.read(&frame, sizeof(frame));
+        q.current = message(host, frame.tag, vTy(frame.size));
+        memUsageTracker.incrementMemUsage(frame.size);
+        ++inflightRecvs;
+        q.inMessage = true;
+        q.dataRead  = 0;
+        moved       = true;
+      }
+      vTy& data  = q.current.data;
+      uint64_t n = std::min(q.ring.readable(), data.size() - q.dataRead);
+      if (n) {
+        q.ring.read(data.data() + q.dataRead, n);
+        q.dataRead += n;
+        moved = true;
+      }
+      if (q.dataRead != data.size())
+        return moved;
+
+      galois::runtime::trace("SHM RECV", host, q.current.tag, data.size());
+      done.emplace_back(std::move(q.current));
+      q.inMessage = false;
+    }
+  }
+
+public:
+  /**
+   * Constructor.
+   *
+   * @param tracker memory usage tracker
+   * @param [out] ID this machine's host id
+   * @param [out] NUM total number of hosts in the system
+   */
+  NetworkIOSHM(galois::runtime::MemUsageTracker& tracker,
+               std::atomic<size_t>& sends, std::atomic<size_t>& recvs,
+               uint32_t& ID, uint32_t& NUM)
+      : NetworkIO(tracker, sends, recvs) {
+    int rank, size;
+    handleError(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    handleError(MPI_Comm_size(MPI_COMM_WORLD, &size));
+    ID = id  = rank;
+    NUM = numHosts = size;
+    oversubscribed = numHosts > std::thread::hardware_concurrency();
+    // the queues hold move-only messages, so they cannot be resized
+    sendQueues = std::vector<sendQueueTy>(numHosts);
+    recvQueues = std::vector<recvQueueTy>(numHosts);
+    setupSegments();
+  }
+
+  //! Other hosts keep their own mappings of the rings, so this host can
+  //! unmap while they are still reading or writing them
+  virtual ~NetworkIOSHM() {
+    munmap(mappings[0], mapBytes * numHosts);
+    for (size_t i = 1; i < mappings.size(); ++i)
+      munmap(mappings[i], mapBytes);
+  }
+
+  /**
+   * Adds a message to the send queue of its destination
+   */
+  virtual void enqueue(message m) {
+    memUsageTracker.incrementMemUsage(m.data.size());
+    uint32_t host = m.host;
+    sendQueues[host].pending.emplace_back(std::move(m));
+    progressSend(host);
+  }
+
+  /**
+   * Attempts to get a received message.
+   */
+  virtual message dequeue() {
+    if (!done.empty()) {
+      auto msg = std::move(done.front());
+      done.pop_front();
+      return msg;
+    }
+    return message{~0U, 0, vTy()};
+  }
+
+  /**
+   * Push progress forward in the system.
+   */
+  virtual void progress() {
+    bool moved = false;
+    for (uint32_t h = 0; h < numHosts; ++h) {
+      moved = progressSend(h) || moved;
+      moved = progressRecv(h) || moved;
+    }
+    // like MPI when oversubscribed, let the threads of other hosts run while
+    // waiting for them
+    if (!moved && oversubscribed)
+      std::this_thread::yield();
+  }
+}; // end NetworkIOSHM class
+
+std::tuple<std::unique_ptr<galois::runtime::NetworkIO>, uint32_t, uint32_t>
+galois::runtime::makeNetworkIOSHM(galois::runtime::MemUsageTracker& tracker,
+                                  std::atomic<size_t>& sends,
+                                  std::atomic<size_t>& recvs) {
+  uint32_t ID, NUM;
+  std::unique_ptr<galois::runtime::NetworkIO> n{
+      new NetworkIOSHM(tracker, sends, recvs, ID, NUM)};
+  return std::make_tuple(std::move(n), ID, NUM);
+}
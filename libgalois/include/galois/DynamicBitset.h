@@ -32,12 +32,30 @@
 #include "galois/Traits.h"
 #include "galois/Galois.h"
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/mpl/has_xxx.hpp>
 #include <climits> // CHAR_BIT
 #include <vector>
 #include <assert.h>
 
 namespace galois {
+namespace internal {
+// Word kernels behind the bulk operations of DynamicBitSet; they use AVX2 if
+// the processor supports it. dst may be the same array as a or b.
+
+//! @returns number of set bits in words [0, n)
+uint64_t bitsetCount(const uint64_t* words, size_t n);
+//! dst = a | b on words [0, n)
+void bitsetOr(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+//! dst = a & b on words [0, n)
+void bitsetAnd(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+//! dst = a ^ b on words [0, n)
+void bitsetXor(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+//! dst = a & ~b on words [0, n)
+void bitsetAndNot(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                  size_t n);
+} // namespace internal
+
 /**
  * Concurrent dynamically allocated bitset
  **/
@@ -47,7 +65,116 @@ protected:
   size_t num_bits;
   static constexpr uint32_t bits_uint64 = sizeof(uint64_t) * CHAR_BIT;
 
+  // the atomics have the layout of plain words; bulk operations must not run
+  // concurrently with set/reset
+  uint64_t* words() { return reinterpret_cast<uint64_t*>(bitvec.data()); }
+  const uint64_t* words() const {
+    return reinterpret_cast<const uint64_t*>(bitvec.data());
+  }
+
+  //! words [first, second) of the calling thread in a parallel region
+  std::pair<size_t, size_t> threadWords(unsigned tid, unsigned nthreads) const {
+    return galois::block_range((size_t)0, bitvec.size(), tid, nthreads);
+  }
+
+  //! Applies a word kernel to a and b in parallel and saves the result here
+  template <typename KernelTy>
+  void bulk(KernelTy kernel, const DynamicBitSet& a, const DynamicBitSet& b) {
+    assert(size() == a.size());
+    assert(size() == b.size());
+    galois::on_each([&](unsigned tid, unsigned nthreads) {
+      size_t begin, end;
+      std::tie(begin, end) = threadWords(tid, nthreads);
+      kernel(words() + begin, a.words() + begin, b.words() + begin,
+             end - begin);
+    });
+  }
+
+  //! First set bit in [index, limit), or limit if there is none
+  size_t find_next(size_t index, size_t limit) const {
+    if (index >= limit)
+      return limit;
+    size_t w      = index / bits_uint64;
+    size_t wend   = (limit + bits_uint64 - 1) / bits_uint64;
+    uint64_t word = bitvec[w].load(std::memory_order_relaxed) &
+                    (~(uint64_t)0 << (index % bits_uint64));
+    while (!word) {
+      if (++w >= wend)
+        return limit;
+      word = bitvec[w].load(std::memory_order_relaxed);
+    }
+    return std::min(w * bits_uint64 + __builtin_ctzll(word), limit);
+  }
+
 public:
+  /**
+   * Forward iterator over the indices of the set bits in a range of the
+   * bitset.
+   */
+  class set_iterator
+      : public boost::iterator_facade<set_iterator, size_t,
+                                      boost::forward_traversal_tag, size_t> {
+    friend class boost::iterator_core_access;
+
+    const DynamicBitSet* bitset;
+    size_t index;
+    size_t limit;
+
+    void increment() { index = bitset->find_next(index + 1, limit); }
+    bool equal(const set_iterator& other) const { return index == other.index; }
+    size_t dereference() const { return index; }
+
+  public:
+    set_iterator() : bitset(nullptr), index(0), limit(0) {}
+
+    //! First set bit in [begin, limit)
+    set_iterator(const DynamicBitSet* b, size_t begin, size_t _limit)
+        : bitset(b), index(b->find_next(begin, _limit)), limit(_limit) {}
+  };
+
+  /**
+   * The indices of the set bits as a container for galois::iterate. In a
+   * parallel loop each thread visits the set bits of its own block of words:
+   *
+   * <code>
+   * auto bits = bitset.set_bits();
+   * galois::do_all(galois::iterate(bits), [&](size_t i) { ... });
+   * </code>
+   *
+   * Bits must not be set or reset while iterating.
+   */
+  class set_bit_range {
+    const DynamicBitSet* bitset;
+
+    std::pair<size_t, size_t> localBits() const {
+      auto w = bitset->threadWords(substrate::ThreadPool::getTID(),
+                                   galois::getActiveThreads());
+      return std::make_pair(std::min(w.first * bits_uint64, bitset->size()),
+                            std::min(w.second * bits_uint64, bitset->size()));
+    }
+
+  public:
+    typedef set_iterator iterator;
+    typedef set_iterator local_iterator;
+    typedef size_t value_type;
+
+    explicit set_bit_range(const DynamicBitSet& b) : bitset(&b) {}
+
+    iterator begin() const { return iterator(bitset, 0, bitset->size()); }
+    iterator end() const {
+      return iterator(bitset, bitset->size(), bitset->size());
+    }
+
+    local_iterator local_begin() const {
+      auto r = localBits();
+      return local_iterator(bitset, r.first, r.second);
+    }
+    local_iterator local_end() const {
+      auto r = localBits();
+      return local_iterator(bitset, r.second, r.second);
+    }
+  };
+
   //! Constructor which initializes to an empty bitset.
   DynamicBitSet() : num_bits(0) {}
 
@@ -234,13 +361,21 @@ public:
     return (old_val & bit_offset);
   }
 
+  /**
+   * Finds the first set bit at or after index.
+   *
+   * @param index Bit to start from
+   * @returns index of the first set bit at or after index, or size() if
+   * there is none
+   */
+  size_t find_next(size_t index) const { return find_next(index, num_bits); }
+
+  //! @returns the indices of the set bits; see set_bit_range
+  set_bit_range set_bits() const { return set_bit_range(*this); }
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitSet& other) {
-    assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(galois::iterate(0ul, bitvec.size()),
-                   [&](size_t i) { bitvec[i] |= other_bitvec[i]; },
-                   galois::no_stats());
+    bulk(internal::bitsetOr, *this, other);
   }
 
   // assumes bit_vector is not updated (set) in parallel
@@ -251,11 +386,7 @@ public:
    * @param other Other bitset to do bitwise and with
    */
   void bitwise_and(const DynamicBitSet& other) {
-    assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(galois::iterate(0ul, bitvec.size()),
-                   [&](size_t i) { bitvec[i] &= other_bitvec[i]; },
-                   galois::no_stats());
+    bulk(internal::bitsetAnd, *this, other);
   }
 
   /**
@@ -266,16 +397,28 @@ public:
    * @param other2 Bitset to and with other 1
    */
   void bitwise_and(const DynamicBitSet& other1, const DynamicBitSet& other2) {
-    assert(size() == other1.size());
-    assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(galois::iterate(0ul, bitvec.size()),
-                   [&](size_t i) {
-                     bitvec[i] = other_bitvec1[i] & other_bitvec2[i];
-                   },
-                   galois::no_stats());
+    bulk(internal::bitsetAnd, other1, other2);
+  }
+
+  /**
+   * Does an IN-PLACE bitwise and-not of this bitset and another bitset, i.e.,
+   * clears the bits that are set in the other bitset
+   *
+   * @param other Other bitset whose set bits are cleared in this one
+   */
+  void bitwise_andnot(const DynamicBitSet& other) {
+    bulk(internal::bitsetAndNot, *this, other);
+  }
+
+  /**
+   * Saves the bits set in other1 but not in other2 to this bitset
+   *
+   * @param other1 Bitset whose bits are kept
+   * @param other2 Bitset whose set bits are cleared
+   */
+  void bitwise_andnot(const DynamicBitSet& other1,
+                      const DynamicBitSet& other2) {
+    bulk(internal::bitsetAndNot, other1, other2);
   }
 
   /**
@@ -284,11 +427,7 @@ public:
    * @param other Other bitset to do bitwise xor with
    */
   void bitwise_xor(const DynamicBitSet& other) {
-    assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(galois::iterate(0ul, bitvec.size()),
-                   [&](size_t i) { bitvec[i] ^= other_bitvec[i]; },
-                   galois::no_stats());
+    bulk(internal::bitsetXor, *this, other);
   }
 
   /**
@@ -299,19 +438,9 @@ public:
    * @param other2 Bitset to xor with other 1
    */
   void bitwise_xor(const DynamicBitSet& other1, const DynamicBitSet& other2) {
-    assert(size() == other1.size());
-    assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(galois::iterate(0ul, bitvec.size()),
-                   [&](size_t i) {
-                     bitvec[i] = other_bitvec1[i] ^ other_bitvec2[i];
-                   },
-                   galois::no_stats());
+    bulk(internal::bitsetXor, other1, other2);
   }
 
-
   /**
    * Count how many bits are set in the bitset
    *
@@ -319,49 +448,34 @@ public:
    */
   uint64_t count() const {
     galois::GAccumulator<uint64_t> ret;
-    galois::do_all(galois::iterate(bitvec.begin(), bitvec.end()),
-                   [&](uint64_t n) {
-  #ifdef __GNUC__
-                     ret += __builtin_popcountll(n);
-  #else
-                     n = n - ((n >> 1) & 0x5555555555555555UL);
-                     n = (n & 0x3333333333333333UL) +
-                         ((n >> 2) & 0x3333333333333333UL);
-                     ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) *
-                             0x101010101010101UL) >>
-                            56;
-  #endif
-                   },
-                   galois::no_stats());
+    galois::on_each([&](unsigned tid, unsigned nthreads) {
+      size_t begin, end;
+      std::tie(begin, end) = threadWords(tid, nthreads);
+      ret += internal::bitsetCount(words() + begin, end - begin);
+    });
     return ret.reduce();
   }
 
   /**
-   * Returns a vector containing the set bits in this bitset in order
-   * from left to right.
+   * Saves the indices of the set bits in this bitset to offsets, in
+   * increasing order.
    * Do NOT call in a parallel region as it uses galois::on_each.
    *
-   * @returns vector with offsets into set bits
+   * @param offsets Output; resized to the number of set bits. Any vector of
+   * integers with resize and operator[], e.g., galois::PODResizeableArray
+   * @returns number of set bits
    */
-  // TODO uint32_t is somewhat dangerous; change in the future
-  std::vector<uint32_t> getOffsets() const {
+  template <typename VecTy>
+  size_t getOffsets(VecTy& offsets) const {
     uint32_t activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> tPrefixBitCounts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each(
-      [&] (unsigned tid, unsigned nthreads) {
-        size_t start;
-        size_t end;
-        std::tie(start, end) = galois::block_range((size_t)0, this->size(), tid,
-                                                   nthreads);
-
-        unsigned int count = 0;
-        for (unsigned int i = start; i < end; ++i) {
-          if (this->test(i)) ++count;
-        }
-
-        tPrefixBitCounts[tid] = count;
+    std::vector<size_t> tPrefixBitCounts(activeThreads);
+
+    // count how many bits are set in the words of each thread
+    galois::on_each([&](unsigned tid, unsigned nthreads) {
+      size_t begin, end;
+      std::tie(begin, end)  = threadWords(tid, nthreads);
+      tPrefixBitCounts[tid] = internal::bitsetCount(words() + begin,
+                                                    end - begin);
     });
 
     // calculate prefix sum of bits per thread
@@ -370,37 +484,41 @@ public:
     }
 
     // total num of set bits
-    uint64_t bitsetCount = tPrefixBitCounts[activeThreads - 1];
-    std::vector<uint32_t> offsets;
+    size_t bitsetCount = tPrefixBitCounts[activeThreads - 1];
+    offsets.resize(bitsetCount);
 
     // calculate the indices of the set bits and save them to the offset
     // vector
     if (bitsetCount > 0) {
-      offsets.resize(bitsetCount);
-      galois::on_each(
-        [&] (unsigned tid, unsigned nthreads) {
-          size_t start;
-          size_t end;
-          std::tie(start, end) = galois::block_range((size_t)0, this->size(), tid,
-                                                     nthreads);
-          unsigned int count = 0;
-          unsigned int tPrefixBitCount;
-          if (tid == 0) {
-            tPrefixBitCount = 0;
-          } else {
-            tPrefixBitCount = tPrefixBitCounts[tid - 1];
-          }
-
-          for (unsigned int i = start; i < end; ++i) {
-            if (this->test(i)) {
-              offsets[tPrefixBitCount + count] = i;
-              ++count;
-            }
+      galois::on_each([&](unsigned tid, unsigned nthreads) {
+        size_t begin, end;
+        std::tie(begin, end) = threadWords(tid, nthreads);
+        size_t pos           = (tid == 0) ? 0 : tPrefixBitCounts[tid - 1];
+
+        for (size_t w = begin; w < end; ++w) {
+          uint64_t word = words()[w];
+          while (word) {
+            offsets[pos++] = w * bits_uint64 + __builtin_ctzll(word);
+            word &= word - 1;
           }
         }
-      );
+      });
     }
 
+    return bitsetCount;
+  }
+
+  /**
+   * Returns a vector containing the set bits in this bitset in order
+   * from left to right.
+   * Do NOT call in a parallel region as it uses galois::on_each.
+   *
+   * @returns vector with offsets into set bits
+   */
+  // TODO uint32_t is somewhat dangerous; change in the future
+  std::vector<uint32_t> getOffsets() const {
+    std::vector<uint32_t> offsets;
+    getOffsets(offsets);
     return offsets;
   }
 
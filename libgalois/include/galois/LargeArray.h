@@ -56,6 +56,7 @@ class LargeArray {
   substrate::LAptr m_realdata;
   T* m_data;
   size_t m_size;
+  substrate::HugePagePolicy m_policy = substrate::HugePagePolicy::Default;
 
 public:
   typedef T raw_value_type;
@@ -84,20 +85,21 @@ protected:
     case Blocked:
       galois::gDebug("Block-alloc'd");
       m_realdata =
-          substrate::largeMallocBlocked(n * sizeof(T), runtime::activeThreads);
+          substrate::largeMallocBlocked(n * sizeof(T), runtime::activeThreads,
+                                        m_policy);
       break;
     case Interleaved:
       galois::gDebug("Interleave-alloc'd");
-      m_realdata = substrate::largeMallocInterleaved(n * sizeof(T),
-                                                     runtime::activeThreads);
+      m_realdata = substrate::largeMallocInterleaved(
+          n * sizeof(T), runtime::activeThreads, m_policy);
       break;
     case Local:
       galois::gDebug("Local-allocd");
-      m_realdata = substrate::largeMallocLocal(n * sizeof(T));
+      m_realdata = substrate::largeMallocLocal(n * sizeof(T), m_policy);
       break;
     case Floating:
       galois::gDebug("Floating-alloc'd");
-      m_realdata = substrate::largeMallocFloating(n * sizeof(T));
+      m_realdata = substrate::largeMallocFloating(n * sizeof(T), m_policy);
       break;
     };
     m_data = reinterpret_cast<T*>(m_realdata.get());
@@ -169,12 +171,14 @@ public:
     std::swap(this->m_realdata, o.m_realdata);
     std::swap(this->m_data, o.m_data);
     std::swap(this->m_size, o.m_size);
+    std::swap(this->m_policy, o.m_policy);
   }
 
   LargeArray& operator=(LargeArray&& o) {
     std::swap(this->m_realdata, o.m_realdata);
     std::swap(this->m_data, o.m_data);
     std::swap(this->m_size, o.m_size);
+    std::swap(this->m_policy, o.m_policy);
     return *this;
   }
 
@@ -190,6 +194,7 @@ public:
     std::swap(lhs.m_realdata, rhs.m_realdata);
     std::swap(lhs.m_data, rhs.m_data);
     std::swap(lhs.m_size, rhs.m_size);
+    std::swap(lhs.m_policy, rhs.m_policy);
   }
 
   const_reference at(difference_type x) const { return m_data[x]; }
@@ -203,6 +208,18 @@ public:
   iterator end() { return m_data + m_size; }
   const_iterator end() const { return m_data + m_size; }
 
+  /**
+   * Sets the page size the next allocation prefers. The default follows
+   * GALOIS_HUGE_PAGES (2 MB pages if unset); smaller pages are used when the
+   * preferred ones are unavailable.
+   */
+  void setHugePagePolicy(substrate::HugePagePolicy p) { m_policy = p; }
+
+  //! @returns pages backing the current allocation
+  substrate::PageBacking pageBacking() const {
+    return m_realdata.get_deleter().backing;
+  }
+
   //! [allocatefunctions]
   //! Allocates interleaved across NUMA (memory) nodes.
   void allocateInterleaved(size_type n) { allocate(n, Interleaved); }
@@ -243,9 +260,9 @@ public:
                          RangeArrayTy& threadRanges) {
     assert(!m_data);
 
-    m_realdata = substrate::largeMallocSpecified(numberOfElements * sizeof(T),
-                                                 runtime::activeThreads,
-                                                 threadRanges, sizeof(T));
+    m_realdata = substrate::largeMallocSpecified(
+        numberOfElements * sizeof(T), runtime::activeThreads, threadRanges,
+        sizeof(T), m_policy);
 
     m_size = numberOfElements;
     m_data = reinterpret_cast<T*>(m_realdata.get());
@@ -343,6 +360,11 @@ public:
   iterator end() { return 0; }
   const_iterator end() const { return 0; }
 
+  void setHugePagePolicy(substrate::HugePagePolicy) {}
+  substrate::PageBacking pageBacking() const {
+    return substrate::PageBacking::Base;
+  }
+
   void allocateInterleaved(size_type n) {}
   void allocateBlocked(size_type n) {}
   void allocateLocal(size_type n, bool prefault = true) {}
@@ -73,6 +73,36 @@ void do_all(const RangeFunc& rangeMaker, FunctionTy&& fn,
   runtime::do_all_gen(rangeMaker(tpl), std::forward<FunctionTy>(fn), tpl);
 }
 
+/**
+ * Groups the operators of a {@link do_all_phases()} loop.
+ *
+ * @param fns operators, applied in this order
+ */
+template <typename... FunctionTys>
+std::tuple<FunctionTys...> phases(FunctionTys... fns) {
+  return std::tuple<FunctionTys...>(fns...);
+}
+
+/**
+ * Fused do-all loops. Equivalent to one do_all per operator of fns, in order,
+ * but runs all of them in a single parallel region. Every thread applies each
+ * phase to the same static block of the range, so items stay in the cache of
+ * the thread that touched them in the previous phase. Threads wait at a
+ * barrier between phases unless {@link no_phase_barrier} is given.
+ *
+ * @param rangeMaker an iterate range maker typically returned by
+ * <code>galois::iterate(...)</code>
+ * @param fns operators, typically returned by <code>galois::phases(...)</code>
+ * @param args optional arguments to loop, e.g., {@see loopname}, {@see
+ * no_phase_barrier}; work stealing is not supported
+ */
+template <typename RangeFunc, typename... FunctionTys, typename... Args>
+void do_all_phases(const RangeFunc& rangeMaker,
+                   std::tuple<FunctionTys...> fns, const Args&... args) {
+  auto tpl = std::make_tuple(args...);
+  runtime::do_all_phases_gen(rangeMaker(tpl), fns, tpl);
+}
+
 /**
  * Low-level parallel loop. Operator is applied for each running thread.
  * Operator should confirm to <code>fn(tid, numThreads)</code> where tid is
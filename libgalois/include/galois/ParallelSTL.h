@@ -23,11 +23,15 @@
 #include "galois/Reduction.h"
 #include "galois/GaloisForwardDecl.h"
 #include "galois/NoDerefIterator.h"
+#include "galois/Threads.h"
 #include "galois/Traits.h"
 #include "galois/UserContext.h"
 #include "galois/worklists/Chunk.h"
 #include "galois/runtime/Range.h"
 
+#include <numeric>
+#include <vector>
+
 namespace galois {
 //! Parallel versions of STL library algorithms.
 // TODO: rename to gstl?
@@ -288,6 +292,46 @@ T map_reduce(InputIterator first, InputIterator last, MapFn mapFn,
   return reducer.reduce();
 }
 
+/**
+ * Inclusive prefix sum of [first, last) into d_first, which may equal first.
+ * Each thread scans one block, then adds the sum of the blocks before it.
+ */
+template <class InputIterator, class OutputIterator>
+OutputIterator partial_sum(InputIterator first, InputIterator last,
+                           OutputIterator d_first) {
+  typedef typename std::iterator_traits<InputIterator>::value_type T;
+  size_t n = std::distance(first, last);
+  if (n <= 4096)
+    return std::partial_sum(first, last, d_first);
+
+  std::vector<T> blockSums(getActiveThreads(), T());
+  on_each([&](unsigned tid, unsigned total) {
+    auto r = block_range((size_t)0, n, tid, total);
+    if (r.first == r.second)
+      return;
+    std::partial_sum(first + r.first, first + r.second, d_first + r.first);
+    blockSums[tid] = d_first[r.second - 1];
+  });
+
+  // exclusive scan of the block sums
+  T carry = T();
+  for (auto& s : blockSums) {
+    T next = carry + s;
+    s      = carry;
+    carry  = next;
+  }
+
+  on_each([&](unsigned tid, unsigned total) {
+    if (tid == 0)
+      return;
+    auto r   = block_range((size_t)0, n, tid, total);
+    T offset = blockSums[tid];
+    for (size_t i = r.first; i < r.second; ++i)
+      d_first[i] += offset;
+  });
+  return d_first + n;
+}
+
 template <typename I>
 std::enable_if_t<!std::is_scalar<internal::Val_ty<I>>::value> destroy(I first,
                                                                       I last) {
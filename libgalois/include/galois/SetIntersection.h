@@ -0,0 +1,81 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file SetIntersection.h
+ *
+ * Intersection of sorted arrays of 32-bit integers, such as the sorted
+ * neighbor lists of LC_CSR_Graph (see LC_CSR_Graph::edge_dst_begin).
+ *
+ * Arrays of similar length are intersected by comparing blocks of 8 (AVX2)
+ * or 16 (AVX-512) elements of each array at a time; if one array is much
+ * longer than the other, each element of the shorter one is searched in the
+ * longer one by galloping instead. The widest kernel the processor supports
+ * is chosen at startup.
+ */
+
+#ifndef GALOIS_SETINTERSECTION_H
+#define GALOIS_SETINTERSECTION_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace galois {
+
+//! Implementations of the block intersection
+enum class IntersectKernel { Scalar, AVX2, AVX512 };
+
+//! @returns the kernel currently used
+IntersectKernel intersectKernel();
+
+//! @returns true if the processor can run kernel k
+bool intersectKernelSupported(IntersectKernel k);
+
+/**
+ * Selects the kernel to use. Not thread safe; meant for testing and
+ * benchmarking.
+ *
+ * @returns false and keeps the current kernel if k is not supported
+ */
+bool setIntersectKernel(IntersectKernel k);
+
+const char* intersectKernelName(IntersectKernel k);
+
+/**
+ * Counts the elements common to two arrays. Both arrays must be sorted in
+ * increasing order without duplicates.
+ */
+size_t intersectCount(const uint32_t* a, size_t na, const uint32_t* b,
+                      size_t nb);
+
+/**
+ * Finds the elements common to two arrays, which must be sorted in
+ * increasing order without duplicates. The k-th common element is
+ * a[posA[k]] == b[posB[k]], in increasing order.
+ *
+ * @param posA output with room for min(na, nb) positions
+ * @param posB output with room for min(na, nb) positions
+ * @returns number of common elements
+ */
+size_t intersectPositions(const uint32_t* a, size_t na, const uint32_t* b,
+                          size_t nb, uint32_t* posA, uint32_t* posB);
+
+} // namespace galois
+
+#endif
@@ -175,6 +175,14 @@ struct loopname : public trait_has_value<const char*>, loopname_tag {
 struct steal_tag {};
 struct steal : public trait_has_type<bool>, steal_tag {};
 
+/**
+ * Indicates that each phase of a {@link do_all_phases()} loop only reads what
+ * earlier phases wrote for the same item, so threads need not wait for each
+ * other between phases. Optional argument to {@link do_all_phases()} loops.
+ */
+struct no_phase_barrier_tag {};
+struct no_phase_barrier : public trait_has_type<bool>, no_phase_barrier_tag {};
+
 /**
  * Indicates worklist to use. Optional argument to {@link for_each()} loops.
  */
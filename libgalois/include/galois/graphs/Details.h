@@ -38,6 +38,9 @@ struct read_default_graph_tag {};
 struct read_with_aux_graph_tag {};
 struct read_lc_inout_graph_tag {};
 struct read_with_aux_first_graph_tag {};
+//! Graphs that can read a .gr file directly into their own arrays; falls
+//! back to read_default_graph_tag when given a FileGraph
+struct read_stream_graph_tag : public read_default_graph_tag {};
 
 namespace internal {
 
@@ -0,0 +1,110 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file DirectFileReader.h
+ *
+ * Contains DirectFileReader, which copies byte ranges of a file into
+ * caller-owned memory without mapping the file.
+ */
+
+#ifndef GALOIS_GRAPHS_DIRECTFILEREADER_H
+#define GALOIS_GRAPHS_DIRECTFILEREADER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Reads ranges of a file directly into their final destination.
+ *
+ * Reads are issued in large chunks with O_DIRECT when the file system allows
+ * it, so loading a graph does not also fill the page cache with a second copy
+ * of the file. When Galois is built with liburing, several chunks of a range
+ * are kept in flight at once through io_uring; otherwise chunks are read
+ * synchronously with pread. If direct I/O is not supported, buffered pread is
+ * used and the pages are dropped from the cache afterwards.
+ *
+ * read may be called concurrently from multiple threads; each thread should
+ * read its own range so that pages are first touched by the thread (and
+ * hence NUMA node) that owns them. Each thread keeps one aligned bounce
+ * buffer for the lifetime of the reader, so small reads stay cheap.
+ */
+class DirectFileReader : private boost::noncopyable {
+  //! buffered descriptor; always valid
+  int fd;
+  //! O_DIRECT descriptor; -1 if direct I/O is unavailable
+  int directFd;
+  //! cleared if the file system rejects direct reads
+  std::atomic<bool> useDirect;
+  uint64_t fileSize;
+
+  //! aligned buffer direct reads land in before being copied out
+  struct BounceBuffer {
+    char* data  = nullptr;
+    size_t size = 0;
+    ~BounceBuffer();
+  };
+  substrate::PerThreadStorage<BounceBuffer> buffers;
+
+  char* bounceBuffer(size_t bytes);
+  bool readDirect(char* dst, uint64_t offset, uint64_t len);
+  void readBuffered(char* dst, uint64_t offset, uint64_t len);
+
+public:
+  //! Size of each read request issued to the kernel
+  static const size_t chunkSize = 8 * 1024 * 1024;
+  //! Number of chunks kept in flight per read call with io_uring; the
+  //! bounce buffer of a thread never exceeds chunkSize * queueDepth bytes
+  static const unsigned queueDepth = 4;
+
+  /**
+   * Opens a file for reading.
+   *
+   * @param filename file to open
+   */
+  explicit DirectFileReader(const std::string& filename);
+
+  ~DirectFileReader();
+
+  //! @returns size of the file in bytes
+  uint64_t size() const { return fileSize; }
+
+  /**
+   * Copies bytes [offset, offset + len) of the file into dst. Dies if the
+   * range cannot be read in its entirety.
+   *
+   * @param dst destination; no alignment requirement
+   * @param offset file offset of first byte to read
+   * @param len number of bytes to read
+   */
+  void read(void* dst, uint64_t offset, uint64_t len);
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
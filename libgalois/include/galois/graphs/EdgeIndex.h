@@ -0,0 +1,317 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file EdgeIndex.h
+ *
+ * Contains EdgeIndex, an index answering edge-existence queries on an
+ * LC_CSR_Graph whose edges are sorted by destination.
+ */
+
+#ifndef GALOIS_GRAPHS_EDGEINDEX_H
+#define GALOIS_GRAPHS_EDGEINDEX_H
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Finds edges by source and destination.
+ *
+ * Nodes with more than degreeThreshold edges (hubs) get an open-addressing
+ * hash table from destination to edge; edges of other nodes are found by
+ * binary search, so the graph must be sorted by destination (e.g., with
+ * sortAllEdgesByDst) before the index is built. The index refers to edge
+ * positions and must be rebuilt if the topology of the graph changes.
+ *
+ * Besides single lookups, findEdges and hasEdges answer a batch of queries
+ * in parallel: queries are sorted by source so that each neighbor list is
+ * visited once, and the memory each query touches is prefetched a few
+ * queries ahead.
+ *
+ * @tparam GraphTy LC_CSR_Graph or a graph with the same edge_dst_begin
+ */
+template <typename GraphTy>
+class EdgeIndex : private boost::noncopyable {
+public:
+  typedef typename GraphTy::GraphNode GraphNode;
+  typedef typename GraphTy::edge_iterator edge_iterator;
+  //! (source, destination)
+  typedef std::pair<GraphNode, GraphNode> Query;
+
+private:
+  //! destination and position among the edges of the hub
+  struct Slot {
+    uint32_t dst;
+    uint32_t offset;
+  };
+
+  struct Hub {
+    GraphNode node;
+    uint32_t shift; //!< 32 - log2 of the table size
+    uint64_t begin; //!< first slot of the table
+  };
+
+  //! Query with its position in the batch
+  struct SortedQuery {
+    GraphNode src;
+    GraphNode dst;
+    size_t index;
+
+    bool operator<(const SortedQuery& o) const {
+      return src < o.src || (src == o.src && dst < o.dst);
+    }
+  };
+
+  static const uint32_t emptySlot       = ~uint32_t(0);
+  static const size_t prefetchDistance  = 8;
+  static const size_t queriesPerBlock   = 1024;
+
+  GraphTy& graph;
+  size_t degreeThreshold;
+  //! sorted by node
+  std::vector<Hub> hubs;
+  LargeArray<Slot> slots;
+
+  static uint32_t hash(GraphNode dst, uint32_t shift) {
+    // Fibonacci hashing; the high bits are the best mixed
+    return uint32_t(dst * 0x9E3779B1u) >> shift;
+  }
+
+  const Hub* findHub(GraphNode n) const {
+    auto h = std::lower_bound(
+        hubs.begin(), hubs.end(), n,
+        [](const Hub& hub, GraphNode node) { return hub.node < node; });
+    assert(h != hubs.end() && h->node == n);
+    return &*h;
+  }
+
+  size_t degree(GraphNode n) {
+    return std::distance(graph.edge_begin(n, MethodFlag::UNPROTECTED),
+                         graph.edge_end(n, MethodFlag::UNPROTECTED));
+  }
+
+  //! position of dst among the edges of a hub; degree if absent
+  size_t probe(const Hub& hub, size_t deg, GraphNode dst) const {
+    uint64_t mask = (uint64_t(1) << (32 - hub.shift)) - 1;
+    const Slot* table = slots.data() + hub.begin;
+    for (uint64_t i = hash(dst, hub.shift);; i = (i + 1) & mask) {
+      if (table[i].dst == dst)
+        return table[i].offset;
+      if (table[i].dst == emptySlot)
+        return deg;
+    }
+  }
+
+  void build() {
+    InsertBag<GraphNode> hubNodes;
+    galois::do_all(galois::iterate(graph),
+                   [&](GraphNode n) {
+                     if (degree(n) > degreeThreshold)
+                       hubNodes.push(n);
+                   },
+                   galois::no_stats(), galois::steal());
+
+    for (GraphNode n : hubNodes)
+      hubs.push_back(Hub{n, 0, 0});
+    std::sort(hubs.begin(), hubs.end(),
+              [](const Hub& a, const Hub& b) { return a.node < b.node; });
+
+    // tables are at most half full
+    uint64_t numSlots = 0;
+    for (Hub& hub : hubs) {
+      size_t deg = degree(hub.node);
+      assert(deg < emptySlot);
+      uint32_t logSize = 1;
+      while ((uint64_t(1) << logSize) < 2 * deg)
+        ++logSize;
+      hub.shift = 32 - logSize;
+      hub.begin = numSlots;
+      numSlots += uint64_t(1) << logSize;
+    }
+
+    slots.allocateInterleaved(numSlots);
+    galois::do_all(
+        galois::iterate(hubs),
+        [&](const Hub& hub) {
+          uint64_t mask = (uint64_t(1) << (32 - hub.shift)) - 1;
+          Slot* table   = slots.data() + hub.begin;
+          std::fill(table, table + mask + 1, Slot{emptySlot, 0});
+
+          const GraphNode* dsts = graph.edge_dst_begin(hub.node);
+          size_t deg            = degree(hub.node);
+          for (size_t e = 0; e < deg; ++e) {
+            uint64_t i = hash(dsts[e], hub.shift);
+            // keep the first of parallel edges, like findEdge
+            while (table[i].dst != emptySlot && table[i].dst != dsts[e])
+              i = (i + 1) & mask;
+            if (table[i].dst == emptySlot)
+              table[i] = Slot{dsts[e], uint32_t(e)};
+          }
+        },
+        galois::no_stats(), galois::steal());
+  }
+
+  void prefetch(const SortedQuery& q) {
+    size_t deg = degree(q.src);
+    if (deg > degreeThreshold) {
+      const Hub* hub = findHub(q.src);
+      __builtin_prefetch(slots.data() + hub->begin + hash(q.dst, hub->shift));
+    } else if (deg) {
+      // the first probe of the binary search
+      __builtin_prefetch(graph.edge_dst_begin(q.src) + deg / 2);
+    }
+  }
+
+  /**
+   * Calls fn(index, edge) for each query in a batch, where edge is the end of
+   * the edges of the source if there is no edge.
+   */
+  template <typename F>
+  void forEachQuery(const std::vector<Query>& queries, F fn) {
+    std::vector<SortedQuery> sorted(queries.size());
+    galois::do_all(galois::iterate(size_t(0), queries.size()),
+                   [&](size_t i) {
+                     sorted[i] = SortedQuery{queries[i].first,
+                                             queries[i].second, i};
+                   },
+                   galois::no_stats());
+    galois::ParallelSTL::sort(sorted.begin(), sorted.end());
+
+    size_t numBlocks = (sorted.size() + queriesPerBlock - 1) / queriesPerBlock;
+    galois::do_all(
+        galois::iterate(size_t(0), numBlocks),
+        [&](size_t block) {
+          size_t begin = block * queriesPerBlock;
+          size_t end   = std::min(sorted.size(), begin + queriesPerBlock);
+
+          for (size_t k = begin; k < std::min(end, begin + prefetchDistance);
+               ++k)
+            prefetch(sorted[k]);
+
+          // lookups of the same source continue where the last one stopped
+          GraphNode src        = 0;
+          const GraphNode* dst = nullptr;
+          size_t deg = 0, pos = 0;
+          const Hub* hub = nullptr;
+
+          for (size_t k = begin; k < end; ++k) {
+            if (k + prefetchDistance < end)
+              prefetch(sorted[k + prefetchDistance]);
+
+            const SortedQuery& q = sorted[k];
+            if (k == begin || q.src != src) {
+              src = q.src;
+              dst = graph.edge_dst_begin(src);
+              deg = degree(src);
+              pos = 0;
+              hub = deg > degreeThreshold ? findHub(src) : nullptr;
+            }
+
+            size_t found;
+            if (hub) {
+              found = probe(*hub, deg, q.dst);
+            } else {
+              pos   = std::lower_bound(dst + pos, dst + deg, q.dst) - dst;
+              found = (pos < deg && dst[pos] == q.dst) ? pos : deg;
+            }
+            fn(q.index,
+               graph.edge_begin(src, MethodFlag::UNPROTECTED) + found);
+          }
+        },
+        galois::steal(), galois::no_stats());
+  }
+
+public:
+  /**
+   * Builds the index in parallel.
+   *
+   * @param g graph with edges sorted by destination
+   * @param threshold nodes with more edges than this get a hash table
+   */
+  explicit EdgeIndex(GraphTy& g, size_t threshold = 1024)
+      : graph(g), degreeThreshold(threshold) {
+    build();
+  }
+
+  //! Returns an edge from src to dst or edge_end(src) if there is none
+  edge_iterator findEdge(GraphNode src, GraphNode dst) {
+    auto ii    = graph.edge_begin(src, MethodFlag::UNPROTECTED);
+    size_t deg = degree(src);
+    if (deg > degreeThreshold)
+      return ii + probe(*findHub(src), deg, dst);
+
+    const GraphNode* dsts = graph.edge_dst_begin(src);
+    const GraphNode* p    = std::lower_bound(dsts, dsts + deg, dst);
+    return (p != dsts + deg && *p == dst) ? ii + (p - dsts) : ii + deg;
+  }
+
+  bool hasEdge(GraphNode src, GraphNode dst) {
+    return findEdge(src, dst) !=
+           graph.edge_end(src, MethodFlag::UNPROTECTED);
+  }
+
+  /**
+   * Finds the edges of a batch of queries in parallel.
+   *
+   * @param result result[i] is the edge of queries[i] or the end of the
+   * edges of its source
+   */
+  void findEdges(const std::vector<Query>& queries,
+                 std::vector<edge_iterator>& result) {
+    result.resize(queries.size());
+    forEachQuery(queries,
+                 [&](size_t i, edge_iterator e) { result[i] = e; });
+  }
+
+  /**
+   * Checks a batch of queries in parallel.
+   *
+   * @param result result[i] is 1 if the edge of queries[i] exists and 0
+   * otherwise
+   */
+  void hasEdges(const std::vector<Query>& queries,
+                std::vector<uint8_t>& result) {
+    result.resize(queries.size());
+    forEachQuery(queries, [&](size_t i, edge_iterator e) {
+      result[i] = e != graph.edge_end(queries[i].first,
+                                      MethodFlag::UNPROTECTED);
+    });
+  }
+
+  //! Number of nodes with a hash table
+  size_t numHubs() const { return hubs.size(); }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,324 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file EdgeList.h
+ *
+ * Contains EdgeList, which parses text edge lists in parallel into arrays,
+ * and writeGRFile, which writes CSR arrays as a .gr file in parallel.
+ */
+
+#ifndef GALOIS_GRAPHS_EDGELIST_H
+#define GALOIS_GRAPHS_EDGELIST_H
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+/**
+ * A text file mapped read-only and cut into chunks that end at line breaks,
+ * so that each chunk can be parsed independently.
+ */
+class TextFileChunks : private boost::noncopyable {
+  const char* base;
+  uint64_t length;
+  //! chunk c is [bounds[c], bounds[c + 1])
+  std::vector<uint64_t> bounds;
+
+public:
+  //! Chunks are made no smaller than this unless the file is
+  static const uint64_t minChunkSize = 1024 * 1024;
+
+  /**
+   * Maps a file and cuts it into chunks.
+   *
+   * @param filename file to map
+   * @param maxChunks upper bound on the number of chunks
+   */
+  TextFileChunks(const std::string& filename, size_t maxChunks);
+
+  ~TextFileChunks();
+
+  //! @returns number of chunks
+  size_t size() const { return bounds.size() - 1; }
+  //! @returns first byte of chunk c
+  const char* begin(size_t c) const { return base + bounds[c]; }
+  //! @returns one past the last byte of chunk c
+  const char* end(size_t c) const { return base + bounds[c + 1]; }
+  //! @returns file offset of p
+  uint64_t offset(const char* p) const { return p - base; }
+};
+
+inline const char* skipBlanks(const char* p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+  return p;
+}
+
+inline const char* nextLine(const char* p, const char* end) {
+  const char* nl =
+      static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl ? nl + 1 : end;
+}
+
+//! Lines that are empty or start with # or % (after blanks) are skipped
+inline bool isDataLine(const char* p, const char* end) {
+  p = skipBlanks(p, end);
+  return p != end && *p != '\n' && *p != '#' && *p != '%';
+}
+
+//! @returns number of data lines in [begin, end)
+inline uint64_t countDataLines(const char* begin, const char* end) {
+  uint64_t count = 0;
+  for (const char* p = begin; p != end; p = nextLine(p, end))
+    count += isDataLine(p, end);
+  return count;
+}
+
+//! Parses an unsigned decimal; returns nullptr if there is none at p or it
+//! does not fit in 64 bits
+inline const char* parseValue(const char* p, const char* end, uint64_t& v) {
+  p = skipBlanks(p, end);
+  if (p == end || *p < '0' || *p > '9')
+    return nullptr;
+  v = 0;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    unsigned digit = *p - '0';
+    if (v > (UINT64_MAX - digit) / 10)
+      return nullptr;
+    v = v * 10 + digit;
+  }
+  return p;
+}
+
+template <typename T>
+const char* parseValue(
+    const char* p, const char* end, T& v,
+    typename std::enable_if<std::is_integral<T>::value>::type* = 0) {
+  p        = skipBlanks(p, end);
+  bool neg = p != end && *p == '-';
+  if (neg || (p != end && *p == '+'))
+    ++p;
+  // largest magnitude T can hold with this sign
+  uint64_t limit = uint64_t(std::numeric_limits<T>::max());
+  if (neg)
+    limit = std::is_signed<T>::value ? limit + 1 : 0;
+  uint64_t u;
+  p = parseValue(p, end, u);
+  if (!p || u > limit)
+    return nullptr;
+  v = static_cast<T>(neg ? 0 - u : u);
+  return p;
+}
+
+template <typename T>
+const char* parseValue(
+    const char* p, const char* end, T& v,
+    typename std::enable_if<std::is_floating_point<T>::value>::type* = 0) {
+  // the mapping is not null terminated, so strtod works on a copy
+  char buf[64];
+  p        = skipBlanks(p, end);
+  size_t n = 0;
+  while (p + n != end && n + 1 < sizeof(buf) && p[n] != ' ' && p[n] != '\t' &&
+         p[n] != '\r' && p[n] != '\n') {
+    buf[n] = p[n];
+    ++n;
+  }
+  buf[n] = '\0';
+  char* stop;
+  v = static_cast<T>(std::strtod(buf, &stop));
+  return stop == buf ? nullptr : p + (stop - buf);
+}
+
+} // namespace internal
+
+/**
+ * An unsorted list of edges held in LargeArrays: edge e goes from src(e) to
+ * dst(e) and carries data(e) unless EdgeTy is void. Node IDs are 32 bits, as
+ * in LC_CSR_Graph.
+ *
+ * readText parses a text file with one "src dst [data]" edge per line; any
+ * further fields on a line are ignored, as are blank lines and lines
+ * starting with # or %. The file is mapped and cut into chunks at line
+ * breaks; threads first count the edges in each chunk and then parse every
+ * chunk directly into its slice of the arrays.
+ *
+ * @tparam EdgeTy arithmetic type of the edge data, or void
+ */
+template <typename EdgeTy>
+class EdgeList : private boost::noncopyable {
+  static_assert(std::is_void<EdgeTy>::value ||
+                    std::is_arithmetic<EdgeTy>::value,
+                "edge data must be an arithmetic type or void");
+
+public:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_data_type;
+
+private:
+  LargeArray<uint32_t> srcs;
+  LargeArray<uint32_t> dsts;
+  EdgeData edgeData;
+  uint64_t numEdges = 0;
+  uint64_t numNodes = 0;
+
+  //! Chunks per thread when parsing, for load balance
+  static const size_t chunksPerThread = 16;
+
+  template <bool HasData = EdgeData::has_value>
+  const char* parseData(const char* p, const char* end, uint64_t e,
+                        typename std::enable_if<HasData>::type* = 0) {
+    edge_data_type v;
+    p = internal::parseValue(p, end, v);
+    if (p)
+      edgeData.set(e, v);
+    return p;
+  }
+
+  template <bool HasData = EdgeData::has_value>
+  const char* parseData(const char* p, const char*, uint64_t,
+                        typename std::enable_if<!HasData>::type* = 0) {
+    return p;
+  }
+
+  void allocate(uint64_t n) {
+    srcs.deallocate();
+    dsts.deallocate();
+    edgeData.deallocate();
+    srcs.allocateInterleaved(n);
+    dsts.allocateInterleaved(n);
+    edgeData.allocateInterleaved(n);
+    numEdges = n;
+  }
+
+public:
+  /**
+   * Replaces the contents of this list with the edges of a text file.
+   * Dies on lines it cannot parse. Cannot be called during parallel
+   * execution.
+   *
+   * @param filename text file to read
+   */
+  void readText(const std::string& filename) {
+    galois::StatTimer timer("TIMER_EDGELIST_READ");
+    timer.start();
+
+    internal::TextFileChunks file(filename,
+                                  galois::getActiveThreads() * chunksPerThread);
+    size_t numChunks = file.size();
+
+    // edgeStart[c] is the first edge of chunk c
+    std::vector<uint64_t> edgeStart(numChunks + 1, 0);
+    galois::do_all(galois::iterate((size_t)0, numChunks),
+                   [&](size_t c) {
+                     edgeStart[c + 1] =
+                         internal::countDataLines(file.begin(c), file.end(c));
+                   },
+                   galois::steal(), galois::no_stats());
+    std::partial_sum(edgeStart.begin(), edgeStart.end(), edgeStart.begin());
+    allocate(edgeStart[numChunks]);
+
+    galois::GReduceMax<uint32_t> maxNode;
+    galois::do_all(
+        galois::iterate((size_t)0, numChunks),
+        [&](size_t c) {
+          const char* end = file.begin(c);
+          uint64_t e      = edgeStart[c];
+          for (const char* p = file.begin(c); p != file.end(c); p = end) {
+            end = internal::nextLine(p, file.end(c));
+            if (!internal::isDataLine(p, end))
+              continue;
+
+            uint64_t src, dst;
+            const char* q = internal::parseValue(p, end, src);
+            q             = q ? internal::parseValue(q, end, dst) : q;
+            q             = q ? parseData(q, end, e) : q;
+            if (!q) {
+              GALOIS_DIE("malformed edge at byte ", file.offset(p), " of ",
+                         filename);
+            }
+            // the number of nodes must fit in 32 bits too
+            if (std::max(src, dst) >= UINT32_MAX) {
+              GALOIS_DIE("node ID at byte ", file.offset(p), " of ", filename,
+                         " does not fit in 32 bits");
+            }
+            srcs[e] = src;
+            dsts[e] = dst;
+            maxNode.update(std::max(src, dst));
+            ++e;
+          }
+        },
+        galois::steal(), galois::no_stats());
+
+    numNodes = numEdges ? uint64_t(maxNode.reduce()) + 1 : 0;
+    timer.stop();
+  }
+
+  //! @returns number of edges
+  uint64_t size() const { return numEdges; }
+  //! @returns one more than the largest node ID in the list
+  uint64_t sizeNodes() const { return numNodes; }
+
+  uint32_t src(uint64_t e) const { return srcs[e]; }
+  uint32_t dst(uint64_t e) const { return dsts[e]; }
+  edge_data_type data(uint64_t e) const { return edgeData[e]; }
+};
+
+/**
+ * Writes a graph in CSR form as a version 1 .gr file. Threads write their
+ * blocks of each array at their offsets in the file concurrently. Cannot be
+ * called during parallel execution.
+ *
+ * @param filename file to create
+ * @param numNodes number of nodes
+ * @param numEdges number of edges
+ * @param edgeIndex end of the edges of each node, numNodes entries
+ * @param edgeDst destination of each edge, numEdges entries
+ * @param edgeData data of each edge, numEdges entries; ignored if
+ * sizeofEdgeData is 0
+ * @param sizeofEdgeData size of the data of one edge in bytes
+ */
+void writeGRFile(const std::string& filename, uint64_t numNodes,
+                 uint64_t numEdges, const uint64_t* edgeIndex,
+                 const uint32_t* edgeDst, const void* edgeData,
+                 size_t sizeofEdgeData);
+
+} // namespace graphs
+} // namespace galois
+
+#endif
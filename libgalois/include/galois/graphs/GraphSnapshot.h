@@ -0,0 +1,115 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GraphSnapshot.h
+ *
+ * Contains GraphSnapshot, a CSR topology kept in a shared memory file so
+ * that later processes can map it instead of reading the graph again.
+ */
+
+#ifndef GALOIS_GRAPHS_GRAPHSNAPSHOT_H
+#define GALOIS_GRAPHS_GRAPHSNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Edge index, edge destinations and edge data of a CSR graph stored in a
+ * file on a memory file system (tmpfs such as /dev/shm, or hugetlbfs).
+ *
+ * A snapshot records the identity (device, inode, size and modification
+ * time) of the graph file it was built from; attaching fails if that file
+ * has changed since. Snapshots are built under a temporary name and renamed
+ * into place by publish, so a reader never sees a partially written one.
+ *
+ * Attached snapshots are mapped copy-on-write: the pages are shared with
+ * every other process using the snapshot until one of them writes to its
+ * topology (e.g., by sorting edges), which only changes its private copy.
+ */
+class GraphSnapshot : private boost::noncopyable {
+  struct Header;
+
+  std::string path;
+  std::string tmpPath;
+  char* base;
+  size_t length;
+  Header* header;
+
+  GraphSnapshot();
+
+public:
+  ~GraphSnapshot();
+
+  /**
+   * Maps an existing snapshot.
+   *
+   * @param path snapshot file
+   * @param source graph file the snapshot must have been built from
+   * @param sizeofEdge size of edge data the caller expects
+   * @returns the snapshot or null if none matching source exists
+   */
+  static std::shared_ptr<GraphSnapshot>
+  attach(const std::string& path, const std::string& source,
+         uint64_t sizeofEdge);
+
+  /**
+   * Creates an empty snapshot to be filled in by the caller and published.
+   * The snapshot is removed again if it is destroyed before publish.
+   *
+   * @param path snapshot file once published
+   * @param source graph file the snapshot is built from
+   * @param numNodes number of nodes
+   * @param numEdges number of edges
+   * @param sizeofEdge size of edge data of each edge; 0 for none
+   */
+  static std::shared_ptr<GraphSnapshot>
+  create(const std::string& path, const std::string& source, uint64_t numNodes,
+         uint64_t numEdges, uint64_t sizeofEdge);
+
+  /**
+   * Returns the snapshot file used for a graph file in a directory; the
+   * name depends on the identity of the graph file and the edge data kept.
+   */
+  static std::string defaultPath(const std::string& dir,
+                                 const std::string& source,
+                                 uint64_t sizeofEdge);
+
+  //! Makes a created snapshot visible at its path
+  void publish();
+
+  uint64_t size() const;
+  uint64_t sizeEdges() const;
+  //! prefix sum of out degrees (edge end of each node)
+  uint64_t* edgeIndex();
+  uint32_t* edgeDst();
+  //! null if the snapshot has no edge data
+  void* edgeData();
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
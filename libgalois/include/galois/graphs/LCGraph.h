@@ -26,6 +26,8 @@
 #include "LC_Morph_Graph.h"
 #include "LC_InOut_Graph.h"
 #include "LC_Adaptor_Graph.h"
+#include "LC_Compressed_Graph.h"
+#include "LC_Dynamic_Graph.h"
 #include "Util.h"
 
 #endif
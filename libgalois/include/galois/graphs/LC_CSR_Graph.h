@@ -22,9 +22,14 @@
 
 #include "galois/Galois.h"
 #include "galois/graphs/Details.h"
+#include "galois/graphs/DirectFileReader.h"
+#include "galois/graphs/EdgeList.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
+#include "galois/graphs/GraphSnapshot.h"
 
+#include <cstring>
+#include <memory>
 #include <type_traits>
 
 /*
@@ -129,7 +134,14 @@ public:
         type;
   };
 
-  typedef read_default_graph_tag read_tag;
+  //! Edge data can be copied straight from a .gr file without conversion
+  static const bool can_stream_edge_data =
+      std::is_void<EdgeTy>::value ||
+      (std::is_same<EdgeTy, FileEdgeTy>::value &&
+       std::is_trivially_copyable<EdgeTy>::value);
+
+  typedef typename std::conditional<can_stream_edge_data, read_stream_graph_tag,
+                                    read_default_graph_tag>::type read_tag;
 
 protected:
   typedef LargeArray<EdgeTy> EdgeData;
@@ -158,6 +170,9 @@ public:
   typedef iterator const_local_iterator;
 
 protected:
+  //! shared topology the edge arrays point into, if attached to one; declared
+  //! first so that it outlives them
+  std::shared_ptr<GraphSnapshot> snapshot;
   NodeData nodeData;
   EdgeIndData edgeIndData;
   EdgeDst edgeDst;
@@ -407,6 +422,19 @@ public:
 
   GraphNode getEdgeDst(edge_iterator ni) { return edgeDst[*ni]; }
 
+  /**
+   * Returns the destinations of the outgoing edges of a node as a contiguous
+   * array, e.g., for galois::intersectCount. The destination of edge e is
+   * edge_dst_begin(N)[e - edge_begin(N)].
+   */
+  const GraphNode* edge_dst_begin(GraphNode N) const {
+    return edgeDst.data() + *raw_begin(N);
+  }
+
+  const GraphNode* edge_dst_end(GraphNode N) const {
+    return edgeDst.data() + *raw_end(N);
+  }
+
   size_t size() const { return numNodes; }
   size_t sizeEdges() const { return numEdges; }
 
@@ -450,10 +478,11 @@ public:
   }
 
   edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) {
-    auto e = std::lower_bound(
-        edge_begin(N1), edge_end(N1), N2,
+    auto end = edge_end(N1);
+    auto e   = std::lower_bound(
+        edge_begin(N1), end, N2,
         [=](edge_iterator e, GraphNode N) { return getEdgeDst(e) < N; });
-    return (getEdgeDst(e) == N2) ? e : edge_end(N1);
+    return (e != end && getEdgeDst(e) == N2) ? e : end;
   }
 
   runtime::iterable<NoDerefIterator<edge_iterator>>
@@ -741,6 +770,322 @@ public:
     }
   }
 
+  /**
+   * Reads a version 1 .gr file directly into the arrays of this graph
+   * without going through FileGraph. Each thread finds its divideByNode
+   * range by binary searching the node index in the file and then reads
+   * the index entries and edges of that range, so all of its memory is
+   * first touched by the thread that will own it. Cannot be called during
+   * parallel execution.
+   *
+   * @param filename .gr file to read
+   */
+  void readGraphFromGRFile(const std::string& filename) {
+    DirectFileReader reader(filename);
+    readGraphFromGRFile(reader);
+  }
+
+  //! Same as above, reading from an already opened file
+  void readGraphFromGRFile(DirectFileReader& reader) {
+    static_assert(can_stream_edge_data,
+                  "edge data requires conversion; use readGraph instead");
+    galois::StatTimer timer("TIMER_GRAPH_STREAM_READ");
+    timer.start();
+
+    uint64_t header[4];
+    reader.read(header, 0, sizeof(header));
+    uint64_t version    = convert_le64toh(header[0]);
+    uint64_t sizeofEdge = convert_le64toh(header[1]);
+    if (version != 1) {
+      GALOIS_DIE("cannot stream graph file version ", version, "; expected 1");
+    }
+    if (EdgeData::has_value && sizeofEdge != EdgeData::size_of::value) {
+      GALOIS_DIE("edge data size in file (", sizeofEdge,
+                 ") does not match graph edge data size (",
+                 EdgeData::size_of::value, ")");
+    }
+
+    allocateFrom(convert_le64toh(header[2]), convert_le64toh(header[3]));
+
+    const uint64_t idxOffset = sizeof(header);
+    const uint64_t dstOffset = idxOffset + numNodes * sizeof(uint64_t);
+    const uint64_t dataOffset =
+        dstOffset + ((numEdges * sizeof(uint32_t) + 7) & ~uint64_t(7));
+
+    // node index entries are fetched from the file on demand, which takes
+    // a few dozen small reads per thread for the binary search
+    struct FileEdgeIndex {
+      DirectFileReader& reader;
+      uint64_t offset;
+      uint64_t operator[](uint64_t n) const {
+        uint64_t v;
+        reader.read(&v, offset + n * sizeof(uint64_t), sizeof(v));
+        return convert_le64toh(v);
+      }
+    };
+    FileEdgeIndex fileIndex{reader, idxOffset};
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideNodesBinarySearch<FileEdgeIndex, uint32_t>(
+          numNodes, numEdges,
+          NodeData::size_of::value + EdgeIndData::size_of::value +
+              LC_CSR_Graph::size_of_out_of_line::value,
+          EdgeDst::size_of::value + EdgeData::size_of::value, tid, total,
+          fileIndex);
+
+      uint64_t nbeg = *r.first.first;
+      uint64_t nend = *r.first.second;
+      reader.read(&edgeIndData[nbeg], idxOffset + nbeg * sizeof(uint64_t),
+                  (nend - nbeg) * sizeof(uint64_t));
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+      for (uint64_t n = nbeg; n < nend; ++n) {
+        edgeIndData[n] = convert_le64toh(edgeIndData[n]);
+      }
+#endif
+
+      this->setLocalRange(nbeg, nend);
+
+      for (auto n = nbeg; n != nend; ++n) {
+        nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+
+      uint64_t ebeg = *r.second.first;
+      uint64_t eend = *r.second.second;
+      reader.read(&edgeDst[ebeg], dstOffset + ebeg * sizeof(uint32_t),
+                  (eend - ebeg) * sizeof(uint32_t));
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+      for (uint64_t e = ebeg; e < eend; ++e) {
+        edgeDst[e] = convert_le32toh(edgeDst[e]);
+      }
+#endif
+      if (EdgeData::has_value) {
+        reader.read(edgeData.data() + ebeg, dataOffset + ebeg * sizeofEdge,
+                    (eend - ebeg) * sizeofEdge);
+      }
+    });
+
+    timer.stop();
+  }
+
+  /**
+   * Builds this graph from an unsorted list of edges with a parallel
+   * counting sort by source. The edges of each node end up sorted by
+   * destination and parallel edges by their data, so the result does not
+   * depend on the number of threads. Cannot be called during parallel
+   * execution.
+   *
+   * @param nNodes number of nodes; every source and destination must be
+   * smaller
+   * @param nEdges number of edges
+   * @param src function from edge number (uint64_t) to its source
+   * @param dst function from edge number to its destination
+   * @param data function from edge number to its data; ignored if the graph
+   * has no edge data
+   */
+  template <typename SrcFnTy, typename DstFnTy, typename DataFnTy>
+  void constructFromEdges(uint32_t nNodes, uint64_t nEdges, SrcFnTy src,
+                          DstFnTy dst, DataFnTy data) {
+    galois::StatTimer timer("TIMER_GRAPH_FROM_EDGES");
+    timer.start();
+
+    allocateFrom(nNodes, nEdges);
+
+    // degree of each node, then the next free slot of each node
+    LargeArray<uint64_t> cursor;
+    cursor.allocateInterleaved(numNodes);
+    galois::do_all(galois::iterate((uint64_t)0, (uint64_t)numNodes),
+                   [&](uint64_t n) { cursor[n] = 0; }, galois::no_stats());
+    galois::do_all(galois::iterate((uint64_t)0, numEdges),
+                   [&](uint64_t e) {
+                     __sync_fetch_and_add(&cursor[src(e)], 1);
+                   },
+                   galois::no_stats(), galois::loopname("EDGES_DEGREE"));
+    galois::ParallelSTL::partial_sum(cursor.begin(), cursor.end(),
+                                     edgeIndData.begin());
+    galois::do_all(galois::iterate((uint64_t)0, (uint64_t)numNodes),
+                   [&](uint64_t n) { cursor[n] = n ? edgeIndData[n - 1] : 0; },
+                   galois::no_stats());
+    galois::do_all(galois::iterate((uint64_t)0, numEdges),
+                   [&](uint64_t e) {
+                     uint64_t pos = __sync_fetch_and_add(&cursor[src(e)], 1);
+                     edgeDst[pos] = dst(e);
+                     edgeData.set(pos, data(e));
+                   },
+                   galois::no_stats(), galois::loopname("EDGES_SCATTER"));
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideNodesBinarySearch<EdgeIndData, uint32_t>(
+          numNodes, numEdges,
+          NodeData::size_of::value + EdgeIndData::size_of::value +
+              LC_CSR_Graph::size_of_out_of_line::value,
+          EdgeDst::size_of::value + EdgeData::size_of::value, tid, total,
+          edgeIndData);
+
+      this->setLocalRange(*r.first.first, *r.first.second);
+
+      for (auto n = *r.first.first; n != *r.first.second; ++n) {
+        nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+    });
+
+    // the scatter places the edges of a node in any order
+    typedef EdgeSortValue<GraphNode, EdgeTy> EdgeSortVal;
+    galois::do_all(galois::iterate(*this),
+                   [&](GraphNode n) {
+                     std::sort(edge_sort_begin(n), edge_sort_end(n),
+                               [](const EdgeSortVal& e1,
+                                  const EdgeSortVal& e2) {
+                                 return e1.dst < e2.dst ||
+                                        (e1.dst == e2.dst &&
+                                         e1.get() < e2.get());
+                               });
+                   },
+                   galois::no_stats(), galois::steal());
+    timer.stop();
+  }
+
+  /**
+   * Builds this graph from an edge list; see constructFromEdges. Dies if the
+   * number of nodes does not fit in 32 bits.
+   *
+   * @param edges edges of the graph
+   * @param nNodes number of nodes; 0 to use edges.sizeNodes()
+   */
+  template <typename ListEdgeTy>
+  void constructFrom(const EdgeList<ListEdgeTy>& edges, uint64_t nNodes = 0) {
+    if (!nNodes) {
+      nNodes = edges.sizeNodes();
+    }
+    if (nNodes > UINT32_MAX) {
+      GALOIS_DIE("edge list has ", nNodes, " nodes; at most ", UINT32_MAX,
+                 " are supported");
+    }
+    constructFromEdges(
+        nNodes, edges.size(), [&](uint64_t e) { return edges.src(e); },
+        [&](uint64_t e) { return edges.dst(e); },
+        [&](uint64_t e) { return edges.data(e); });
+  }
+
+  /**
+   * Writes this graph as a version 1 .gr file in parallel. Cannot be called
+   * during parallel execution.
+   *
+   * @param filename file to create
+   */
+  void writeGraphToGRFile(const std::string& filename) const {
+    static_assert(std::is_void<EdgeTy>::value ||
+                      std::is_trivially_copyable<EdgeTy>::value,
+                  "edge data must be trivially copyable to be written");
+    writeGRFile(filename, numNodes, numEdges, edgeIndData.data(),
+                edgeDst.data(), edgeData.data(), EdgeData::size_of::value);
+  }
+
+  /**
+   * Returns the snapshot file used for a graph file in a snapshot directory.
+   */
+  static std::string snapshotPath(const std::string& dir,
+                                  const std::string& filename) {
+    return GraphSnapshot::defaultPath(dir, filename, EdgeData::size_of::value);
+  }
+
+  /**
+   * Makes the edge arrays of this graph point into a snapshot of filename
+   * previously published with publishSnapshot; only node data is allocated.
+   * Cannot be called during parallel execution.
+   *
+   * @param path snapshot file
+   * @param filename graph file the snapshot must have been built from
+   * @returns false if there is no up-to-date snapshot at path
+   */
+  bool attachSnapshot(const std::string& path, const std::string& filename) {
+    static_assert(can_stream_edge_data,
+                  "edge data requires conversion; use readGraph instead");
+    auto snap = GraphSnapshot::attach(path, filename, EdgeData::size_of::value);
+    if (!snap) {
+      return false;
+    }
+    galois::StatTimer timer("TIMER_GRAPH_SNAPSHOT_ATTACH");
+    timer.start();
+
+    numNodes = snap->size();
+    numEdges = snap->sizeEdges();
+    EdgeIndData sharedIndData(snap->edgeIndex(), numNodes);
+    EdgeDst sharedDst(snap->edgeDst(), numEdges);
+    EdgeData sharedData(snap->edgeData(), numEdges);
+    swap(edgeIndData, sharedIndData);
+    swap(edgeDst, sharedDst);
+    swap(edgeData, sharedData);
+    snapshot = std::move(snap);
+
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideNodesBinarySearch<EdgeIndData, uint32_t>(
+          numNodes, numEdges,
+          NodeData::size_of::value + EdgeIndData::size_of::value +
+              LC_CSR_Graph::size_of_out_of_line::value,
+          EdgeDst::size_of::value + EdgeData::size_of::value, tid, total,
+          edgeIndData);
+
+      this->setLocalRange(*r.first.first, *r.first.second);
+
+      for (auto n = *r.first.first; n != *r.first.second; ++n) {
+        nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+    });
+
+    timer.stop();
+    return true;
+  }
+
+  /**
+   * Copies the topology of this graph into a new snapshot at path that
+   * later attachSnapshot calls (in this or other processes) can map.
+   * Does nothing beyond a warning if the snapshot cannot be created.
+   *
+   * @param path snapshot file
+   * @param filename graph file this graph was read from
+   */
+  void publishSnapshot(const std::string& path, const std::string& filename) {
+    auto snap = GraphSnapshot::create(path, filename, numNodes, numEdges,
+                                      EdgeData::size_of::value);
+    if (!snap) {
+      return;
+    }
+    galois::StatTimer timer("TIMER_GRAPH_SNAPSHOT_PUBLISH");
+    timer.start();
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      uint64_t nbeg = numNodes * tid / total;
+      uint64_t nend = numNodes * (tid + 1) / total;
+      std::memcpy(snap->edgeIndex() + nbeg, edgeIndData.data() + nbeg,
+                  (nend - nbeg) * sizeof(uint64_t));
+
+      uint64_t ebeg = numEdges * tid / total;
+      uint64_t eend = numEdges * (tid + 1) / total;
+      std::memcpy(snap->edgeDst() + ebeg, edgeDst.data() + ebeg,
+                  (eend - ebeg) * sizeof(uint32_t));
+      if (EdgeData::has_value) {
+        std::memcpy(static_cast<char*>(snap->edgeData()) +
+                        ebeg * EdgeData::size_of::value,
+                    edgeData.data() + ebeg,
+                    (eend - ebeg) * EdgeData::size_of::value);
+      }
+    });
+
+    snap->publish();
+    timer.stop();
+  }
+
   /**
    * Returns the reference to the edgeIndData LargeArray
    * (a prefix sum of edges)
@@ -0,0 +1,625 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+#define GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+// Compressed graph file format:
+// magic ("GALCMPG1") {uint64_t LE}
+// EdgeType size {uint64_t LE}
+// numNodes {uint64_t LE}
+// numEdges {uint64_t LE}
+// numBytes {uint64_t LE}
+// outindexs[numNodes] {uint64_t LE} (same meaning as in .gr files)
+// byteindexs[numNodes] {uint64_t LE} (byteindex[nodeid] is the offset of the
+// end of nodeid's encoded neighbors in the byte array)
+// bytes[numBytes] {uint8_t}
+// potential padding (64bit max) to Re-Align to 64bits
+// EdgeType[numEdges] {EdgeType size}
+//
+// The neighbors of a node are sorted by destination and byte-coded: the
+// first destination is stored as the zig-zag encoded difference to the
+// source, every following one as the difference to its predecessor. Each
+// difference is written 7 bits per byte with the high bit marking that more
+// bytes follow.
+
+struct read_compressed_graph_tag {};
+
+namespace internal {
+
+//! Magic tag of the compressed file format ("GALCMPG1" in file byte
+//! order); deliberately outside the range of .gr version numbers
+static const uint64_t compressedGraphMagic = 0x3147504D434C4147ULL;
+
+//! Number of bytes needed to byte-code v
+inline size_t varintSize(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    ++n;
+  }
+  return n;
+}
+
+//! Byte-codes v at out; returns the position after the last written byte
+inline uint8_t* encodeVarint(uint64_t v, uint8_t* out) {
+  while (v >= 0x80) {
+    *out++ = static_cast<uint8_t>(v | 0x80);
+    v >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(v);
+  return out;
+}
+
+//! Decodes a byte-coded value at p and advances p past it
+inline uint64_t decodeVarint(const uint8_t*& p) {
+  uint64_t v = *p & 0x7F;
+  unsigned shift = 7;
+  while (*p++ & 0x80) {
+    v |= static_cast<uint64_t>(*p & 0x7F) << shift;
+    shift += 7;
+  }
+  return v;
+}
+
+inline uint64_t zigZagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigZagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/**
+ * Forward iterator over the edges of a node of {@link LC_Compressed_Graph}.
+ * Dereferencing yields the global edge index (usable for edge data); the
+ * destination is decoded as the iterator advances.
+ */
+class CompressedEdgeIterator
+    : public boost::iterator_facade<CompressedEdgeIterator, uint64_t,
+                                    boost::forward_traversal_tag, uint64_t> {
+  friend class boost::iterator_core_access;
+
+  const uint8_t* ptr;
+  uint64_t idx;
+  uint64_t last;
+  uint32_t dst;
+
+  void increment() {
+    if (++idx != last)
+      dst += static_cast<uint32_t>(decodeVarint(ptr));
+  }
+
+  bool equal(const CompressedEdgeIterator& other) const {
+    return idx == other.idx;
+  }
+
+  uint64_t dereference() const { return idx; }
+
+public:
+  CompressedEdgeIterator() : ptr(nullptr), idx(0), last(0), dst(0) {}
+
+  CompressedEdgeIterator(const uint8_t* p, uint64_t b, uint64_t e,
+                         uint32_t src)
+      : ptr(p), idx(b), last(e), dst(0) {
+    if (idx != last)
+      dst = src + static_cast<uint32_t>(zigZagDecode(decodeVarint(ptr)));
+  }
+
+  uint32_t getDst() const { return dst; }
+};
+
+} // namespace internal
+
+/**
+ * Local computation graph whose adjacency lists are stored delta and
+ * byte-coded (Ligra+ style). Structure is read-only; neighbors of every node
+ * are kept sorted by destination. Edge data, if any, is stored uncompressed
+ * and indexed by global edge id.
+ *
+ * Compared to {@link LC_CSR_Graph}, edge iterators are forward-only, so
+ * operators must walk neighbors sequentially with edges(n) or
+ * edge_begin(n)/edge_end(n); use getDegree(n) instead of std::distance.
+ *
+ * The graph can be read from a .gr file (compressed while loading) or from
+ * a compressed file written by toFile() or graph-convert's gr2compressedgr
+ * mode. Loading a compressed file never materializes the uncompressed
+ * adjacency; compressing a .gr file maps it in full first.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
+          bool UseNumaAlloc = false, bool HasOutOfLineLockable = false,
+          typename FileEdgeTy = EdgeTy>
+class LC_Compressed_Graph
+    : private boost::noncopyable,
+      private internal::LocalIteratorFeature<UseNumaAlloc>,
+      private internal::OutOfLineLockableFeature<HasOutOfLineLockable &&
+                                                 !HasNoLockable> {
+public:
+  template <bool _has_id>
+  struct with_id {
+    typedef LC_Compressed_Graph type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef LC_Compressed_Graph<_node_data, EdgeTy, HasNoLockable,
+                                UseNumaAlloc, HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, _edge_data, HasNoLockable,
+                                UseNumaAlloc, HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                                HasOutOfLineLockable, _file_edge_data>
+        type;
+  };
+
+  //! If true, do not use abstract locks in graph
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc,
+                                HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  //! If true, use NUMA-aware graph allocation
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc,
+                                HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  //! If true, store abstract locks separate from nodes
+  template <bool _has_out_of_line_lockable>
+  struct with_out_of_line_lockable {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                                _has_out_of_line_lockable, FileEdgeTy>
+        type;
+  };
+
+  typedef read_compressed_graph_tag read_tag;
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint8_t> EdgeBytes;
+  typedef internal::NodeInfoBaseTypes<NodeTy,
+                                      !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy,
+                                 !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfo;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef LargeArray<NodeInfo> NodeData;
+
+public:
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef FileEdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef internal::CompressedEdgeIterator edge_iterator;
+  using iterator = boost::counting_iterator<uint32_t>;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+protected:
+  NodeData nodeData;
+  EdgeIndData edgeIndData;
+  EdgeIndData byteIndData;
+  EdgeBytes edgeBytes;
+  EdgeData edgeData;
+
+  uint64_t numNodes;
+  uint64_t numEdges;
+  uint64_t numBytes;
+
+  uint64_t edgeBeginIdx(GraphNode N) const {
+    return (N == 0) ? 0 : edgeIndData[N - 1];
+  }
+
+  uint64_t byteBeginIdx(GraphNode N) const {
+    return (N == 0) ? 0 : byteIndData[N - 1];
+  }
+
+  edge_iterator raw_begin(GraphNode N) const {
+    return edge_iterator(&edgeBytes[byteBeginIdx(N)], edgeBeginIdx(N),
+                         edgeIndData[N], N);
+  }
+
+  edge_iterator raw_end(GraphNode N) const {
+    return edge_iterator(nullptr, edgeIndData[N], edgeIndData[N], N);
+  }
+
+  template <bool _A1 = HasNoLockable, bool _A2 = HasOutOfLineLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<!_A1 && !_A2>::type* = 0) {
+    galois::runtime::acquire(&nodeData[N], mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    this->outOfLineAcquire(getId(N), mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<_A2>::type* = 0) {}
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph, uint64_t e,
+                          typename FileGraph::edge_iterator nn,
+                          typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    typedef LargeArray<FileEdgeTy> FED;
+    if (EdgeData::has_value)
+      edgeData.set(e, graph.getEdgeData<typename FED::value_type>(nn));
+  }
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph, uint64_t e,
+                          typename FileGraph::edge_iterator nn,
+                          typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edgeData.set(e, {});
+  }
+
+  size_t getId(GraphNode N) { return N; }
+
+  GraphNode getNode(size_t n) { return n; }
+
+  void allocateNodes() {
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeIndData.allocateBlocked(numNodes);
+      byteIndData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
+  void allocateBytes() {
+    // one extra zero byte so that decoding never reads past the allocation
+    if (UseNumaAlloc) {
+      edgeBytes.allocateBlocked(numBytes + 1);
+    } else {
+      edgeBytes.allocateInterleaved(numBytes + 1);
+    }
+    edgeBytes[numBytes] = 0;
+  }
+
+  void constructNodes() {
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = galois::block_range((uint64_t)0, numNodes, tid, total);
+      this->setLocalRange(r.first, r.second);
+      for (uint64_t n = r.first; n < r.second; ++n) {
+        nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+    });
+  }
+
+  //! Sorted (destination, file edge) pairs of node n of a file graph
+  void sortedNeighbors(FileGraph& graph, FileGraph::GraphNode n,
+                       std::vector<std::pair<uint32_t, uint64_t>>& out) {
+    out.clear();
+    for (auto nn = graph.edge_begin(n), en = graph.edge_end(n); nn != en;
+         ++nn) {
+      out.emplace_back(graph.getEdgeDst(nn), *nn);
+    }
+    std::sort(out.begin(), out.end());
+  }
+
+  static uint64_t
+  encodedSize(uint32_t src,
+              const std::vector<std::pair<uint32_t, uint64_t>>& nbrs) {
+    uint64_t size = 0;
+    uint32_t prev = src;
+    bool first    = true;
+    for (auto& p : nbrs) {
+      if (first) {
+        size += internal::varintSize(internal::zigZagEncode(
+            static_cast<int64_t>(p.first) - static_cast<int64_t>(src)));
+        first = false;
+      } else {
+        size += internal::varintSize(p.first - prev);
+      }
+      prev = p.first;
+    }
+    return size;
+  }
+
+public:
+  LC_Compressed_Graph() : numNodes(0), numEdges(0), numBytes(0) {}
+  LC_Compressed_Graph(LC_Compressed_Graph&& rhs) = default;
+  LC_Compressed_Graph& operator=(LC_Compressed_Graph&&) = default;
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag mflag = MethodFlag::WRITE) {
+    NodeInfo& NI = nodeData[N];
+    acquireNode(N, mflag);
+    return NI.getData();
+  }
+
+  edge_data_reference getEdgeData(edge_iterator ni,
+                                  MethodFlag = MethodFlag::UNPROTECTED) {
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(edge_iterator ni) const { return ni.getDst(); }
+
+  //! Number of out edges of N; constant time unlike std::distance
+  uint64_t getDegree(GraphNode N) const {
+    return edgeIndData[N] - edgeBeginIdx(N);
+  }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+
+  //! Number of bytes used by the encoded adjacency lists
+  size_t sizeEdgeBytes() const { return numBytes; }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+
+  local_iterator local_end() {
+    return local_iterator(this->localEnd(numNodes));
+  }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    if (galois::runtime::shouldLock(mflag)) {
+      for (edge_iterator ii = raw_begin(N), ee = raw_end(N); ii != ee; ++ii) {
+        acquireNode(ii.getDst(), mflag);
+      }
+    }
+    return raw_begin(N);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return raw_end(N);
+  }
+
+  edge_iterator findEdge(GraphNode N1, GraphNode N2) {
+    edge_iterator ii = edge_begin(N1), ee = edge_end(N1);
+    // neighbors are sorted, so stop at the first larger destination
+    for (; ii != ee && ii.getDst() < N2; ++ii)
+      ;
+    return (ii != ee && ii.getDst() == N2) ? ii : ee;
+  }
+
+  edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) {
+    return findEdge(N1, N2);
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return edges(N, mflag);
+  }
+
+  /**
+   * Builds the compressed representation from a file graph. Neighbors are
+   * sorted by destination while encoding; edge data follows its edge.
+   */
+  void constructFrom(FileGraph& graph) {
+    numNodes = graph.size();
+    numEdges = graph.sizeEdges();
+    allocateNodes();
+
+    typedef std::vector<std::pair<uint32_t, uint64_t>> Neighbors;
+    galois::substrate::PerThreadStorage<Neighbors> scratch;
+
+    // pass 1: encoded size of every node
+    galois::do_all(galois::iterate(0ul, numNodes),
+                   [&](uint64_t n) {
+                     Neighbors& nbrs = *scratch.getLocal();
+                     sortedNeighbors(graph, n, nbrs);
+                     edgeIndData[n] = nbrs.size();
+                     byteIndData[n] = encodedSize(n, nbrs);
+                   },
+                   galois::no_stats(), galois::steal(),
+                   galois::loopname("COMPRESS_SIZE"));
+
+    galois::ParallelSTL::partial_sum(edgeIndData.begin(), edgeIndData.end(),
+                                     edgeIndData.begin());
+    galois::ParallelSTL::partial_sum(byteIndData.begin(), byteIndData.end(),
+                                     byteIndData.begin());
+    numBytes = numNodes ? byteIndData[numNodes - 1] : 0;
+    allocateBytes();
+
+    // pass 2: encode
+    galois::do_all(galois::iterate(0ul, numNodes),
+                   [&](uint64_t n) {
+                     Neighbors& nbrs = *scratch.getLocal();
+                     sortedNeighbors(graph, n, nbrs);
+                     uint8_t* out  = &edgeBytes[byteBeginIdx(n)];
+                     uint64_t e    = edgeBeginIdx(n);
+                     uint32_t prev = n;
+                     bool first    = true;
+                     for (auto& p : nbrs) {
+                       if (first) {
+                         out = internal::encodeVarint(
+                             internal::zigZagEncode(
+                                 static_cast<int64_t>(p.first) -
+                                 static_cast<int64_t>(n)),
+                             out);
+                         first = false;
+                       } else {
+                         out = internal::encodeVarint(p.first - prev, out);
+                       }
+                       prev = p.first;
+                       constructEdgeValue(graph, e++,
+                                          FileGraph::edge_iterator(p.second));
+                     }
+                   },
+                   galois::no_stats(), galois::steal(),
+                   galois::loopname("COMPRESS_ENCODE"));
+
+    constructNodes();
+  }
+
+  /**
+   * Reads a graph written by toFile().
+   */
+  void fromFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios_base::binary);
+    if (!in.is_open())
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t header[5];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (header[0] != internal::compressedGraphMagic)
+      GALOIS_DIE("'", filename, "' is not a compressed graph file");
+    if (header[1] != EdgeData::size_of::value)
+      GALOIS_DIE("edge data size mismatch in ", "'", filename, "'");
+
+    numNodes = header[2];
+    numEdges = header[3];
+    numBytes = header[4];
+    allocateNodes();
+    allocateBytes();
+
+    in.read(reinterpret_cast<char*>(edgeIndData.data()),
+            numNodes * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(byteIndData.data()),
+            numNodes * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(edgeBytes.data()), numBytes);
+    if (EdgeData::has_value) {
+      in.seekg(((numBytes + 7) & ~7ul) - numBytes, std::ios_base::cur);
+      in.read(reinterpret_cast<char*>(edgeData.data()),
+              numEdges * EdgeData::size_of::value);
+    }
+    if (!in)
+      GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+
+    constructNodes();
+  }
+
+  /**
+   * Writes the compressed graph (without node data) to a file.
+   */
+  void toFile(const std::string& filename) const {
+    std::ofstream out(filename, std::ios_base::binary | std::ios_base::trunc);
+    if (!out.is_open())
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t header[5] = {internal::compressedGraphMagic,
+                          EdgeData::size_of::value, numNodes, numEdges,
+                          numBytes};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(edgeIndData.data()),
+              numNodes * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(byteIndData.data()),
+              numNodes * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(edgeBytes.data()), numBytes);
+    if (EdgeData::has_value) {
+      const char padding[8] = {0};
+      out.write(padding, ((numBytes + 7) & ~7ul) - numBytes);
+      out.write(reinterpret_cast<const char*>(edgeData.data()),
+                numEdges * EdgeData::size_of::value);
+    }
+    if (!out)
+      GALOIS_SYS_DIE("failed writing to ", "'", filename, "'");
+  }
+};
+
+//! Returns true if filename holds a graph written by LC_Compressed_Graph
+inline bool isCompressedGraphFile(const std::string& filename) {
+  std::ifstream in(filename, std::ios_base::binary);
+  uint64_t magic = 0;
+  in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  return in && magic == internal::compressedGraphMagic;
+}
+
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag,
+                       FileGraph& f) {
+  graph.constructFrom(f);
+}
+
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag tag,
+                       const std::string& filename) {
+  if (isCompressedGraphFile(filename)) {
+    graph.fromFile(filename);
+  } else {
+    FileGraph f;
+    f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
+    readGraphDispatch(graph, tag, f);
+  }
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
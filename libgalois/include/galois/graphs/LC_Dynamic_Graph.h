@@ -0,0 +1,727 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPH_LC_DYNAMIC_GRAPH_H
+#define GALOIS_GRAPH_LC_DYNAMIC_GRAPH_H
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/gIO.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Local computation graph whose edges can be changed in batches between
+ * parallel loops. Traversal is as in {@link LC_CSR_Graph}: the edges of a
+ * node are contiguous and edge iterators are edge positions, so operators
+ * written against LC_CSR_Graph run unchanged.
+ *
+ * Edges live in one arena. Every node owns a block of the arena with some
+ * slack; the CSR read from a file starts out packed, without slack. A batch
+ * of insertions that does not fit into a block moves the block to the end of
+ * the arena with twice the capacity. Deletions are compacted within the
+ * block. Blocks that were moved leave holes behind; once the holes exceed a
+ * fraction of the arena (see setCompactionThreshold) the arena is rebuilt
+ * packed, with compactionSlack free slots per node.
+ *
+ * applyBatch and compact change edge positions, so edge iterators and edge
+ * indices are only valid until the next update. Updates cannot run
+ * concurrently with other operations on the graph.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
+          bool UseNumaAlloc = false, bool HasOutOfLineLockable = false,
+          typename FileEdgeTy = EdgeTy>
+class LC_Dynamic_Graph
+    : private boost::noncopyable,
+      private internal::LocalIteratorFeature<UseNumaAlloc>,
+      private internal::OutOfLineLockableFeature<HasOutOfLineLockable &&
+                                                 !HasNoLockable> {
+public:
+  template <bool _has_id>
+  struct with_id {
+    typedef LC_Dynamic_Graph type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef LC_Dynamic_Graph<_node_data, EdgeTy, HasNoLockable, UseNumaAlloc,
+                             HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef LC_Dynamic_Graph<NodeTy, _edge_data, HasNoLockable, UseNumaAlloc,
+                             HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    typedef LC_Dynamic_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                             HasOutOfLineLockable, _file_edge_data>
+        type;
+  };
+
+  //! If true, do not use abstract locks in graph
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    typedef LC_Dynamic_Graph<NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc,
+                             HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  //! If true, use NUMA-aware graph allocation
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef LC_Dynamic_Graph<NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc,
+                             HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  //! If true, store abstract locks separate from nodes
+  template <bool _has_out_of_line_lockable>
+  struct with_out_of_line_lockable {
+    typedef LC_Dynamic_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                             _has_out_of_line_lockable, FileEdgeTy>
+        type;
+  };
+
+  typedef read_default_graph_tag read_tag;
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint32_t> EdgeDst;
+  typedef internal::NodeInfoBaseTypes<NodeTy,
+                                      !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy,
+                                 !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfo;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef LargeArray<uint32_t> EdgeCountData;
+  typedef LargeArray<NodeInfo> NodeData;
+
+public:
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef FileEdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  using edge_iterator = boost::counting_iterator<uint64_t>;
+  using iterator      = boost::counting_iterator<uint32_t>;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+  //! An edge to insert with applyBatch, with its data if EdgeTy is not void
+  struct EdgeUpdate : public StrictObject<EdgeTy> {
+    typedef StrictObject<EdgeTy> Super;
+    GraphNode src;
+    GraphNode dst;
+
+    EdgeUpdate() = default;
+    EdgeUpdate(GraphNode s, GraphNode d,
+               typename Super::const_reference v = typename Super::value_type())
+        : Super(v), src(s), dst(d) {}
+
+    bool operator<(const EdgeUpdate& rhs) const {
+      return src < rhs.src || (src == rhs.src && dst < rhs.dst);
+    }
+  };
+
+  //! An edge to delete with applyBatch: (source, destination)
+  typedef std::pair<GraphNode, GraphNode> EdgeDeletion;
+
+  //! Free slots given to every node when the arena is compacted, as a
+  //! fraction (1 / compactionSlack) of its degree
+  static const uint32_t compactionSlack = 4;
+  //! Capacity of a block created for a node without edges
+  static const uint32_t minBlockCapacity = 4;
+
+protected:
+  NodeData nodeData;
+  //! first arena slot of the block of each node
+  EdgeIndData edgeBegin;
+  //! number of edges of each node
+  EdgeCountData edgeDegree;
+  //! number of arena slots in the block of each node
+  EdgeCountData edgeCapacity;
+  EdgeDst edgeDst;
+  EdgeData edgeData;
+
+  uint64_t numNodes   = 0;
+  uint64_t numEdges   = 0;
+  //! slots allocated in edgeDst and edgeData
+  uint64_t arenaSize  = 0;
+  //! slots in use by blocks or holes; new blocks start here
+  uint64_t arenaUsed  = 0;
+  //! slots of blocks that were moved away
+  uint64_t arenaHoles = 0;
+  //! compact when holes exceed this fraction of the used arena
+  double compactionThreshold = 0.5;
+  //! keep the edges of every node sorted by destination
+  bool sortedByDst = false;
+
+  typedef internal::EdgeSortIterator<GraphNode, uint64_t, EdgeDst, EdgeData>
+      edge_sort_iterator;
+
+  edge_iterator raw_begin(GraphNode N) const {
+    return edge_iterator(edgeBegin[N]);
+  }
+
+  edge_iterator raw_end(GraphNode N) const {
+    return edge_iterator(edgeBegin[N] + edgeDegree[N]);
+  }
+
+  edge_sort_iterator edge_sort_begin(GraphNode N) {
+    return edge_sort_iterator(*raw_begin(N), &edgeDst, &edgeData);
+  }
+
+  edge_sort_iterator edge_sort_end(GraphNode N) {
+    return edge_sort_iterator(*raw_end(N), &edgeDst, &edgeData);
+  }
+
+  template <bool _A1 = HasNoLockable, bool _A2 = HasOutOfLineLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<!_A1 && !_A2>::type* = 0) {
+    galois::runtime::acquire(&nodeData[N], mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    this->outOfLineAcquire(getId(N), mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode, MethodFlag,
+                   typename std::enable_if<_A2>::type* = 0) {}
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph,
+                          typename FileGraph::edge_iterator nn,
+                          typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    typedef LargeArray<FileEdgeTy> FED;
+    if (EdgeData::has_value)
+      edgeData.set(*nn, graph.getEdgeData<typename FED::value_type>(nn));
+  }
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph,
+                          typename FileGraph::edge_iterator nn,
+                          typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edgeData.set(*nn, {});
+  }
+
+  size_t getId(GraphNode N) { return N; }
+
+  GraphNode getNode(size_t n) { return n; }
+
+  template <typename T>
+  static void allocate(T& array, size_t n) {
+    if (UseNumaAlloc)
+      array.allocateBlocked(n);
+    else
+      array.allocateInterleaved(n);
+  }
+
+  void copyEdge(EdgeDst& toDst, EdgeData& toData, uint64_t to, uint64_t from) {
+    toDst[to] = edgeDst[from];
+    toData.set(to, edgeData[from]);
+  }
+
+  //! Moves edge from to slot to within the arena
+  void moveEdge(uint64_t to, uint64_t from) {
+    edgeDst[to] = edgeDst[from];
+    edgeData.set(to, edgeData[from]);
+  }
+
+  //! Extra arena slots reserved beyond size so that small batches fit
+  static uint64_t withReserve(uint64_t size) { return size + size / 8 + 1024; }
+
+  /**
+   * Makes the arena hold at least size slots, copying the used part into a
+   * new allocation if needed.
+   */
+  void reserveArena(uint64_t size) {
+    if (size <= arenaSize)
+      return;
+    uint64_t newSize = std::max(withReserve(size), 2 * arenaSize);
+    EdgeDst newDst;
+    EdgeData newData;
+    allocate(newDst, newSize);
+    allocate(newData, newSize);
+    galois::do_all(galois::iterate((uint64_t)0, arenaUsed),
+                   [&](uint64_t e) { copyEdge(newDst, newData, e, e); },
+                   galois::no_stats(), galois::loopname("DYNAMIC_GROW"));
+    edgeDst.destroy();
+    edgeDst.deallocate();
+    edgeData.destroy();
+    edgeData.deallocate();
+    swap(edgeDst, newDst);
+    swap(edgeData, newData);
+    arenaSize = newSize;
+  }
+
+  /**
+   * Returns the positions where the source changes in a batch sorted by
+   * source, followed by the size of the batch.
+   */
+  template <typename SrcFn>
+  static std::vector<size_t> sourceRuns(size_t size, SrcFn src) {
+    galois::InsertBag<size_t> bag;
+    galois::do_all(galois::iterate((size_t)0, size),
+                   [&](size_t i) {
+                     if (i == 0 || src(i) != src(i - 1))
+                       bag.push(i);
+                   },
+                   galois::no_stats(), galois::loopname("DYNAMIC_RUNS"));
+    std::vector<size_t> runs(bag.begin(), bag.end());
+    galois::ParallelSTL::sort(runs.begin(), runs.end());
+    runs.push_back(size);
+    return runs;
+  }
+
+  //! Dies if an endpoint of an update is not a node of this graph
+  template <typename UpdateTy, typename SrcFnTy, typename DstFnTy>
+  void checkEndpoints(const std::vector<UpdateTy>& updates, SrcFnTy src,
+                      DstFnTy dst) const {
+    galois::GReduceLogicalOR outOfRange;
+    galois::do_all(galois::iterate(updates),
+                   [&](const UpdateTy& u) {
+                     if (src(u) >= numNodes || dst(u) >= numNodes)
+                       outOfRange.update(true);
+                   },
+                   galois::no_stats());
+    if (outOfRange.reduce()) {
+      GALOIS_DIE("edge update with an endpoint outside the ", numNodes,
+                 " nodes of the graph");
+    }
+  }
+
+  void applyDeletions(std::vector<EdgeDeletion>& deletions) {
+    galois::ParallelSTL::sort(deletions.begin(), deletions.end());
+    deletions.erase(std::unique(deletions.begin(), deletions.end()),
+                    deletions.end());
+    std::vector<size_t> runs = sourceRuns(
+        deletions.size(), [&](size_t i) { return deletions[i].first; });
+
+    galois::GAccumulator<uint64_t> removed;
+    galois::do_all(
+        galois::iterate((size_t)0, runs.size() - 1),
+        [&](size_t r) {
+          auto first     = deletions.begin() + runs[r];
+          auto last      = deletions.begin() + runs[r + 1];
+          GraphNode src  = first->first;
+          uint64_t begin = edgeBegin[src];
+          uint64_t end   = begin + edgeDegree[src];
+          uint64_t out   = begin;
+          for (uint64_t e = begin; e < end; ++e) {
+            EdgeDeletion key(src, edgeDst[e]);
+            if (!std::binary_search(first, last, key)) {
+              if (out != e)
+                moveEdge(out, e);
+              ++out;
+            }
+          }
+          removed += end - out;
+          edgeDegree[src] = out - begin;
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("DYNAMIC_DELETE"));
+    numEdges -= removed.reduce();
+  }
+
+  void applyInsertions(std::vector<EdgeUpdate>& insertions) {
+    galois::ParallelSTL::sort(insertions.begin(), insertions.end());
+    std::vector<size_t> runs = sourceRuns(
+        insertions.size(), [&](size_t i) { return insertions[i].src; });
+    size_t numRuns = runs.size() - 1;
+
+    // capacity of the new block of every source that has to move
+    std::vector<uint64_t> moved(numRuns);
+    galois::do_all(galois::iterate((size_t)0, numRuns),
+                   [&](size_t r) {
+                     GraphNode src = insertions[runs[r]].src;
+                     uint64_t need =
+                         edgeDegree[src] + (runs[r + 1] - runs[r]);
+                     moved[r] = need <= edgeCapacity[src]
+                                    ? 0
+                                    : std::max<uint64_t>(
+                                          std::max<uint64_t>(
+                                              need, 2 * edgeCapacity[src]),
+                                          minBlockCapacity);
+                   },
+                   galois::no_stats(), galois::loopname("DYNAMIC_CAPACITY"));
+    galois::ParallelSTL::partial_sum(moved.begin(), moved.end(),
+                                     moved.begin());
+    uint64_t newSlots = numRuns ? moved.back() : 0;
+    reserveArena(arenaUsed + newSlots);
+
+    galois::GAccumulator<uint64_t> holes;
+    galois::do_all(
+        galois::iterate((size_t)0, numRuns),
+        [&](size_t r) {
+          GraphNode src = insertions[runs[r]].src;
+          uint64_t prev = r ? moved[r - 1] : 0;
+          uint64_t deg  = edgeDegree[src];
+          if (moved[r] != prev) {
+            uint64_t begin = arenaUsed + prev;
+            for (uint64_t i = 0; i < deg; ++i)
+              moveEdge(begin + i, edgeBegin[src] + i);
+            holes += edgeCapacity[src];
+            edgeBegin[src]    = begin;
+            edgeCapacity[src] = moved[r] - prev;
+          }
+          insertEdges(src, insertions.begin() + runs[r],
+                      insertions.begin() + runs[r + 1]);
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("DYNAMIC_INSERT"));
+
+    arenaUsed += newSlots;
+    arenaHoles += holes.reduce();
+    numEdges += insertions.size();
+  }
+
+  //! Adds [first, last) to the block of src, which has room for them
+  template <typename Iter>
+  void insertEdges(GraphNode src, Iter first, Iter last) {
+    uint64_t begin = edgeBegin[src];
+    uint64_t deg   = edgeDegree[src];
+    uint64_t num   = std::distance(first, last);
+    if (!sortedByDst) {
+      uint64_t out = begin + deg;
+      for (; first != last; ++first, ++out) {
+        edgeDst[out] = first->dst;
+        edgeData.set(out, first->get());
+      }
+    } else {
+      // merge from the back; [first, last) is sorted by destination
+      uint64_t out = begin + deg + num;
+      uint64_t old = begin + deg;
+      while (first != last) {
+        if (old != begin && edgeDst[old - 1] > (last - 1)->dst) {
+          moveEdge(--out, --old);
+        } else {
+          --last;
+          --out;
+          edgeDst[out] = last->dst;
+          edgeData.set(out, last->get());
+        }
+      }
+    }
+    edgeDegree[src] = deg + num;
+  }
+
+public:
+  LC_Dynamic_Graph()                         = default;
+  LC_Dynamic_Graph(LC_Dynamic_Graph&& rhs)   = default;
+  LC_Dynamic_Graph& operator=(LC_Dynamic_Graph&&) = default;
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag mflag = MethodFlag::WRITE) {
+    NodeInfo& NI = nodeData[N];
+    acquireNode(N, mflag);
+    return NI.getData();
+  }
+
+  edge_data_reference getEdgeData(edge_iterator ni,
+                                  MethodFlag = MethodFlag::UNPROTECTED) {
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(edge_iterator ni) { return edgeDst[*ni]; }
+
+  //! Number of out edges of N
+  uint64_t getDegree(GraphNode N) const { return edgeDegree[N]; }
+
+  const GraphNode* edge_dst_begin(GraphNode N) const {
+    return edgeDst.data() + *raw_begin(N);
+  }
+
+  const GraphNode* edge_dst_end(GraphNode N) const {
+    return edgeDst.data() + *raw_end(N);
+  }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+
+  //! Number of edge slots in use, including slack and holes
+  size_t sizeArena() const { return arenaUsed; }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+
+  local_iterator local_end() {
+    return local_iterator(this->localEnd(numNodes));
+  }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    if (galois::runtime::shouldLock(mflag)) {
+      for (edge_iterator ii = raw_begin(N), ee = raw_end(N); ii != ee; ++ii) {
+        acquireNode(edgeDst[*ii], mflag);
+      }
+    }
+    return raw_begin(N);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return raw_end(N);
+  }
+
+  edge_iterator findEdge(GraphNode N1, GraphNode N2) {
+    return std::find_if(edge_begin(N1), edge_end(N1),
+                        [=](edge_iterator e) { return getEdgeDst(e) == N2; });
+  }
+
+  edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) {
+    auto end = edge_end(N1);
+    auto e   = std::lower_bound(
+        edge_begin(N1), end, N2,
+        [=](edge_iterator e, GraphNode N) { return getEdgeDst(e) < N; });
+    return (e != end && getEdgeDst(e) == N2) ? e : end;
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return edges(N, mflag);
+  }
+
+  /**
+   * Sorts all outgoing edges of all nodes in parallel by destination. The
+   * order is kept by later updates, so findEdgeSortedByDst stays valid.
+   */
+  void sortAllEdgesByDst() {
+    typedef EdgeSortValue<GraphNode, EdgeTy> EdgeSortVal;
+    galois::do_all(galois::iterate(*this),
+                   [=](GraphNode N) {
+                     std::sort(edge_sort_begin(N), edge_sort_end(N),
+                               [=](const EdgeSortVal& e1,
+                                   const EdgeSortVal& e2) {
+                                 return e1.dst < e2.dst;
+                               });
+                   },
+                   galois::no_stats(), galois::steal());
+    sortedByDst = true;
+  }
+
+  //! @returns true if the edges of every node are sorted by destination
+  bool isSortedByDst() const { return sortedByDst; }
+
+  /**
+   * Compacts automatically after applyBatch once holes left by moved blocks
+   * exceed this fraction of the used arena. A value of 0 or less disables
+   * automatic compaction.
+   */
+  void setCompactionThreshold(double fraction) {
+    compactionThreshold = fraction;
+  }
+
+  /**
+   * Deletes and then inserts a batch of edges in parallel. A deletion
+   * removes every edge from its source to its destination; deleting a
+   * missing edge does nothing. Inserted edges may duplicate existing ones.
+   * Dies if an endpoint of an update is not a node of the graph. Cannot be
+   * called during parallel execution.
+   *
+   * @param insertions edges to add; reordered by the call
+   * @param deletions edges to remove; reordered by the call
+   */
+  void applyBatch(std::vector<EdgeUpdate>& insertions,
+                  std::vector<EdgeDeletion>& deletions) {
+    galois::StatTimer timer("TIMER_GRAPH_APPLY_BATCH");
+    timer.start();
+    checkEndpoints(insertions, [](const EdgeUpdate& u) { return u.src; },
+                   [](const EdgeUpdate& u) { return u.dst; });
+    checkEndpoints(deletions, [](const EdgeDeletion& d) { return d.first; },
+                   [](const EdgeDeletion& d) { return d.second; });
+    if (!deletions.empty())
+      applyDeletions(deletions);
+    if (!insertions.empty())
+      applyInsertions(insertions);
+    timer.stop();
+
+    if (compactionThreshold > 0 &&
+        arenaHoles > compactionThreshold * arenaUsed)
+      compact();
+  }
+
+  //! Inserts a batch of edges; see applyBatch
+  void insertEdges(std::vector<EdgeUpdate>& insertions) {
+    std::vector<EdgeDeletion> none;
+    applyBatch(insertions, none);
+  }
+
+  //! Deletes a batch of edges; see applyBatch
+  void deleteEdges(std::vector<EdgeDeletion>& deletions) {
+    std::vector<EdgeUpdate> none;
+    applyBatch(none, deletions);
+  }
+
+  /**
+   * Rebuilds the arena without holes, giving every node
+   * degree / compactionSlack free slots. Cannot be called during parallel
+   * execution.
+   */
+  void compact() {
+    galois::StatTimer timer("TIMER_GRAPH_COMPACT");
+    timer.start();
+
+    EdgeIndData newBegin;
+    allocate(newBegin, numNodes);
+    galois::do_all(galois::iterate((uint64_t)0, numNodes),
+                   [&](uint64_t n) {
+                     newBegin[n] = edgeDegree[n] +
+                                   edgeDegree[n] / compactionSlack;
+                   },
+                   galois::no_stats(), galois::loopname("COMPACT_CAPACITY"));
+    galois::ParallelSTL::partial_sum(newBegin.begin(), newBegin.end(),
+                                     newBegin.begin());
+    uint64_t used = numNodes ? newBegin[numNodes - 1] : 0;
+    uint64_t size = withReserve(used);
+
+    EdgeDst newDst;
+    EdgeData newData;
+    allocate(newDst, size);
+    allocate(newData, size);
+    galois::do_all(galois::iterate((uint64_t)0, numNodes),
+                   [&](uint64_t n) {
+                     uint64_t end   = newBegin[n];
+                     uint64_t begin = n ? newBegin[n - 1] : 0;
+                     for (uint64_t i = 0; i < edgeDegree[n]; ++i)
+                       copyEdge(newDst, newData, begin + i, edgeBegin[n] + i);
+                     edgeCapacity[n] = end - begin;
+                   },
+                   galois::steal(), galois::no_stats(),
+                   galois::loopname("COMPACT_COPY"));
+
+    // newBegin holds block ends; shift to block begins
+    galois::do_all(galois::iterate((uint64_t)0, numNodes),
+                   [&](uint64_t n) {
+                     edgeBegin[n] = newBegin[n] - edgeCapacity[n];
+                   },
+                   galois::no_stats(), galois::loopname("COMPACT_BEGIN"));
+
+    swap(edgeDst, newDst);
+    swap(edgeData, newData);
+    arenaSize  = size;
+    arenaUsed  = used;
+    arenaHoles = 0;
+    timer.stop();
+  }
+
+  void allocateFrom(FileGraph& graph) {
+    allocateFrom(graph.size(), graph.sizeEdges());
+  }
+
+  void allocateFrom(uint32_t nNodes, uint64_t nEdges) {
+    numNodes   = nNodes;
+    numEdges   = nEdges;
+    arenaUsed  = nEdges;
+    arenaSize  = withReserve(nEdges);
+    arenaHoles = 0;
+    allocate(nodeData, numNodes);
+    allocate(edgeBegin, numNodes);
+    allocate(edgeDegree, numNodes);
+    allocate(edgeCapacity, numNodes);
+    allocate(edgeDst, arenaSize);
+    allocate(edgeData, arenaSize);
+    if (UseNumaAlloc)
+      this->outOfLineAllocateBlocked(numNodes);
+    else
+      this->outOfLineAllocateInterleaved(numNodes);
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total) {
+    auto r = graph
+                 .divideByNode(NodeData::size_of::value +
+                                   EdgeIndData::size_of::value +
+                                   2 * EdgeCountData::size_of::value +
+                                   LC_Dynamic_Graph::size_of_out_of_line::value,
+                               EdgeDst::size_of::value +
+                                   EdgeData::size_of::value,
+                               tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      nodeData.constructAt(*ii);
+      this->outOfLineConstructAt(*ii);
+      uint64_t begin     = *graph.edge_begin(*ii);
+      uint64_t end       = *graph.edge_end(*ii);
+      edgeBegin[*ii]     = begin;
+      edgeDegree[*ii]    = end - begin;
+      edgeCapacity[*ii]  = end - begin;
+
+      for (FileGraph::edge_iterator nn = graph.edge_begin(*ii),
+                                    en = graph.edge_end(*ii);
+           nn != en; ++nn) {
+        constructEdgeValue(graph, nn);
+        edgeDst[*nn] = graph.getEdgeDst(nn);
+      }
+    }
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -23,7 +23,9 @@
 #include "galois/Galois.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/Details.h"
+#include "galois/graphs/DirectFileReader.h"
 #include "galois/Timer.h"
+#include "galois/substrate/EnvCheck.h"
 
 namespace galois {
 namespace graphs {
@@ -47,6 +49,58 @@ void readGraphDispatch(GraphTy& graph, read_default_graph_tag tag,
   readGraphDispatch(graph, tag, f);
 }
 
+/**
+ * Reads the file directly into the graph unless GALOIS_GRAPH_MMAP_LOAD is
+ * set or the file is not a version 1 .gr file, in which case the file is
+ * mapped with FileGraph as for read_default_graph_tag.
+ */
+template <typename GraphTy>
+void readStreamGraph(GraphTy& graph, const std::string& filename) {
+  static const bool useMmap =
+      galois::substrate::EnvCheck("GALOIS_GRAPH_MMAP_LOAD");
+
+  if (!useMmap) {
+    DirectFileReader reader(filename);
+    uint64_t version = 0;
+    if (reader.size() >= sizeof(version)) {
+      reader.read(&version, 0, sizeof(version));
+    }
+    if (convert_le64toh(version) == 1) {
+      graph.readGraphFromGRFile(reader);
+      return;
+    }
+  }
+
+  readGraphDispatch(graph, read_default_graph_tag(), filename);
+}
+
+/**
+ * Reads the file with readStreamGraph. If GALOIS_GRAPH_SNAPSHOT_DIR names a
+ * directory on a memory file system (e.g., /dev/shm or a hugetlbfs mount),
+ * the topology is instead mapped from a snapshot there when one is up to
+ * date; otherwise the graph is read and a snapshot is published for later
+ * processes.
+ */
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_stream_graph_tag,
+                       const std::string& filename) {
+  static const std::string snapshotDir = []() {
+    std::string dir;
+    galois::substrate::EnvCheck("GALOIS_GRAPH_SNAPSHOT_DIR", dir);
+    return dir;
+  }();
+  if (!snapshotDir.empty()) {
+    std::string path = GraphTy::snapshotPath(snapshotDir, filename);
+    if (graph.attachSnapshot(path, filename)) {
+      return;
+    }
+    readStreamGraph(graph, filename);
+    graph.publishSnapshot(path, filename);
+    return;
+  }
+  readStreamGraph(graph, filename);
+}
+
 template <typename GraphTy>
 struct ReadGraphConstructFrom {
   GraphTy& graph;
@@ -25,6 +25,7 @@
 
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/substrate/Barrier.h"
 #include "galois/substrate/PerThreadStorage.h"
@@ -32,12 +33,22 @@
 #include "galois/substrate/ThreadPool.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/substrate/CompilerSpecific.h"
+#include "galois/substrate/EnvCheck.h"
+
+#include <atomic>
+#include <limits>
 
 namespace galois {
 namespace runtime {
 
 namespace internal {
 
+//! Set GALOIS_DO_ALL_LOCKED_STEAL to use the mutex-guarded ranges in do_all
+inline bool useLockedStealing() {
+  static const bool locked = substrate::EnvCheck("GALOIS_DO_ALL_LOCKED_STEAL");
+  return locked;
+}
+
 template <typename R, typename F, typename ArgsTuple>
 class DoAllStealingExec {
 
@@ -52,6 +63,22 @@ class DoAllStealingExec {
       NEED_STATS && exists_by_supertype<more_stats_tag, ArgsTuple>::value;
   constexpr static const bool USE_TERM = false;
 
+  //! Local ranges are random access subranges of [range.begin(),
+  //! range.end()), so they can be described by offsets into it
+  constexpr static const bool HAS_OFFSETS =
+      std::is_same<typename R::iterator, Iter>::value &&
+      std::is_base_of<
+          std::random_access_iterator_tag,
+          typename std::iterator_traits<Iter>::iterator_category>::value;
+
+  /**
+   * Per-thread range of remaining work.
+   *
+   * In lock-free mode the range is kept as a pair of 32-bit offsets from the
+   * beginning of the whole iteration range packed into one word: the owner
+   * takes chunks from the front and thieves split off the back, each with a
+   * single CAS. Otherwise the range is guarded by work_mutex.
+   */
   struct ThreadContext {
 
     GALOIS_ATTRIBUTE_ALIGN_CACHE_LINE substrate::SimpleLock work_mutex;
@@ -60,20 +87,45 @@ class DoAllStealingExec {
     Iter shared_beg;
     Iter shared_end;
     Diff_ty m_size;
-    size_t num_iter;
+
+    bool lockFree;
+    Iter base;
+    std::atomic<uint64_t> offsets;
 
     // Stats
+    size_t num_iter;
+    size_t num_steal_attempts;
+    size_t num_steals;
 
     ThreadContext()
         : work_mutex(),
           id(substrate::getThreadPool()
                  .getMaxThreads()), // TODO: fix this initialization problem,
                                     // see initThread
-          shared_beg(), shared_end(), m_size(0), num_iter(0) {}
+          shared_beg(), shared_end(), m_size(0), lockFree(false), base(),
+          offsets(0), num_iter(0), num_steal_attempts(0), num_steals(0) {}
+
+    void init(unsigned _id, Iter beg, Iter end, bool _lockFree, Iter _base) {
+      id         = _id;
+      shared_beg = beg;
+      shared_end = end;
+      m_size     = std::distance(beg, end);
+      lockFree   = _lockFree;
+      base       = _base;
+      if (lockFree) {
+        offsets.store(pack(std::distance(base, beg), std::distance(base, end)),
+                      std::memory_order_relaxed);
+      }
+      num_iter           = 0;
+      num_steal_attempts = 0;
+      num_steals         = 0;
+    }
 
-    ThreadContext(unsigned id, Iter beg, Iter end)
-        : work_mutex(), id(id), shared_beg(beg), shared_end(end),
-          m_size(std::distance(beg, end)), num_iter(0) {}
+    static uint64_t pack(uint64_t beg, uint64_t end) {
+      return (end << 32) | beg;
+    }
+    static uint64_t unpackBeg(uint64_t off) { return off & 0xFFFFFFFFul; }
+    static uint64_t unpackEnd(uint64_t off) { return off >> 32; }
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -96,9 +148,19 @@ class DoAllStealingExec {
       return didwork;
     }
 
-    bool hasWorkWeak() const { return (m_size > 0); }
+    bool hasWorkWeak() const {
+      if (lockFree) {
+        uint64_t off = offsets.load(std::memory_order_relaxed);
+        return unpackBeg(off) < unpackEnd(off);
+      }
+      return (m_size > 0);
+    }
 
     bool hasWork() const {
+      if (lockFree) {
+        return hasWorkWeak();
+      }
+
       bool ret = false;
 
       work_mutex.lock();
@@ -115,7 +177,31 @@ class DoAllStealingExec {
     }
 
   private:
+    bool getWorkLockFree(Iter& priv_beg, Iter& priv_end,
+                         const unsigned chunk_size) {
+      uint64_t off = offsets.load(std::memory_order_acquire);
+      while (true) {
+        uint64_t beg = unpackBeg(off);
+        uint64_t end = unpackEnd(off);
+        if (beg >= end) {
+          return false;
+        }
+
+        uint64_t nbeg = std::min(beg + chunk_size, end);
+        if (offsets.compare_exchange_weak(off, pack(nbeg, end),
+                                          std::memory_order_acq_rel)) {
+          priv_beg = std::next(base, beg);
+          priv_end = std::next(base, nbeg);
+          return true;
+        }
+      }
+    }
+
     bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
+      if (lockFree) {
+        return getWorkLockFree(priv_beg, priv_end, chunk_size);
+      }
+
       bool succ = false;
 
       work_mutex.lock();
@@ -175,9 +261,41 @@ class DoAllStealingExec {
       steal_end = shared_beg;
     }
 
+    bool stealWorkLockFree(Iter& steal_beg, Iter& steal_end,
+                           Diff_ty& steal_size, StealAmt amount,
+                           size_t chunk_size) {
+      uint64_t off = offsets.load(std::memory_order_acquire);
+      uint64_t beg = unpackBeg(off);
+      uint64_t end = unpackEnd(off);
+      if (beg >= end) {
+        return false;
+      }
+
+      uint64_t size = end - beg;
+      uint64_t amt  = (amount == HALF && size > chunk_size) ? size / 2 : size;
+
+      // one attempt only, like try_lock in the locked version; split from
+      // the back so the owner keeps streaming through its front
+      uint64_t nend = end - amt;
+      if (!offsets.compare_exchange_strong(off, pack(beg, nend),
+                                           std::memory_order_acq_rel)) {
+        return false;
+      }
+
+      steal_beg  = std::next(base, nend);
+      steal_end  = std::next(base, end);
+      steal_size = amt;
+      return true;
+    }
+
   public:
     bool stealWork(Iter& steal_beg, Iter& steal_end, Diff_ty& steal_size,
                    StealAmt amount, size_t chunk_size) {
+      if (lockFree) {
+        return stealWorkLockFree(steal_beg, steal_end, steal_size, amount,
+                                 chunk_size);
+      }
+
       bool succ = false;
 
       if (work_mutex.try_lock()) {
@@ -215,6 +333,16 @@ class DoAllStealingExec {
     }
 
     void assignWork(const Iter& beg, const Iter& end, const Diff_ty sz) {
+      if (lockFree) {
+        // only the owner installs work, and only into an empty range, which
+        // thieves never modify
+        assert(!hasWorkWeak());
+        assert(beg != end);
+        offsets.store(pack(std::distance(base, beg), std::distance(base, end)),
+                      std::memory_order_release);
+        return;
+      }
+
       work_mutex.lock();
       {
         assert(!hasWorkWeak());
@@ -246,6 +374,13 @@ private:
     bool succ =
         rich.stealWork(steal_beg, steal_end, steal_size, amount, chunk_size);
 
+    if (NEED_STATS) {
+      ++poor.num_steal_attempts;
+      if (succ) {
+        ++poor.num_steals;
+      }
+    }
+
     if (succ) {
       assert(steal_beg != steal_end);
       assert(std::distance(steal_beg, steal_end) == steal_size);
@@ -418,11 +553,34 @@ private:
     // }
   }
 
+  template <bool B = HAS_OFFSETS>
+  Iter globalBegin(typename std::enable_if<B>::type* = 0) const {
+    return range.begin();
+  }
+
+  template <bool B = HAS_OFFSETS>
+  Iter globalBegin(typename std::enable_if<!B>::type* = 0) const {
+    return Iter();
+  }
+
+  template <bool B = HAS_OFFSETS>
+  bool canUseLockFree(typename std::enable_if<B>::type* = 0) const {
+    return !useLockedStealing() &&
+           std::distance(range.begin(), range.end()) <
+               (Diff_ty)std::numeric_limits<uint32_t>::max();
+  }
+
+  template <bool B = HAS_OFFSETS>
+  bool canUseLockFree(typename std::enable_if<!B>::type* = 0) const {
+    return false;
+  }
+
 private:
   R range;
   F func;
   const char* loopname;
   Diff_ty chunk_size;
+  bool lockFree;
   substrate::PerThreadStorage<ThreadContext> workers;
 
   substrate::TerminationDetection& term;
@@ -433,16 +591,18 @@ private:
   PerThreadTimer<MORE_STATS> execTime;
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
+  PerThreadPerfCounters<NEED_STATS> perfCounters;
 
 public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
       : range(_range), func(_func),
         loopname(galois::internal::getLoopName(argsTuple)),
         chunk_size(get_by_supertype<chunk_size_tag>(argsTuple).value),
+        lockFree(canUseLockFree()),
         term(substrate::getSystemTermination(activeThreads)),
         totalTime(loopname, "Total"), initTime(loopname, "Init"),
         execTime(loopname, "Execute"), stealTime(loopname, "Steal"),
-        termTime(loopname, "Term") {
+        termTime(loopname, "Term"), perfCounters(loopname) {
     assert(chunk_size > 0);
     // std::printf ("DoAllStealingExec loopname: %s, work size: %ld, chunk_size:
     // %u\n", loopname, std::distance(range.begin (), range.end ()),
@@ -457,8 +617,8 @@ public:
 
     unsigned id = substrate::ThreadPool::getTID();
 
-    *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+    workers.getLocal(id)->init(id, range.local_begin(), range.local_end(),
+                               lockFree, globalBegin());
 
     initTime.stop();
   }
@@ -479,6 +639,7 @@ public:
 
     ThreadContext& ctx = *workers.getLocal();
     totalTime.start();
+    perfCounters.start();
 
     while (true) {
       bool workHappened = false;
@@ -519,11 +680,15 @@ public:
       }
     }
 
+    perfCounters.stop();
     totalTime.stop();
     assert(!ctx.hasWork());
 
     if (NEED_STATS) {
       galois::runtime::reportStat_Tsum(loopname, "Iterations", ctx.num_iter);
+      galois::runtime::reportStat_Tsum(loopname, "StealAttempts",
+                                       ctx.num_steal_attempts);
+      galois::runtime::reportStat_Tsum(loopname, "Steals", ctx.num_steals);
     }
   }
 };
@@ -550,20 +715,23 @@ struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
 
-    runtime::on_each_gen(
-        [&](const unsigned tid, const unsigned numT) {
-          static constexpr bool NEED_STATS =
-              galois::internal::NeedStats<ArgsT>::value;
-          static constexpr bool MORE_STATS =
-              NEED_STATS && exists_by_supertype<more_stats_tag, ArgsT>::value;
+    static constexpr bool NEED_STATS =
+        galois::internal::NeedStats<ArgsT>::value;
+    static constexpr bool MORE_STATS =
+        NEED_STATS && exists_by_supertype<more_stats_tag, ArgsT>::value;
 
-          const char* const loopname = galois::internal::getLoopName(argsTuple);
+    const char* const loopname = galois::internal::getLoopName(argsTuple);
 
+    PerThreadPerfCounters<NEED_STATS> perfCounters(loopname);
+
+    runtime::on_each_gen(
+        [&](const unsigned tid, const unsigned numT) {
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
 
           totalTime.start();
+          perfCounters.start();
           initTime.start();
 
           auto begin     = range.local_begin();
@@ -583,6 +751,7 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          perfCounters.stop();
           totalTime.stop();
 
           if (NEED_STATS) {
@@ -623,6 +792,79 @@ void do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
   timer.stop();
 }
 
+namespace internal {
+
+//! Applies phase I and the following ones to [begin, end)
+template <size_t I, size_t N>
+struct DoAllPhases {
+  template <bool NEED_STATS, typename Iter, typename Fns>
+  static void go(Iter begin, Iter end, Fns& fns, substrate::Barrier* barrier,
+                 size_t& iter) {
+    for (Iter ii = begin; ii != end; ++ii) {
+      std::get<I>(fns)(*ii);
+      if (NEED_STATS) {
+        ++iter;
+      }
+    }
+    if (barrier && I + 1 < N)
+      barrier->wait();
+    DoAllPhases<I + 1, N>::template go<NEED_STATS>(begin, end, fns, barrier,
+                                                   iter);
+  }
+};
+
+template <size_t N>
+struct DoAllPhases<N, N> {
+  template <bool NEED_STATS, typename Iter, typename Fns>
+  static void go(Iter, Iter, Fns&, substrate::Barrier*, size_t&) {}
+};
+
+} // end namespace internal
+
+template <typename R, typename Fns, typename ArgsTuple>
+void do_all_phases_gen(const R& range, Fns& fns, const ArgsTuple& argsTuple) {
+
+  static_assert(!exists_by_supertype<char*, ArgsTuple>::value, "old loopname");
+  static_assert(!exists_by_supertype<char const*, ArgsTuple>::value,
+                "old loopname");
+  static_assert(!exists_by_supertype<steal_tag, ArgsTuple>::value,
+                "phases need a static assignment of items to threads");
+
+  static constexpr bool NEED_STATS =
+      galois::internal::NeedStats<ArgsTuple>::value;
+  static constexpr bool BARRIER =
+      !exists_by_supertype<no_phase_barrier_tag, ArgsTuple>::value;
+  constexpr bool TIME_IT = exists_by_supertype<loopname_tag, ArgsTuple>::value;
+
+  const char* const loopname = galois::internal::getLoopName(argsTuple);
+  CondStatTimer<TIME_IT> timer(loopname);
+  PerThreadPerfCounters<NEED_STATS> perfCounters(loopname);
+  substrate::Barrier* barrier = BARRIER ? &getBarrier(activeThreads) : nullptr;
+
+  timer.start();
+
+  runtime::on_each_gen(
+      [&](const unsigned, const unsigned) {
+        perfCounters.start();
+
+        // the same block of the range in every phase
+        auto begin     = range.local_begin();
+        const auto end = range.local_end();
+        size_t iter    = 0;
+        internal::DoAllPhases<0, std::tuple_size<Fns>::value>::template go<
+            NEED_STATS>(begin, end, fns, barrier, iter);
+
+        perfCounters.stop();
+
+        if (NEED_STATS) {
+          galois::runtime::reportStat_Tsum(loopname, "Iterations", iter);
+        }
+      },
+      std::make_tuple());
+
+  timer.stop();
+}
+
 } // end namespace runtime
 } // end namespace galois
 
@@ -32,6 +32,7 @@
 #include "galois/runtime/Range.h"
 #include "galois/runtime/LoopStatistics.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/substrate/Termination.h"
 #include "galois/substrate/ThreadPool.h"
@@ -196,6 +197,7 @@ protected:
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
+  PerThreadPerfCounters<needStats> perfCounters;
 
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
@@ -363,7 +365,7 @@ protected:
         barrier(getBarrier(activeThreads)), wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f), loopname(galois::internal::getLoopName(args)),
         broke(false), initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"), perfCounters(loopname) {}
 
   template <typename WArgsTy, int... Is>
   ForEachExecutor(T1, FunctionTy f, const ArgsTy& args,
@@ -399,6 +401,9 @@ public:
   void operator()() {
     bool isLeader   = substrate::ThreadPool::isLeader();
     bool couldAbort = needsAborts && activeThreads > 1;
+    worklists::internal::ChunkStealCounts steals =
+        worklists::internal::chunkStealCounts();
+    perfCounters.start();
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -407,6 +412,18 @@ public:
       go<false, true>();
     else
       go<false, false>();
+    perfCounters.stop();
+    if (needStats)
+      reportSteals(steals);
+  }
+
+  //! Reports the chunks this thread took from chunked worklists in this loop
+  void reportSteals(const worklists::internal::ChunkStealCounts& before) {
+    auto& now = worklists::internal::chunkStealCounts();
+    if (now.local == before.local && now.remote == before.remote)
+      return;
+    reportStat_Tsum(loopname, "LocalChunks", now.local - before.local);
+    reportStat_Tsum(loopname, "RemoteSteals", now.remote - before.remote);
   }
 };
 
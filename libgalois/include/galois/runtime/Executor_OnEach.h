@@ -24,6 +24,7 @@
 #include "galois/Traits.h"
 #include "galois/Timer.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/Threads.h"
 #include "galois/gIO.h"
@@ -53,6 +54,7 @@ inline void on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   CondStatTimer<NEEDS_STATS> timer(loopname);
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
+  PerThreadPerfCounters<NEEDS_STATS> perfCounters(loopname);
 
   const auto numT = getActiveThreads();
 
@@ -60,9 +62,11 @@ inline void on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
 
   auto runFun = [&] {
     execTime.start();
+    perfCounters.start();
 
     fn_ref(substrate::ThreadPool::getTID(), numT);
 
+    perfCounters.stop();
     execTime.stop();
   };
 
@@ -0,0 +1,116 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file PerfCounters.h
+ *
+ * Per-thread hardware counters for named loops using Linux perf_event_open.
+ * Counting is off unless the environment variable GALOIS_PERF_COUNTERS is
+ * set; each thread of a loop with stats then reports Cycles, Instructions,
+ * LLCMisses and DTLBMisses (summed over threads) under the loop name.
+ */
+
+#ifndef GALOIS_RUNTIME_PERFCOUNTERS_H
+#define GALOIS_RUNTIME_PERFCOUNTERS_H
+
+#include "galois/substrate/PerThreadStorage.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace galois {
+namespace runtime {
+
+//! Number of hardware events counted
+const unsigned numPerfEvents = 4;
+
+//! Counter values of one thread at one point in time
+struct PerfSample {
+  uint64_t value[numPerfEvents];
+  //! time the counters were enabled and actually counting; these differ when
+  //! the kernel multiplexes counters
+  uint64_t enabled;
+  uint64_t running;
+  //! bit i is set if value[i] was read
+  uint32_t counted;
+};
+
+//! @returns true if GALOIS_PERF_COUNTERS is set
+bool perfCountersRequested();
+
+/**
+ * Reads the counters of the calling thread, opening them on first use.
+ *
+ * @returns false if counters are not requested or cannot be opened or read;
+ * sample.counted is then 0
+ */
+bool readPerfCounters(PerfSample& sample);
+
+/**
+ * Reports the events counted between two samples of the calling thread. An
+ * event missing from either sample is reported as <event>Unavailable instead
+ * of a count.
+ */
+void reportPerfCounters(const char* region, const PerfSample& begin,
+                        const PerfSample& end);
+
+/**
+ * Counts hardware events of each thread between start and stop and reports
+ * them under region.
+ */
+template <bool enabled>
+class PerThreadPerfCounters : private boost::noncopyable {
+  const char* const region;
+  //! only allocated when counting, so loops pay nothing otherwise
+  std::unique_ptr<substrate::PerThreadStorage<PerfSample>> begin;
+
+public:
+  explicit PerThreadPerfCounters(const char* const _region) : region(_region) {
+    if (perfCountersRequested())
+      begin.reset(new substrate::PerThreadStorage<PerfSample>());
+  }
+
+  void start(void) {
+    if (begin)
+      readPerfCounters(*begin->getLocal());
+  }
+
+  void stop(void) {
+    PerfSample end;
+    if (begin && readPerfCounters(end))
+      reportPerfCounters(region, *begin->getLocal(), end);
+  }
+};
+
+template <>
+class PerThreadPerfCounters<false> {
+public:
+  explicit PerThreadPerfCounters(const char* const) {}
+
+  void start(void) const {}
+
+  void stop(void) const {}
+};
+
+} // namespace runtime
+} // namespace galois
+
+#endif
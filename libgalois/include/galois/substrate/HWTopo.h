@@ -46,6 +46,10 @@ struct machineTopoInfo {
 std::pair<machineTopoInfo, std::vector<threadTopoInfo>> getHWTopo();
 // bind a thread to a hwContext (returned by getHWTopo)
 bool bindThreadSelf(unsigned osContext);
+// relative cost of accessing memory of numa node osNodeB from osNodeA (OS ids,
+// as in threadTopoInfo::osNumaNode); 10 is local access.  Falls back to 10 for
+// the same node and 20 otherwise when the OS does not report distances
+unsigned getNumaDistance(unsigned osNodeA, unsigned osNodeB);
 
 } // end namespace substrate
 } // end namespace galois
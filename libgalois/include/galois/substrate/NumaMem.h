@@ -20,6 +20,8 @@
 #ifndef GALOIS_SUBSTRATE_NUMAMEM
 #define GALOIS_SUBSTRATE_NUMAMEM
 
+#include "galois/substrate/PageAlloc.h"
+
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -29,24 +31,34 @@ namespace substrate {
 
 namespace internal {
 struct largeFreer {
-  size_t bytes;
+  size_t bytes       = 0;
+  PageBacking backing = PageBacking::Base;
   void operator()(void* ptr) const;
 };
 } // namespace internal
 
 typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 
-LAptr largeMallocLocal(size_t bytes);    // fault in locally
-LAptr largeMallocFloating(size_t bytes); // leave numa mapping undefined
+// The page backing obtained is available from LAptr::get_deleter().backing
+
+// fault in locally
+LAptr largeMallocLocal(size_t bytes,
+                       HugePagePolicy policy = HugePagePolicy::Default);
+// leave numa mapping undefined
+LAptr largeMallocFloating(size_t bytes,
+                          HugePagePolicy policy = HugePagePolicy::Default);
 // fault in interleaved mapping
-LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads);
+LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads,
+                             HugePagePolicy policy = HugePagePolicy::Default);
 // fault in block interleaved mapping
-LAptr largeMallocBlocked(size_t bytes, unsigned numThreads);
+LAptr largeMallocBlocked(size_t bytes, unsigned numThreads,
+                         HugePagePolicy policy = HugePagePolicy::Default);
 
 // fault in specified regions for each thread (threadRanges)
 template <typename RangeArrayTy>
 LAptr largeMallocSpecified(size_t bytes, uint32_t numThreads,
-                           RangeArrayTy& threadRanges, size_t elementSize);
+                           RangeArrayTy& threadRanges, size_t elementSize,
+                           HugePagePolicy policy = HugePagePolicy::Default);
 
 } // namespace substrate
 } // namespace galois
@@ -21,6 +21,7 @@
 #define GALOIS_SUBSTRATE_PAGEALLOC_H
 
 #include <cstddef>
+#include <string>
 
 namespace galois {
 namespace substrate {
@@ -34,6 +35,54 @@ void* allocPages(unsigned num, bool preFault);
 // free page range
 void freePages(void* ptr, unsigned num);
 
+//! Pages to back large allocations with. Each policy falls back to smaller
+//! pages when its pages are unavailable.
+enum class HugePagePolicy {
+  Default, //!< set by GALOIS_HUGE_PAGES=1G|2M|THP|none; 2M if unset
+  Huge1G,  //!< 1 GB hugetlb pages, then Huge2M
+  Huge2M,  //!< 2 MB hugetlb pages, then THP
+  THP,     //!< transparent huge pages requested with madvise, then base pages
+  None     //!< base pages
+};
+
+//! Backing actually obtained for a large allocation
+enum class PageBacking { Huge1G = 0, Huge2M, THP, Base };
+const unsigned numPageBackings = 4;
+
+//! @returns human readable name of a backing
+const char* pageBackingName(PageBacking backing);
+
+/**
+ * Parses a GALOIS_HUGE_PAGES value (1G, 2M, THP or none).
+ *
+ * @returns false if val names no policy; policy is then unchanged
+ */
+bool parseHugePagePolicy(const std::string& val, HugePagePolicy& policy);
+
+//! @returns policy that HugePagePolicy::Default stands for
+HugePagePolicy defaultHugePagePolicy();
+
+/**
+ * Maps memory for a large allocation according to a page policy.
+ *
+ * @param bytes in: multiple of allocSize() to allocate; out: length of the
+ * mapping, which may be rounded up to the page size obtained
+ * @param policy preferred page size
+ * @param preFault fault the pages in on the calling thread
+ * @param backing out: pages actually obtained
+ */
+void* allocLargePages(size_t& bytes, HugePagePolicy policy, bool preFault,
+                      PageBacking& backing);
+
+//! Unmaps memory returned by allocLargePages
+void freeLargePages(void* ptr, size_t bytes, PageBacking backing);
+
+//! @returns size of a page of the given backing
+size_t pageBackingSize(PageBacking backing);
+
+//! @returns bytes currently mapped by allocLargePages with a backing
+size_t largePageBytes(PageBacking backing);
+
 } // namespace substrate
 } // namespace galois
 
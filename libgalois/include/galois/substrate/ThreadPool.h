@@ -67,9 +67,16 @@ protected:
   struct per_signal {
     std::condition_variable cv;
     std::mutex m;
+    //! threads to wake, as indexes into socketThreads of this socket
     unsigned wbegin, wend;
+    //! sockets to wake (leaders only)
+    unsigned sbegin, send;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    //! rounds of runRounds this thread and its subtree have finished
+    std::atomic<unsigned> arrived;
+    //! rounds of runRounds this thread may start
+    std::atomic<unsigned> released;
     threadTopoInfo topo;
 
     void wakeup(bool fastmode) {
@@ -103,9 +110,17 @@ protected:
   machineTopoInfo mi;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
+  //! per socket, the leaders of the other sockets, nearest first
+  std::vector<std::vector<unsigned>> stealOrder;
+  //! per socket, its threads in increasing order; the leader is first
+  std::vector<std::vector<unsigned>> socketThreads;
+  //! per socket, number of its threads taking part in the current run
+  std::vector<unsigned> socketActive;
   unsigned reserved;
   unsigned masterFastmode;
   bool running;
+  //! set by the master between rounds of runRounds
+  bool moreRounds;
   std::function<void(void)> work;
 
   //! destroy all threads
@@ -114,15 +129,28 @@ protected:
   //! Initialize a thread
   void initThread(unsigned tid);
 
+  //! order the other sockets of each socket by numa distance
+  void computeStealOrder();
+
   //! main thread loop
   void threadLoop(unsigned tid);
 
   //! spin up for run
   void cascade(bool fastmode);
 
+  //! wake the leader of socket pid, which wakes sockets [sbegin, send) next
+  void wakeSocket(unsigned pid, unsigned sbegin, unsigned send, bool fastmode);
+
+  //! children of me in the wakeup tree; returns how many were stored
+  unsigned treeChildren(const per_signal& me, per_signal* children[4]);
+
   //! spin down after run
   void decascade();
 
+  //! body of runRounds on every thread
+  void roundLoop(const std::function<void(unsigned)>& fn,
+                 const std::function<bool(unsigned)>& more);
+
   //! execute work on num threads
   void runInternal(unsigned num);
 
@@ -156,6 +184,18 @@ public:
     runInternal(num);
   }
 
+  /**
+   * Runs fn(round) on num threads for rounds 0, 1, ... in a single run.
+   * Between rounds, threads report to their parent in the wakeup tree; once
+   * all have, the master calls more(round) and the answer travels back down
+   * the same tree, so releasing the barrier of one round is also what
+   * starts the next. A round thus costs one barrier instead of a barrier
+   * plus a dispatch. Rounds end after the first round for which more
+   * returns false.
+   */
+  void runRounds(unsigned num, const std::function<void(unsigned)>& fn,
+                 const std::function<bool(unsigned)>& more);
+
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
@@ -196,6 +236,14 @@ public:
     return signals[tid]->topo.numaNode;
   }
 
+  /**
+   * Leaders of all sockets other than pid, ordered by increasing numa distance
+   * from pid; sockets at the same distance follow pid cyclically.
+   */
+  const std::vector<unsigned>& getStealOrder(unsigned pid) const {
+    return stealOrder[pid];
+  }
+
   static unsigned getTID() { return my_box.topo.tid; }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
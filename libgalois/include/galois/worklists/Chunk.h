@@ -22,10 +22,13 @@
 
 #include "galois/FixedSizeRing.h"
 #include "galois/substrate/PaddedLock.h"
+#include "galois/substrate/ThreadPool.h"
 #include "galois/runtime/Mem.h"
 #include "galois/worklists/WorkListHelpers.h"
 #include "WLCompileCheck.h"
 
+#include <algorithm>
+
 namespace galois {
 namespace runtime {
 extern unsigned activeThreads;
@@ -33,6 +36,18 @@ extern unsigned activeThreads;
 namespace worklists {
 
 namespace internal {
+//! Chunks a thread has taken from the queues of chunked worklists; executors
+//! report the difference over a loop
+struct ChunkStealCounts {
+  size_t local;  //!< popped from the queue of the thread's own socket
+  size_t remote; //!< stolen from the queues of other sockets
+};
+
+inline ChunkStealCounts& chunkStealCounts() {
+  static thread_local ChunkStealCounts counts;
+  return counts;
+}
+
 // This overly complex specialization avoids a pointer indirection for
 // non-distributed WL when accessing PerLevel
 template <bool, template <typename> class PS, typename TQ>
@@ -75,10 +90,14 @@ private:
 
   runtime::FixedSizeAllocator<Chunk> alloc;
 
+  //! upper bound on the chunks taken from another socket at once
+  static const unsigned maxStealBatch = 8;
+
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    unsigned stealBatch;
+    p() : cur(0), next(0), stealBatch(1) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
@@ -107,24 +126,49 @@ private:
     return I.pop();
   }
 
-  Chunk* popChunk() {
-    int id   = Q.myEffectiveID();
-    Chunk* r = popChunkByID(id);
-    if (r)
-      return r;
+  /**
+   * Steals from the other sockets, nearest first. Keeps the first chunk found
+   * and moves up to stealBatch - 1 more from the same victim to the local
+   * socket queue, so the rest of the socket does not go remote again. The
+   * batch doubles when the victim had enough chunks and halves when it ran
+   * dry.
+   */
+  Chunk* stealChunk(p& n) {
+    auto& tp    = substrate::getThreadPool();
+    auto& order = tp.getStealOrder(substrate::ThreadPool::getSocket());
+    for (unsigned victim : order) {
+      if (victim >= runtime::activeThreads)
+        continue;
+      Chunk* r = popChunkByID(victim);
+      if (!r)
+        continue;
+
+      unsigned taken = 1;
+      for (; taken < n.stealBatch; ++taken) {
+        Chunk* c = popChunkByID(victim);
+        if (!c)
+          break;
+        pushChunk(c);
+      }
+      if (taken == n.stealBatch)
+        n.stealBatch = std::min(2 * n.stealBatch, maxStealBatch);
+      else
+        n.stealBatch = std::max(n.stealBatch / 2, 1U);
 
-    for (int i = id + 1; i < (int)Q.size(); ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
+      chunkStealCounts().remote += taken;
+      return r;
     }
+    return 0;
+  }
 
-    for (int i = 0; i < id; ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
+  Chunk* popChunk(p& n) {
+    Chunk* r = popChunkByID(Q.myEffectiveID());
+    if (r) {
+      ++chunkStealCounts().local;
+      return r;
     }
-
+    if (Distributed)
+      return stealChunk(n);
     return 0;
   }
 
@@ -178,7 +222,7 @@ public:
         return &n.next->back();
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next && !n.next->empty())
         return &n.next->back();
       return NULL;
@@ -187,7 +231,7 @@ public:
         return &n.cur->front();
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur  = n.next;
         n.next = 0;
@@ -240,7 +284,7 @@ public:
         return retval;
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next)
         return n.next->extract_back();
       return galois::optional<value_type>();
@@ -249,7 +293,7 @@ public:
         return retval;
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur  = n.next;
         n.next = 0;
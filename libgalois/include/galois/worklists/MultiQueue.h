@@ -0,0 +1,257 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_MULTIQUEUE_H
+#define GALOIS_WORKLIST_MULTIQUEUE_H
+
+#include "galois/runtime/Substrate.h"
+#include "galois/substrate/PaddedLock.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/WorkListHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Relaxed priority scheduling with a MultiQueue (Rihani et al., SPAA'15).
+ * Work is spread over QueuesPerThread * activeThreads sequential binary
+ * heaps, each behind its own lock. A push goes to a random heap; a pop
+ * locks the better of two randomly chosen heaps. No central structure is
+ * shared, so there is nothing to serialize on when the number of distinct
+ * priorities is large, at the cost of popping items that are only
+ * approximately the smallest.
+ *
+ * Indexer has the same meaning as for {@link OrderedByIntegerMetric};
+ * smaller indices are scheduled first. Index must be an integral type.
+ *
+ * \code
+ * typedef galois::worklists::MultiQueue<Indexer> WL;
+ * galois::for_each(galois::iterate(items), Fn, galois::wl<WL>());
+ * \endcode
+ *
+ * @tparam Indexer          Indexer class
+ * @tparam QueuesPerThread  Number of heaps per active thread
+ * @tparam T                Work item type
+ * @tparam Index            Priority type returned by the indexer
+ * @tparam Concurrent       Whether multiple threads may access the worklist
+ */
+template <class Indexer = DummyIndexer<int>, unsigned QueuesPerThread = 4,
+          typename T = int, typename Index = unsigned, bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype =
+      MultiQueue<Indexer, QueuesPerThread, _T,
+                 typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread = MultiQueue<Indexer, QueuesPerThread, T, Index, _b>;
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef MultiQueue<_indexer, QueuesPerThread, T, Index, Concurrent> type;
+  };
+
+  template <unsigned _queues>
+  struct with_queues_per_thread {
+    typedef MultiQueue<Indexer, _queues, T, Index, Concurrent> type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  static_assert(QueuesPerThread > 0, "need at least one queue per thread");
+
+  //! random two-choice pops tried before scanning every heap
+  static const unsigned popAttempts = 8;
+
+  typedef std::pair<Index, T> Entry;
+
+  struct Greater {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.first > b.first;
+    }
+  };
+
+  struct Heap : public substrate::PaddedLock<Concurrent> {
+    std::vector<Entry> items;
+    //! index of the top item and whether there is one, readable without
+    //! holding the lock; top is only meaningful while nonEmpty is set
+    std::atomic<Index> top;
+    std::atomic<bool> nonEmpty;
+
+    Heap() : top(Index()), nonEmpty(false) {}
+
+    bool hasItems() const { return nonEmpty.load(std::memory_order_relaxed); }
+
+    void push(const Entry& e) {
+      items.push_back(e);
+      std::push_heap(items.begin(), items.end(), Greater());
+      top.store(items.front().first, std::memory_order_relaxed);
+      nonEmpty.store(true, std::memory_order_relaxed);
+    }
+
+    T pop() {
+      std::pop_heap(items.begin(), items.end(), Greater());
+      T item = items.back().second;
+      items.pop_back();
+      if (items.empty())
+        nonEmpty.store(false, std::memory_order_relaxed);
+      else
+        top.store(items.front().first, std::memory_order_relaxed);
+      return item;
+    }
+  };
+
+  //! Frees the heap array allocated in the constructor
+  struct HeapDeleter {
+    unsigned num;
+    void operator()(Heap* p) const {
+      for (unsigned i = 0; i < num; ++i)
+        p[i].~Heap();
+      std::free(p);
+    }
+  };
+
+  //! xorshift state; every thread picks heaps independently. PerThreadStorage
+  //! constructs all slots on one thread, so the state is seeded from the
+  //! owning thread on first use.
+  struct Random {
+    uint64_t state = 0;
+    unsigned operator()(unsigned n) {
+      if (!state)
+        state = 0x9E3779B97F4A7C15ull * (substrate::ThreadPool::getTID() + 1);
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state % n;
+    }
+  };
+
+  const unsigned numHeaps;
+  std::unique_ptr<Heap, HeapDeleter> heaps;
+  substrate::PerThreadStorage<Random> rand;
+  Indexer indexer;
+
+  galois::optional<value_type> popFrom(Heap& h) {
+    galois::optional<value_type> item;
+    if (!h.items.empty())
+      item = h.pop();
+    h.unlock();
+    return item;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  galois::optional<value_type> slowPop(Random& r) {
+    // only report empty after seeing every heap empty; otherwise the
+    // executor could terminate while another heap still has work
+    unsigned start = r(numHeaps);
+    for (unsigned i = 0; i < numHeaps; ++i) {
+      Heap& h = heaps.get()[(start + i) % numHeaps];
+      if (!h.hasItems())
+        continue;
+      h.lock();
+      galois::optional<value_type> item = popFrom(h);
+      if (item)
+        return item;
+    }
+    return galois::optional<value_type>();
+  }
+
+  //! Heaps are padded to cache lines, which new[] does not honor before
+  //! C++17, so allocate them aligned by hand
+  static Heap* allocateHeaps(unsigned num) {
+    void* p = nullptr;
+    if (posix_memalign(&p, alignof(Heap), num * sizeof(Heap)))
+      throw std::bad_alloc();
+    Heap* h = static_cast<Heap*>(p);
+    for (unsigned i = 0; i < num; ++i)
+      new (&h[i]) Heap();
+    return h;
+  }
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : numHeaps(QueuesPerThread * (Concurrent ? runtime::activeThreads : 1)),
+        heaps(allocateHeaps(numHeaps), HeapDeleter{numHeaps}), indexer(x) {}
+
+  void push(const value_type& val) {
+    Entry e(indexer(val), val);
+    Random& r = *rand.getLocal();
+    Heap* h;
+    do {
+      h = &heaps.get()[r(numHeaps)];
+    } while (!h->try_lock());
+    h->push(e);
+    h->unlock();
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+  }
+
+  galois::optional<value_type> pop() {
+    Random& r = *rand.getLocal();
+    for (unsigned i = 0; i < popAttempts; ++i) {
+      Heap& a = heaps.get()[r(numHeaps)];
+      Heap& b = heaps.get()[r(numHeaps)];
+      Heap* h;
+      if (!a.hasItems())
+        h = &b;
+      else if (!b.hasItems())
+        h = &a;
+      else
+        h = a.top.load(std::memory_order_relaxed) <=
+                    b.top.load(std::memory_order_relaxed)
+                ? &a
+                : &b;
+      if (!h->hasItems() || !h->try_lock())
+        continue;
+      galois::optional<value_type> item = popFrom(*h);
+      if (item)
+        return item;
+    }
+    return slowPop(r);
+  }
+};
+
+GALOIS_WLCOMPILECHECK(MultiQueue)
+
+} // namespace worklists
+} // namespace galois
+
+#endif
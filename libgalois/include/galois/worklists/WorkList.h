@@ -28,6 +28,7 @@
 #include "Simple.h"
 #include "LocalQueue.h"
 #include "Obim.h"
+#include "MultiQueue.h"
 #include "OrderedList.h"
 #include "OwnerComputes.h"
 #include "StableIterator.h"
@@ -37,7 +38,8 @@ namespace galois {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, {@link PerSocketChunkLIFO} or {@link
  * PerSocketChunkFIFO} is a reasonable scheduling policy. If you need
- * approximate priority scheduling, use {@link OrderedByIntegerMetric}. For
+ * approximate priority scheduling, use {@link OrderedByIntegerMetric}, or
+ * {@link MultiQueue} when there are very many distinct priorities. For
  * debugging, you may be interested in {@link FIFO} or {@link LIFO}, which try
  * to follow serial order exactly.
  *
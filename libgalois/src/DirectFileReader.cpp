@@ -0,0 +1,260 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file DirectFileReader.cpp
+ *
+ * Implementation of DirectFileReader.
+ */
+
+#include "galois/graphs/DirectFileReader.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef GALOIS_USE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace {
+
+//! alignment of offsets, lengths and buffers for O_DIRECT
+const uint64_t directAlign = 4096;
+//! pread transfers at most this many bytes per call on Linux
+const uint64_t maxPread = 1ul << 30;
+
+//! Copies the part of a chunk that overlaps [offset, offset + len) into dst
+//! and returns the number of bytes of the overlap that were available.
+uint64_t copyOverlap(char* dst, uint64_t offset, uint64_t len,
+                     const char* chunk, uint64_t chunkOffset,
+                     uint64_t chunkLen, uint64_t got, uint64_t* needed) {
+  uint64_t beg = std::max(offset, chunkOffset);
+  uint64_t end = std::min(offset + len, chunkOffset + chunkLen);
+  uint64_t have = std::min(end, chunkOffset + got);
+  uint64_t avail = have > beg ? have - beg : 0;
+  *needed        = end - beg;
+  std::memcpy(dst + (beg - offset), chunk + (beg - chunkOffset), avail);
+  return avail;
+}
+
+} // namespace
+
+namespace galois {
+namespace graphs {
+
+DirectFileReader::DirectFileReader(const std::string& filename)
+    : fd(-1), directFd(-1), useDirect(false), fileSize(0) {
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+  }
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1) {
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  }
+  fileSize = buf.st_size;
+
+#ifdef O_DIRECT
+  // some file systems (e.g., tmpfs) refuse O_DIRECT; use buffered reads there
+  directFd  = open(filename.c_str(), O_RDONLY | O_DIRECT);
+  useDirect = directFd != -1;
+#endif
+}
+
+DirectFileReader::~DirectFileReader() {
+  if (directFd != -1)
+    close(directFd);
+  close(fd);
+}
+
+DirectFileReader::BounceBuffer::~BounceBuffer() { free(data); }
+
+//! Returns the calling thread's bounce buffer, grown to at least bytes
+char* DirectFileReader::bounceBuffer(size_t bytes) {
+  BounceBuffer& buf = *buffers.getLocal();
+  if (buf.size < bytes) {
+    free(buf.data);
+    buf.data = nullptr;
+    buf.size = 0;
+    if (posix_memalign(reinterpret_cast<void**>(&buf.data), directAlign,
+                       bytes) != 0) {
+      GALOIS_DIE("failed allocating read buffers");
+    }
+    buf.size = bytes;
+  }
+  return buf.data;
+}
+
+void DirectFileReader::read(void* dst, uint64_t offset, uint64_t len) {
+  if (len == 0)
+    return;
+  if (offset + len > fileSize) {
+    GALOIS_DIE("read of [", offset, ", ", offset + len, ") past end of file (",
+               fileSize, " bytes)");
+  }
+  if (useDirect.load(std::memory_order_relaxed) &&
+      readDirect(static_cast<char*>(dst), offset, len)) {
+    return;
+  }
+  readBuffered(static_cast<char*>(dst), offset, len);
+}
+
+void DirectFileReader::readBuffered(char* dst, uint64_t offset, uint64_t len) {
+  uint64_t done = 0;
+  while (done < len) {
+    ssize_t r = pread(fd, dst + done, std::min(len - done, maxPread),
+                      offset + done);
+    if (r == -1 && errno == EINTR)
+      continue;
+    if (r == -1) {
+      GALOIS_SYS_DIE("failed reading file");
+    }
+    if (r == 0) {
+      GALOIS_DIE("unexpected end of file at offset ", offset + done);
+    }
+    done += r;
+  }
+  // the data now lives in its final location; do not keep a second copy
+  posix_fadvise(fd, offset, len, POSIX_FADV_DONTNEED);
+}
+
+/**
+ * Reads the aligned cover of [offset, offset + len) in chunkSize pieces
+ * through up to queueDepth slots of the thread's bounce buffer. A cover
+ * smaller than one chunk uses a single slot of its own size. Returns false
+ * without reading anything if the file system rejects direct reads.
+ */
+bool DirectFileReader::readDirect(char* dst, uint64_t offset, uint64_t len) {
+  const uint64_t abeg = offset & ~(directAlign - 1);
+  const uint64_t aend =
+      (offset + len + directAlign - 1) & ~(directAlign - 1);
+  const uint64_t numChunks = (aend - abeg + chunkSize - 1) / chunkSize;
+  const uint64_t slotSize  = std::min<uint64_t>(chunkSize, aend - abeg);
+  const unsigned numSlots  = std::min<uint64_t>(numChunks, queueDepth);
+
+  char* raw = bounceBuffer(slotSize * numSlots);
+
+  auto chunkOffset = [&](uint64_t c) { return abeg + c * chunkSize; };
+  auto chunkLength = [&](uint64_t c) {
+    return std::min<uint64_t>(chunkSize, aend - chunkOffset(c));
+  };
+
+  // copies out a completed chunk; falls back to buffered reads for any
+  // bytes a short read did not deliver
+  auto finish = [&](uint64_t c, const char* buf, uint64_t got) {
+    uint64_t needed;
+    uint64_t avail = copyOverlap(dst, offset, len, buf, chunkOffset(c),
+                                 chunkLength(c), got, &needed);
+    if (avail < needed) {
+      uint64_t beg = std::max(offset, chunkOffset(c)) + avail;
+      readBuffered(dst + (beg - offset), beg, needed - avail);
+    }
+  };
+
+#ifdef GALOIS_USE_IO_URING
+  struct io_uring ring;
+  if (io_uring_queue_init(numSlots, &ring, 0) == 0) {
+    uint64_t next     = 0;
+    unsigned inflight = 0;
+    unsigned freeSlots[queueDepth];
+    unsigned numFree = numSlots;
+    for (unsigned i = 0; i < numSlots; ++i)
+      freeSlots[i] = i;
+    // chunk index currently held by each buffer slot
+    uint64_t slotChunk[queueDepth];
+
+    auto submit = [&]() {
+      while (next < numChunks && numFree > 0) {
+        unsigned slot         = freeSlots[--numFree];
+        slotChunk[slot]       = next;
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+        io_uring_prep_read(sqe, directFd, raw + slot * slotSize,
+                           chunkLength(next), chunkOffset(next));
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(uintptr_t(slot)));
+        ++next;
+        ++inflight;
+      }
+      io_uring_submit(&ring);
+    };
+
+    submit();
+    bool rejected = false;
+    while (inflight > 0) {
+      struct io_uring_cqe* cqe;
+      int ret = io_uring_wait_cqe(&ring, &cqe);
+      if (ret < 0) {
+        errno = -ret;
+        GALOIS_SYS_DIE("failed waiting for read completion");
+      }
+      unsigned slot = uintptr_t(io_uring_cqe_get_data(cqe));
+      int res       = cqe->res;
+      io_uring_cqe_seen(&ring, cqe);
+      --inflight;
+
+      if (res == -EINVAL) {
+        rejected = true;
+      } else if (res < 0) {
+        errno = -res;
+        GALOIS_SYS_DIE("failed reading file");
+      } else if (!rejected) {
+        finish(slotChunk[slot], raw + slot * slotSize, res);
+      }
+      freeSlots[numFree++] = slot;
+      if (!rejected)
+        submit();
+    }
+    io_uring_queue_exit(&ring);
+
+    if (rejected) {
+      useDirect.store(false, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+#endif
+
+  for (uint64_t c = 0; c < numChunks; ++c) {
+    ssize_t r;
+    do {
+      r = pread(directFd, raw, chunkLength(c), chunkOffset(c));
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1 && errno == EINVAL && c == 0) {
+      useDirect.store(false, std::memory_order_relaxed);
+      return false;
+    }
+    if (r == -1) {
+      GALOIS_SYS_DIE("failed reading file");
+    }
+    finish(c, raw, r);
+  }
+  return true;
+}
+
+} // namespace graphs
+} // namespace galois
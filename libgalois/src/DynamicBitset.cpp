@@ -16,10 +16,185 @@
  * including but not limited to those resulting from defects in Software and/or
  * Documentation, or loss or inaccuracy of data of any kind.
  */
-
 /**
  * @file DynamicBitset.cpp
  *
- * All the implementation of the DynamicBitSet class incorporated into
- * DynamicBitset.h
+ * Word kernels behind the bulk operations of DynamicBitSet. The AVX2 kernels
+ * are compiled for their instruction set with target attributes and chosen
+ * at startup if the processor supports them.
  */
+
+#include "galois/DynamicBitset.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define GALOIS_BITSET_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+uint64_t countScalar(const uint64_t* words, size_t n) {
+  uint64_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+#ifdef __GNUC__
+    count += __builtin_popcountll(words[i]);
+#else
+    uint64_t x = words[i];
+    x = x - ((x >> 1) & 0x5555555555555555UL);
+    x = (x & 0x3333333333333333UL) + ((x >> 2) & 0x3333333333333333UL);
+    count +=
+        (((x + (x >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+  }
+  return count;
+}
+
+struct Or {
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a | b; }
+};
+struct And {
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a & b; }
+};
+struct Xor {
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a ^ b; }
+};
+struct AndNot {
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a & ~b; }
+};
+
+template <typename Op>
+void binaryScalar(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                  size_t n) {
+  Op op;
+  for (size_t i = 0; i < n; ++i)
+    dst[i] = op(a[i], b[i]);
+}
+
+#ifdef GALOIS_BITSET_X86
+
+// Population count of 4 words at a time: look up the count of each nibble
+// with a shuffle and add up the bytes of each word with a sum of absolute
+// differences against zero.
+__attribute__((target("avx2,popcnt"))) uint64_t
+countAVX2(const uint64_t* words, size_t n) {
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                          2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0f);
+  __m256i total     = _mm256_setzero_si256();
+  size_t i          = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256i v   = _mm256_loadu_si256((const __m256i*)(words + i));
+    __m256i lo  = _mm256_and_si256(v, low);
+    __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                  _mm256_shuffle_epi8(lookup, hi));
+    total =
+        _mm256_add_epi64(total, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+  }
+
+  uint64_t count = _mm256_extract_epi64(total, 0) +
+                   _mm256_extract_epi64(total, 1) +
+                   _mm256_extract_epi64(total, 2) +
+                   _mm256_extract_epi64(total, 3);
+  for (; i < n; ++i)
+    count += __builtin_popcountll(words[i]);
+  return count;
+}
+
+struct OrAVX2 {
+  __attribute__((target("avx2"))) __m256i operator()(__m256i a,
+                                                     __m256i b) const {
+    return _mm256_or_si256(a, b);
+  }
+};
+struct AndAVX2 {
+  __attribute__((target("avx2"))) __m256i operator()(__m256i a,
+                                                     __m256i b) const {
+    return _mm256_and_si256(a, b);
+  }
+};
+struct XorAVX2 {
+  __attribute__((target("avx2"))) __m256i operator()(__m256i a,
+                                                     __m256i b) const {
+    return _mm256_xor_si256(a, b);
+  }
+};
+struct AndNotAVX2 {
+  // _mm256_andnot_si256 negates its first argument
+  __attribute__((target("avx2"))) __m256i operator()(__m256i a,
+                                                     __m256i b) const {
+    return _mm256_andnot_si256(b, a);
+  }
+};
+
+template <typename VecOp, typename Op>
+__attribute__((target("avx2"))) void
+binaryAVX2(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+  VecOp op;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+    __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+    _mm256_storeu_si256((__m256i*)(dst + i), op(va, vb));
+  }
+  binaryScalar<Op>(dst + i, a + i, b + i, n - i);
+}
+
+#endif
+
+typedef uint64_t (*CountFn)(const uint64_t*, size_t);
+typedef void (*BinaryFn)(uint64_t*, const uint64_t*, const uint64_t*, size_t);
+
+struct Kernels {
+  CountFn count;
+  BinaryFn bitOr;
+  BinaryFn bitAnd;
+  BinaryFn bitXor;
+  BinaryFn bitAndNot;
+};
+
+Kernels bestKernels() {
+#ifdef GALOIS_BITSET_X86
+  // may run before the constructor that initializes the cpu model
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return Kernels{countAVX2, binaryAVX2<OrAVX2, Or>, binaryAVX2<AndAVX2, And>,
+                   binaryAVX2<XorAVX2, Xor>, binaryAVX2<AndNotAVX2, AndNot>};
+#endif
+  return Kernels{countScalar, binaryScalar<Or>, binaryScalar<And>,
+                 binaryScalar<Xor>, binaryScalar<AndNot>};
+}
+
+// initialized on first use as bitsets may be used by static constructors
+const Kernels& kernels() {
+  static const Kernels k = bestKernels();
+  return k;
+}
+
+} // namespace
+
+uint64_t galois::internal::bitsetCount(const uint64_t* words, size_t n) {
+  return kernels().count(words, n);
+}
+
+void galois::internal::bitsetOr(uint64_t* dst, const uint64_t* a,
+                                const uint64_t* b, size_t n) {
+  kernels().bitOr(dst, a, b, n);
+}
+
+void galois::internal::bitsetAnd(uint64_t* dst, const uint64_t* a,
+                                 const uint64_t* b, size_t n) {
+  kernels().bitAnd(dst, a, b, n);
+}
+
+void galois::internal::bitsetXor(uint64_t* dst, const uint64_t* a,
+                                 const uint64_t* b, size_t n) {
+  kernels().bitXor(dst, a, b, n);
+}
+
+void galois::internal::bitsetAndNot(uint64_t* dst, const uint64_t* a,
+                                    const uint64_t* b, size_t n) {
+  kernels().bitAndNot(dst, a, b, n);
+}
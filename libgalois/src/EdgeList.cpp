@@ -0,0 +1,173 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+/**
+ * @file EdgeList.cpp
+ *
+ * Implementation of TextFileChunks and writeGRFile.
+ */
+
+#include "galois/graphs/EdgeList.h"
+#include "galois/Endian.h"
+#include "galois/gIO.h"
+
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+//! Largest single write request
+const uint64_t writeChunkSize = 8 * 1024 * 1024;
+
+void writeAll(int fd, const char* src, uint64_t offset, uint64_t len,
+              const std::string& filename) {
+  while (len) {
+    ssize_t n = pwrite(fd, src, std::min(len, writeChunkSize), offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      GALOIS_SYS_DIE("failed writing '", filename, "'");
+    }
+    src += n;
+    offset += n;
+    len -= n;
+  }
+}
+
+//! Writes elements [begin, end) of an array of little endian integers
+template <typename T>
+void writeArray(int fd, const T* arr, uint64_t begin, uint64_t end,
+                uint64_t offset, const std::string& filename) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  writeAll(fd, reinterpret_cast<const char*>(arr + begin),
+           offset + begin * sizeof(T), (end - begin) * sizeof(T), filename);
+#else
+  std::vector<T> buf;
+  for (uint64_t i = begin; i < end; i += writeChunkSize / sizeof(T)) {
+    uint64_t n = std::min<uint64_t>(end - i, writeChunkSize / sizeof(T));
+    buf.resize(n);
+    for (uint64_t j = 0; j < n; ++j)
+      buf[j] = sizeof(T) == 8 ? galois::convert_htole64(arr[i + j])
+                              : galois::convert_htole32(arr[i + j]);
+    writeAll(fd, reinterpret_cast<const char*>(buf.data()),
+             offset + i * sizeof(T), n * sizeof(T), filename);
+  }
+#endif
+}
+
+} // namespace
+
+namespace galois {
+namespace graphs {
+namespace internal {
+
+TextFileChunks::TextFileChunks(const std::string& filename, size_t maxChunks)
+    : base(nullptr), length(0) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    GALOIS_SYS_DIE("failed opening '", filename, "'");
+  }
+  struct stat buf;
+  if (fstat(fd, &buf) == -1) {
+    GALOIS_SYS_DIE("failed reading '", filename, "'");
+  }
+  length = buf.st_size;
+
+  if (length) {
+    void* ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      GALOIS_SYS_DIE("failed mapping '", filename, "'");
+    }
+    base = static_cast<const char*>(ptr);
+    // each thread reads its chunks front to back
+    madvise(ptr, length, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  size_t numChunks = std::max<size_t>(
+      1, std::min<uint64_t>(maxChunks, length / minChunkSize));
+  bounds.push_back(0);
+  for (size_t c = 1; c < numChunks; ++c) {
+    uint64_t pos = std::max(length * c / numChunks, bounds.back());
+    // end each chunk after a line break
+    if (pos > 0 && base[pos - 1] != '\n')
+      pos = nextLine(base + pos, base + length) - base;
+    bounds.push_back(pos);
+  }
+  bounds.push_back(length);
+}
+
+TextFileChunks::~TextFileChunks() {
+  if (base)
+    munmap(const_cast<char*>(base), length);
+}
+
+} // namespace internal
+
+void writeGRFile(const std::string& filename, uint64_t numNodes,
+                 uint64_t numEdges, const uint64_t* edgeIndex,
+                 const uint32_t* edgeDst, const void* edgeData,
+                 size_t sizeofEdgeData) {
+  galois::StatTimer timer("TIMER_GRAPH_WRITE_GR");
+  timer.start();
+
+  const uint64_t idxOffset = 4 * sizeof(uint64_t);
+  const uint64_t dstOffset = idxOffset + numNodes * sizeof(uint64_t);
+  // edge data starts on an 8 byte boundary
+  const uint64_t dataOffset =
+      dstOffset + ((numEdges * sizeof(uint32_t) + 7) & ~uint64_t(7));
+  const uint64_t length = dataOffset + numEdges * sizeofEdgeData;
+
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    GALOIS_SYS_DIE("failed creating '", filename, "'");
+  }
+  // also zero fills the padding
+  if (ftruncate(fd, length) == -1) {
+    GALOIS_SYS_DIE("failed sizing '", filename, "'");
+  }
+
+  uint64_t header[4] = {1, sizeofEdgeData, numNodes, numEdges};
+  writeArray(fd, header, 0, 4, 0, filename);
+
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto n = galois::block_range((uint64_t)0, numNodes, tid, total);
+    writeArray(fd, edgeIndex, n.first, n.second, idxOffset, filename);
+    auto e = galois::block_range((uint64_t)0, numEdges, tid, total);
+    writeArray(fd, edgeDst, e.first, e.second, dstOffset, filename);
+    if (sizeofEdgeData) {
+      const char* data = static_cast<const char*>(edgeData);
+      writeAll(fd, data + e.first * sizeofEdgeData,
+               dataOffset + e.first * sizeofEdgeData,
+               (e.second - e.first) * sizeofEdgeData, filename);
+    }
+  });
+
+  if (close(fd) == -1) {
+    GALOIS_SYS_DIE("failed closing '", filename, "'");
+  }
+  timer.stop();
+}
+
+} // namespace graphs
+} // namespace galois
@@ -0,0 +1,249 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GraphSnapshot.cpp
+ *
+ * Implementation of GraphSnapshot.
+ */
+
+#include "galois/graphs/GraphSnapshot.h"
+#include "galois/gIO.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/vfs.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t snapshotMagic  = 0x50414e5347414c47ull; // "GLAGSNAP"
+const uint64_t snapshotLayout = 1;
+const uint64_t hugetlbfsMagic = 0x958458f6;
+const uint64_t pageSize       = 4096;
+
+uint64_t roundup(uint64_t x, uint64_t align) {
+  return (x + align - 1) / align * align;
+}
+
+//! Identity of the graph file a snapshot was built from
+struct SourceId {
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  uint64_t mtime;
+
+  bool read(const std::string& source) {
+    struct stat buf;
+    if (stat(source.c_str(), &buf) == -1)
+      return false;
+    dev   = buf.st_dev;
+    ino   = buf.st_ino;
+    size  = buf.st_size;
+    mtime = buf.st_mtim.tv_sec * 1000000000ull + buf.st_mtim.tv_nsec;
+    return true;
+  }
+
+  bool operator==(const SourceId& o) const {
+    return dev == o.dev && ino == o.ino && size == o.size && mtime == o.mtime;
+  }
+};
+
+} // namespace
+
+namespace galois {
+namespace graphs {
+
+struct GraphSnapshot::Header {
+  uint64_t magic;
+  uint64_t layout;
+  SourceId source;
+  uint64_t numNodes;
+  uint64_t numEdges;
+  uint64_t sizeofEdge;
+  uint64_t idxOffset;
+  uint64_t dstOffset;
+  uint64_t dataOffset;
+  uint64_t length;
+};
+
+GraphSnapshot::GraphSnapshot() : base(nullptr), length(0), header(nullptr) {}
+
+GraphSnapshot::~GraphSnapshot() {
+  if (base)
+    munmap(base, length);
+  if (!tmpPath.empty())
+    unlink(tmpPath.c_str());
+}
+
+std::shared_ptr<GraphSnapshot>
+GraphSnapshot::attach(const std::string& path, const std::string& source,
+                      uint64_t sizeofEdge) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return nullptr;
+
+  Header h;
+  SourceId id;
+  struct stat buf;
+  struct statfs fsbuf;
+  bool valid = fstat(fd, &buf) == 0 && fstatfs(fd, &fsbuf) == 0 &&
+               pread(fd, &h, sizeof(h), 0) == sizeof(h) &&
+               h.magic == snapshotMagic && h.layout == snapshotLayout &&
+               h.length <= uint64_t(buf.st_size);
+  if (!valid) {
+    gWarn("ignoring malformed graph snapshot '", path, "'");
+    close(fd);
+    return nullptr;
+  }
+  if (!id.read(source) || !(id == h.source) || h.sizeofEdge != sizeofEdge) {
+    gDebug("graph snapshot '", path, "' does not match '", source, "'");
+    close(fd);
+    return nullptr;
+  }
+
+  // private hugetlb mappings otherwise reserve a full copy up front
+  int flags = MAP_PRIVATE;
+  if (uint64_t(fsbuf.f_type) == hugetlbfsMagic)
+    flags |= MAP_NORESERVE;
+  void* ptr =
+      mmap(nullptr, h.length, PROT_READ | PROT_WRITE, flags, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    GALOIS_SYS_DIE("failed mapping graph snapshot '", path, "'");
+  }
+
+  std::shared_ptr<GraphSnapshot> snap(new GraphSnapshot());
+  snap->path   = path;
+  snap->base   = static_cast<char*>(ptr);
+  snap->length = h.length;
+  snap->header = reinterpret_cast<Header*>(ptr);
+  return snap;
+}
+
+std::shared_ptr<GraphSnapshot>
+GraphSnapshot::create(const std::string& path, const std::string& source,
+                      uint64_t numNodes, uint64_t numEdges,
+                      uint64_t sizeofEdge) {
+  SourceId id;
+  if (!id.read(source)) {
+    GALOIS_SYS_DIE("failed reading ", "'", source, "'");
+  }
+
+  std::shared_ptr<GraphSnapshot> snap(new GraphSnapshot());
+  snap->path    = path;
+  snap->tmpPath = path + ".tmp." + std::to_string(getpid());
+
+  int fd = open(snap->tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    gWarn("cannot create graph snapshot '", snap->tmpPath,
+          "': ", std::strerror(errno));
+    snap->tmpPath.clear();
+    return nullptr;
+  }
+
+  // hugetlbfs files must be a multiple of the huge page size
+  struct statfs fsbuf;
+  uint64_t fsPage = pageSize;
+  if (fstatfs(fd, &fsbuf) == 0 && uint64_t(fsbuf.f_bsize) > fsPage)
+    fsPage = fsbuf.f_bsize;
+
+  Header h;
+  h.magic      = snapshotMagic;
+  h.layout     = snapshotLayout;
+  h.source     = id;
+  h.numNodes   = numNodes;
+  h.numEdges   = numEdges;
+  h.sizeofEdge = sizeofEdge;
+  h.idxOffset  = roundup(sizeof(Header), pageSize);
+  h.dstOffset  = roundup(h.idxOffset + numNodes * sizeof(uint64_t), pageSize);
+  h.dataOffset = roundup(h.dstOffset + numEdges * sizeof(uint32_t), pageSize);
+  h.length     = roundup(h.dataOffset + numEdges * sizeofEdge, fsPage);
+
+  // allocate all pages now: running out of space on a memory file system
+  // later would raise SIGBUS while filling the snapshot in
+  int err = ftruncate(fd, h.length) == 0 ? posix_fallocate(fd, 0, h.length)
+                                         : errno;
+  void* ptr = MAP_FAILED;
+  if (!err) {
+    ptr = mmap(nullptr, h.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+      err = errno;
+  }
+  close(fd);
+  if (err) {
+    gWarn("cannot create graph snapshot '", snap->tmpPath,
+          "': ", std::strerror(err));
+    return nullptr;
+  }
+
+  snap->base   = static_cast<char*>(ptr);
+  snap->length = h.length;
+  snap->header = reinterpret_cast<Header*>(ptr);
+  *snap->header = h;
+  return snap;
+}
+
+std::string GraphSnapshot::defaultPath(const std::string& dir,
+                                       const std::string& source,
+                                       uint64_t sizeofEdge) {
+  std::string name = source.substr(source.find_last_of('/') + 1);
+  SourceId id;
+  if (!id.read(source))
+    return dir + "/galois-" + name;
+
+  char suffix[64];
+  snprintf(suffix, sizeof(suffix), "-%lx-%lx-e%lu", (unsigned long)id.dev,
+           (unsigned long)id.ino, (unsigned long)sizeofEdge);
+  return dir + "/galois-" + name + suffix;
+}
+
+void GraphSnapshot::publish() {
+  if (tmpPath.empty())
+    return;
+  if (rename(tmpPath.c_str(), path.c_str()) == -1) {
+    GALOIS_SYS_DIE("failed publishing graph snapshot '", path, "'");
+  }
+  tmpPath.clear();
+}
+
+uint64_t GraphSnapshot::size() const { return header->numNodes; }
+
+uint64_t GraphSnapshot::sizeEdges() const { return header->numEdges; }
+
+uint64_t* GraphSnapshot::edgeIndex() {
+  return reinterpret_cast<uint64_t*>(base + header->idxOffset);
+}
+
+uint32_t* GraphSnapshot::edgeDst() {
+  return reinterpret_cast<uint32_t*>(base + header->dstOffset);
+}
+
+void* GraphSnapshot::edgeData() {
+  return header->sizeofEdge ? base + header->dataOffset : nullptr;
+}
+
+} // namespace graphs
+} // namespace galois
@@ -29,6 +29,7 @@
 #include <fstream>
 #include <functional>
 #include <set>
+#include <sstream>
 
 #ifdef GALOIS_USE_NUMA
 #include <numa.h>
@@ -292,6 +293,26 @@ galois::substrate::getHWTopo() {
   return std::make_pair(retMTI, retTTI);
 }
 
+//! Parse /sys/devices/system/node/node<A>/distance
+unsigned galois::substrate::getNumaDistance(unsigned osNodeA,
+                                            unsigned osNodeB) {
+  unsigned fallback = osNodeA == osNodeB ? 10 : 20;
+
+  std::ifstream distances("/sys/devices/system/node/node" +
+                          std::to_string(osNodeA) + "/distance");
+  if (!distances)
+    return fallback;
+
+  std::string line;
+  std::getline(distances, line);
+  std::istringstream row(line);
+  unsigned d = fallback;
+  for (unsigned i = 0; i <= osNodeB; ++i)
+    if (!(row >> d))
+      return fallback;
+  return d;
+}
+
 //! binds current thread to OS HW context "proc"
 bool galois::substrate::bindThreadSelf(unsigned osContext) {
 #ifndef __CYGWIN__
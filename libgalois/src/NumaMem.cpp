@@ -22,6 +22,7 @@
 #include "galois/substrate/ThreadPool.h"
 #include "galois/gIO.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace galois::substrate;
@@ -136,12 +137,8 @@ static void pageInSpecified(void* _ptr, size_t len, size_t pageSize,
   }
 }
 
-static void largeFree(void* ptr, size_t bytes) {
-  freePages(ptr, bytes / allocSize());
-}
-
 void galois::substrate::internal::largeFreer::operator()(void* ptr) const {
-  largeFree(ptr, bytes);
+  freeLargePages(ptr, bytes, backing);
 }
 
 // round data to a multiple of mult
@@ -153,8 +150,14 @@ static size_t roundup(size_t data, size_t mult) {
   return data + (mult - rem);
 }
 
+// pages smaller than allocSize() are still handed out in allocSize() units
+static size_t pageInSize(PageBacking backing) {
+  return std::max(allocSize(), pageBackingSize(backing));
+}
+
 LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
-                                                unsigned numThreads) {
+                                                unsigned numThreads,
+                                                HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
 
@@ -165,41 +168,48 @@ LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
   // the alloc would go
 #endif
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  PageBacking backing = PageBacking::Base;
+  void* data = allocLargePages(bytes, policy, false, backing);
 
   // Then page in based on thread number
   if (data)
     // true = round robin paging
-    pageIn(data, bytes, allocSize(), numThreads, true);
+    pageIn(data, bytes, pageInSize(backing), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, internal::largeFreer{bytes, backing}};
 }
 
-LAptr galois::substrate::largeMallocLocal(size_t bytes) {
+LAptr galois::substrate::largeMallocLocal(size_t bytes,
+                                          HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), true),
-               internal::largeFreer{bytes}};
+  PageBacking backing = PageBacking::Base;
+  void* data = allocLargePages(bytes, policy, true, backing);
+  return LAptr{data, internal::largeFreer{bytes, backing}};
 }
 
-LAptr galois::substrate::largeMallocFloating(size_t bytes) {
+LAptr galois::substrate::largeMallocFloating(size_t bytes,
+                                             HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), false),
-               internal::largeFreer{bytes}};
+  PageBacking backing = PageBacking::Base;
+  void* data = allocLargePages(bytes, policy, false, backing);
+  return LAptr{data, internal::largeFreer{bytes, backing}};
 }
 
-LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
+LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads,
+                                            HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  PageBacking backing = PageBacking::Base;
+  void* data = allocLargePages(bytes, policy, false, backing);
   if (data)
     // false = blocked paging
-    pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+    pageIn(data, bytes, pageInSize(backing), numThreads, false);
+  return LAptr{data, internal::largeFreer{bytes, backing}};
 }
 
 /**
@@ -218,24 +228,26 @@ LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
 template <typename RangeArrayTy>
 LAptr galois::substrate::largeMallocSpecified(size_t bytes, uint32_t numThreads,
                                               RangeArrayTy& threadRanges,
-                                              size_t elementSize) {
+                                              size_t elementSize,
+                                              HugePagePolicy policy) {
   // ceiling to nearest page
   bytes = roundup(bytes, allocSize());
 
-  void* data = allocPages(bytes / allocSize(), false);
+  PageBacking backing = PageBacking::Base;
+  void* data = allocLargePages(bytes, policy, false, backing);
 
   // NUMA aware page in based on element distribution specified in threadRanges
   if (data)
-    pageInSpecified(data, bytes, allocSize(), numThreads, threadRanges,
+    pageInSpecified(data, bytes, pageInSize(backing), numThreads, threadRanges,
                     elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, internal::largeFreer{bytes, backing}};
 }
 // Explicit template declarations since the template is defined in the .h
 // file
 template LAptr galois::substrate::largeMallocSpecified<std::vector<uint32_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint32_t>& threadRanges,
-    size_t elementSize);
+    size_t elementSize, HugePagePolicy policy);
 template LAptr galois::substrate::largeMallocSpecified<std::vector<uint64_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint64_t>& threadRanges,
-    size_t elementSize);
+    size_t elementSize, HugePagePolicy policy);
@@ -18,10 +18,14 @@
  */
 
 #include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/EnvCheck.h"
 #include "galois/substrate/SimpleLock.h"
 #include "galois/gIO.h"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <string>
 
 #ifdef __linux__
 #include <linux/mman.h>
@@ -96,6 +100,163 @@ void galois::substrate::freePages(void* ptr, unsigned num) {
     GALOIS_SYS_DIE("Unmap failed");
 }
 
+const size_t gigaPageSize = 1024 * 1024 * 1024;
+// bytes currently mapped with each backing
+static std::atomic<size_t> liveBytes[galois::substrate::numPageBackings];
+
+using galois::substrate::HugePagePolicy;
+using galois::substrate::PageBacking;
+
+const char* galois::substrate::pageBackingName(PageBacking backing) {
+  switch (backing) {
+  case PageBacking::Huge1G:
+    return "HugeTLB1GB";
+  case PageBacking::Huge2M:
+    return "HugeTLB2MB";
+  case PageBacking::THP:
+    return "THP";
+  default:
+    return "BasePages";
+  }
+}
+
+size_t galois::substrate::pageBackingSize(PageBacking backing) {
+  switch (backing) {
+  case PageBacking::Huge1G:
+    return gigaPageSize;
+  case PageBacking::Huge2M:
+  case PageBacking::THP:
+    return hugePageSize;
+  default:
+    return 4096;
+  }
+}
+
+bool galois::substrate::parseHugePagePolicy(const std::string& val,
+                                            HugePagePolicy& policy) {
+  if (val == "2M")
+    policy = HugePagePolicy::Huge2M;
+  else if (val == "1G")
+    policy = HugePagePolicy::Huge1G;
+  else if (val == "THP")
+    policy = HugePagePolicy::THP;
+  else if (val == "none")
+    policy = HugePagePolicy::None;
+  else
+    return false;
+  return true;
+}
+
+HugePagePolicy galois::substrate::defaultHugePagePolicy() {
+  static HugePagePolicy policy = []() {
+    HugePagePolicy p = HugePagePolicy::Huge2M;
+    std::string val;
+    if (EnvCheck("GALOIS_HUGE_PAGES", val) && !parseHugePagePolicy(val, p))
+      gWarn("unknown GALOIS_HUGE_PAGES value '", val, "'; using 2M");
+    return p;
+  }();
+  return policy;
+}
+
+/**
+ * Maps bytes of anonymous memory aligned to hugePageSize (mmap only
+ * guarantees base page alignment, and THP only backs aligned 2 MB regions).
+ */
+static void* alignedmmap(size_t bytes) {
+  char* raw = static_cast<char*>(trymmap(bytes + hugePageSize, _MAP));
+  if (!raw)
+    return nullptr;
+  char* aligned = reinterpret_cast<char*>(
+      (reinterpret_cast<uintptr_t>(raw) + hugePageSize - 1) &
+      ~(uintptr_t)(hugePageSize - 1));
+  std::lock_guard<galois::substrate::SimpleLock> lg(allocLock);
+  if (aligned != raw)
+    munmap(raw, aligned - raw);
+  if (aligned + bytes != raw + bytes + hugePageSize)
+    munmap(aligned + bytes, raw + hugePageSize - aligned);
+  return aligned;
+}
+
+void* galois::substrate::allocLargePages(size_t& bytes, HugePagePolicy policy,
+                                         bool preFault, PageBacking& backing) {
+  backing = PageBacking::Base;
+  if (bytes == 0)
+    return nullptr;
+  if (policy == HugePagePolicy::Default)
+    policy = defaultHugePagePolicy();
+
+  void* ptr = nullptr;
+  // whether pages still need to be faulted in by hand
+  bool touch = preFault && doHandMap;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+  // 1 GB mappings must be a multiple of 1 GB; only use them if rounding up
+  // wastes at most an eighth of the request
+  size_t gigaBytes = (bytes + gigaPageSize - 1) & ~(gigaPageSize - 1);
+  if (policy == HugePagePolicy::Huge1G && gigaBytes - bytes <= bytes / 8) {
+    ptr = trymmap(gigaBytes, (preFault ? _MAP_HUGE_POP : _MAP_HUGE) |
+                                 MAP_HUGE_1GB);
+    if (ptr) {
+      bytes   = gigaBytes;
+      backing = PageBacking::Huge1G;
+    } else {
+      gDebug("1 GB huge page alloc failed, falling back");
+    }
+  }
+#endif
+
+  if (!ptr && (policy == HugePagePolicy::Huge1G ||
+               policy == HugePagePolicy::Huge2M)) {
+    ptr = trymmap(bytes, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    if (ptr)
+      backing = PageBacking::Huge2M;
+    else
+      gDebug("Huge page alloc failed, falling back");
+  }
+
+  if (!ptr && policy != HugePagePolicy::None) {
+    // without (enough) reserved hugetlb pages, ask for transparent huge
+    // pages; mapped unpopulated so the fault handler can use huge pages after
+    // the madvise
+    ptr   = alignedmmap(bytes);
+    touch = preFault;
+#ifdef MADV_HUGEPAGE
+    if (ptr && madvise(ptr, bytes, MADV_HUGEPAGE) == 0)
+      backing = PageBacking::THP;
+#endif
+  }
+
+  if (!ptr) {
+    ptr     = trymmap(bytes, preFault ? _MAP_POP : _MAP);
+    backing = PageBacking::Base;
+    touch   = preFault && doHandMap;
+  }
+
+  if (!ptr)
+    GALOIS_SYS_DIE("Out of Memory");
+
+  if (touch)
+    for (size_t x = 0; x < bytes; x += 4096)
+      static_cast<char*>(ptr)[x] = 0;
+
+  liveBytes[static_cast<unsigned>(backing)] += bytes;
+  return ptr;
+}
+
+void galois::substrate::freeLargePages(void* ptr, size_t bytes,
+                                       PageBacking backing) {
+  if (!ptr)
+    return;
+  liveBytes[static_cast<unsigned>(backing)] -= bytes;
+  std::lock_guard<SimpleLock> lg(allocLock);
+  if (munmap(ptr, bytes) != 0)
+    GALOIS_SYS_DIE("Unmap failed");
+}
+
+size_t galois::substrate::largePageBytes(PageBacking backing) {
+  return liveBytes[static_cast<unsigned>(backing)].load();
+}
+
 /*
 
 class PageSizeConf {
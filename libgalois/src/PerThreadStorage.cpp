@@ -18,9 +18,12 @@
  */
 
 #include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/CompilerSpecific.h"
 
 //#include "galois/runtime/Mem.h"
 #include "galois/gIO.h"
+#include <algorithm>
+#include <cstdlib>
 #include <mutex>
 
 thread_local char* galois::substrate::ptsBase;
@@ -41,7 +44,12 @@ galois::substrate::PerBackend& galois::substrate::getPPSBackend() {
 #ifdef MORE_MEM_HACK
 const size_t allocSize =
     16 * (2 << 20); // galois::runtime::MM::hugePageSize * 16;
-inline void* alloc() { return malloc(allocSize); }
+inline void* alloc() {
+  void* b = nullptr;
+  if (posix_memalign(&b, GALOIS_CACHE_LINE_SIZE, allocSize))
+    GALOIS_DIE("out of memory");
+  return b;
+}
 
 #else
 const size_t allocSize = galois::runtime::MM::hugePageSize;
@@ -65,10 +73,23 @@ unsigned galois::substrate::PerBackend::allocOffset(const unsigned sz) {
   unsigned ll     = nextLog2(sz);
   unsigned size   = (1 << ll);
 
-  if ((nextLoc + size) <= allocSize) {
+  // offsets are aligned to their size up to a cache line so that types
+  // like cache line aligned locks can be placed at them
+  unsigned align = std::min(size, unsigned(GALOIS_CACHE_LINE_SIZE));
+
+  unsigned loc = nextLoc;
+  while ((loc + align - 1) / align * align + size <= allocSize) {
     // simple path, where we allocate bump ptr style
-    retval = __sync_fetch_and_add(&nextLoc, size);
-  } else if (!invalid) {
+    unsigned start = (loc + align - 1) / align * align;
+    unsigned prev  = __sync_val_compare_and_swap(&nextLoc, loc, start + size);
+    if (prev == loc) {
+      retval = start;
+      break;
+    }
+    loc = prev;
+  }
+
+  if (retval == allocSize && !invalid) {
     // find a free offset
     std::lock_guard<Lock> llock(freeOffsetsLock);
 
@@ -0,0 +1,179 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file PerfCounters.cpp
+ *
+ * Implementation of per-thread hardware counters using perf_event_open.
+ */
+
+#include "galois/runtime/PerfCounters.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/gIO.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const eventNames[galois::runtime::numPerfEvents] = {
+    "Cycles", "Instructions", "LLCMisses", "DTLBMisses"};
+
+//! Group of counters of one thread; the first event is the group leader
+struct EventGroup {
+  int fd[galois::runtime::numPerfEvents];
+  //! position of each event in a group read; -1 if it is not counted
+  int slot[galois::runtime::numPerfEvents];
+  unsigned numOpen;
+  bool opened;
+
+  EventGroup() : numOpen(0), opened(false) {
+    for (unsigned i = 0; i < galois::runtime::numPerfEvents; ++i) {
+      fd[i]   = -1;
+      slot[i] = -1;
+    }
+  }
+
+  ~EventGroup() {
+    for (unsigned i = 0; i < galois::runtime::numPerfEvents; ++i)
+      if (fd[i] != -1)
+        close(fd[i]);
+  }
+
+  void open();
+};
+
+void initAttr(perf_event_attr& attr, unsigned event) {
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  switch (event) {
+  case 0:
+    attr.type   = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case 1:
+    attr.type   = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case 2:
+    attr.type   = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  default:
+    attr.type   = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  }
+}
+
+std::atomic<bool> warned(false);
+
+void EventGroup::open() {
+  opened = true;
+  for (unsigned i = 0; i < galois::runtime::numPerfEvents; ++i) {
+    perf_event_attr attr;
+    initAttr(attr, i);
+    // counters of this thread on any cpu
+    int f = syscall(__NR_perf_event_open, &attr, 0, -1, fd[0], 0);
+    if (f == -1) {
+      if (i == 0) {
+        if (!warned.exchange(true))
+          galois::gWarn("hardware counters unavailable: ", std::strerror(errno));
+        return;
+      }
+      // events the processor does not have are just not reported
+      continue;
+    }
+    fd[i]   = f;
+    slot[i] = numOpen++;
+  }
+}
+
+thread_local EventGroup group;
+
+} // namespace
+
+bool galois::runtime::perfCountersRequested() {
+  static const bool requested = substrate::EnvCheck("GALOIS_PERF_COUNTERS");
+  return requested;
+}
+
+bool galois::runtime::readPerfCounters(PerfSample& sample) {
+  sample.counted = 0;
+  if (!perfCountersRequested())
+    return false;
+  if (!group.opened)
+    group.open();
+  if (group.numOpen == 0)
+    return false;
+
+  uint64_t buf[3 + numPerfEvents];
+  ssize_t expected = (3 + group.numOpen) * sizeof(uint64_t);
+  if (read(group.fd[0], buf, sizeof(buf)) != expected)
+    return false;
+
+  // layout: nr, time_enabled, time_running, values...
+  sample.enabled = buf[1];
+  sample.running = buf[2];
+  for (unsigned i = 0; i < numPerfEvents; ++i) {
+    if (group.slot[i] == -1) {
+      sample.value[i] = 0;
+    } else {
+      sample.value[i] = buf[3 + group.slot[i]];
+      sample.counted |= 1u << i;
+    }
+  }
+  return true;
+}
+
+void galois::runtime::reportPerfCounters(const char* region,
+                                         const PerfSample& begin,
+                                         const PerfSample& end) {
+  uint64_t enabled = end.enabled - begin.enabled;
+  uint64_t running = end.running - begin.running;
+  // scale up counts if the kernel had to multiplex the counters
+  double scale = running ? double(enabled) / running : 0.0;
+
+  for (unsigned i = 0; i < numPerfEvents; ++i) {
+    if (group.slot[i] == -1)
+      continue;
+    // no baseline or no end value to take a delta of
+    if (!(begin.counted & end.counted & (1u << i))) {
+      reportStat_Tsum(region, std::string(eventNames[i]) + "Unavailable", 1);
+      continue;
+    }
+    uint64_t delta = end.value[i] - begin.value[i];
+    reportStat_Tsum(region, eventNames[i], uint64_t(delta * scale));
+  }
+}
@@ -0,0 +1,336 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file SetIntersection.cpp
+ *
+ * Scalar, AVX2 and AVX-512 kernels for intersecting sorted arrays. The
+ * vector kernels are compiled for their instruction set with target
+ * attributes, so the library itself needs no architecture flags.
+ */
+
+#include "galois/SetIntersection.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define GALOIS_INTERSECT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//! length ratio above which the shorter array is searched in the longer one
+const size_t gallopRatio = 32;
+
+//! merge loop without data dependent branches
+size_t countScalar(const uint32_t* a, size_t na, const uint32_t* b,
+                   size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  while (i < na && j < nb) {
+    uint32_t x = a[i], y = b[j];
+    count += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+size_t positionsScalar(const uint32_t* a, size_t na, const uint32_t* b,
+                       size_t nb, size_t i, size_t j, uint32_t* posA,
+                       uint32_t* posB) {
+  size_t count = 0;
+  while (i < na && j < nb) {
+    uint32_t x = a[i], y = b[j];
+    // written unconditionally; only kept if x == y
+    posA[count] = i;
+    posB[count] = j;
+    count += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+size_t positionsScalar(const uint32_t* a, size_t na, const uint32_t* b,
+                       size_t nb, uint32_t* posA, uint32_t* posB) {
+  return positionsScalar(a, na, b, nb, 0, 0, posA, posB);
+}
+
+//! first position in [lo, n) with b[pos] >= x, searching exponentially
+size_t gallop(const uint32_t* b, size_t lo, size_t n, uint32_t x) {
+  size_t step = 1, hi = lo;
+  while (hi < n && b[hi] < x) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  hi = std::min(hi, n);
+  return std::lower_bound(b + lo, b + hi, x) - b;
+}
+
+//! a is the shorter array
+size_t countGallop(const uint32_t* a, size_t na, const uint32_t* b,
+                   size_t nb) {
+  size_t j = 0, count = 0;
+  for (size_t i = 0; i < na && j < nb; ++i) {
+    j = gallop(b, j, nb, a[i]);
+    if (j < nb && b[j] == a[i]) {
+      ++count;
+      ++j;
+    }
+  }
+  return count;
+}
+
+size_t positionsGallop(const uint32_t* a, size_t na, const uint32_t* b,
+                       size_t nb, uint32_t* posA, uint32_t* posB) {
+  size_t j = 0, count = 0;
+  for (size_t i = 0; i < na && j < nb; ++i) {
+    j = gallop(b, j, nb, a[i]);
+    if (j < nb && b[j] == a[i]) {
+      posA[count] = i;
+      posB[count] = j;
+      ++count;
+      ++j;
+    }
+  }
+  return count;
+}
+
+#ifdef GALOIS_INTERSECT_X86
+
+// Block kernels: compare a block of a against every element of a block of b,
+// then advance whichever block has the smaller maximum (or both). Since
+// neither array has duplicates, each common element is found exactly once.
+// The AVX-512 kernels finish the arrays with the AVX2 ones.
+
+__attribute__((target("avx2,popcnt"))) size_t
+countAVX2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  // the elements of b rotated by one lane
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+    __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+
+    uint32_t amax = a[i + 7], bmax = b[j + 7];
+    i += amax <= bmax ? 8 : 0;
+    j += bmax <= amax ? 8 : 0;
+  }
+  return count + countScalar(a + i, na - i, b + j, nb - j);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t
+positionsAVX2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+              size_t i, size_t j, uint32_t* posA, uint32_t* posB) {
+  size_t count = 0;
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va    = _mm256_loadu_si256((const __m256i*)(a + i));
+    __m256i block = _mm256_loadu_si256((const __m256i*)(b + j));
+    __m256i vb    = block;
+    __m256i eq    = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+
+    unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+    while (mask) {
+      unsigned k     = __builtin_ctz(mask);
+      __m256i match  = _mm256_cmpeq_epi32(_mm256_set1_epi32(a[i + k]), block);
+      unsigned where = _mm256_movemask_ps(_mm256_castsi256_ps(match));
+      posA[count]    = i + k;
+      posB[count]    = j + __builtin_ctz(where);
+      ++count;
+      mask &= mask - 1;
+    }
+
+    uint32_t amax = a[i + 7], bmax = b[j + 7];
+    i += amax <= bmax ? 8 : 0;
+    j += bmax <= amax ? 8 : 0;
+  }
+  return count + positionsScalar(a, na, b, nb, i, j, posA + count,
+                                 posB + count);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t
+positionsAVX2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+              uint32_t* posA, uint32_t* posB) {
+  return positionsAVX2(a, na, b, nb, 0, 0, posA, posB);
+}
+
+// 16 independent compares with broadcast elements of b are faster than a
+// chain of 15 permutes
+
+__attribute__((target("avx512f,popcnt"))) size_t
+countAVX512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  while (i + 16 <= na && j + 16 <= nb) {
+    __m512i va   = _mm512_loadu_si512(a + i);
+    __mmask16 eq = 0;
+    for (int r = 0; r < 16; ++r) {
+      eq = _mm512_kor(
+          eq, _mm512_cmpeq_epi32_mask(va, _mm512_set1_epi32(b[j + r])));
+    }
+    count += __builtin_popcount(eq);
+
+    uint32_t amax = a[i + 15], bmax = b[j + 15];
+    i += amax <= bmax ? 16 : 0;
+    j += bmax <= amax ? 16 : 0;
+  }
+  return count + countAVX2(a + i, na - i, b + j, nb - j);
+}
+
+__attribute__((target("avx512f,popcnt"))) size_t
+positionsAVX512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                uint32_t* posA, uint32_t* posB) {
+  size_t i = 0, j = 0, count = 0;
+  while (i + 16 <= na && j + 16 <= nb) {
+    __m512i va    = _mm512_loadu_si512(a + i);
+    __m512i block = _mm512_loadu_si512(b + j);
+    __mmask16 eq  = 0;
+    for (int r = 0; r < 16; ++r) {
+      eq = _mm512_kor(
+          eq, _mm512_cmpeq_epi32_mask(va, _mm512_set1_epi32(b[j + r])));
+    }
+
+    unsigned mask = eq;
+    while (mask) {
+      unsigned k = __builtin_ctz(mask);
+      unsigned where =
+          _mm512_cmpeq_epi32_mask(_mm512_set1_epi32(a[i + k]), block);
+      posA[count] = i + k;
+      posB[count] = j + __builtin_ctz(where);
+      ++count;
+      mask &= mask - 1;
+    }
+
+    uint32_t amax = a[i + 15], bmax = b[j + 15];
+    i += amax <= bmax ? 16 : 0;
+    j += bmax <= amax ? 16 : 0;
+  }
+  return count + positionsAVX2(a, na, b, nb, i, j, posA + count,
+                               posB + count);
+}
+
+#endif
+
+typedef size_t (*CountFn)(const uint32_t*, size_t, const uint32_t*, size_t);
+typedef size_t (*PositionsFn)(const uint32_t*, size_t, const uint32_t*,
+                              size_t, uint32_t*, uint32_t*);
+
+struct Kernel {
+  galois::IntersectKernel kind;
+  CountFn count;
+  PositionsFn positions;
+};
+
+Kernel makeKernel(galois::IntersectKernel k) {
+  switch (k) {
+#ifdef GALOIS_INTERSECT_X86
+  case galois::IntersectKernel::AVX512:
+    return Kernel{k, countAVX512, positionsAVX512};
+  case galois::IntersectKernel::AVX2:
+    return Kernel{k, countAVX2, positionsAVX2};
+#endif
+  default:
+    return Kernel{galois::IntersectKernel::Scalar, countScalar,
+                  positionsScalar};
+  }
+}
+
+Kernel bestKernel() {
+#ifdef GALOIS_INTERSECT_X86
+  // may run before the constructor that initializes the cpu model
+  __builtin_cpu_init();
+#endif
+  if (galois::intersectKernelSupported(galois::IntersectKernel::AVX512))
+    return makeKernel(galois::IntersectKernel::AVX512);
+  if (galois::intersectKernelSupported(galois::IntersectKernel::AVX2))
+    return makeKernel(galois::IntersectKernel::AVX2);
+  return makeKernel(galois::IntersectKernel::Scalar);
+}
+
+Kernel kernel = bestKernel();
+
+} // namespace
+
+bool galois::intersectKernelSupported(IntersectKernel k) {
+  switch (k) {
+#ifdef GALOIS_INTERSECT_X86
+  case IntersectKernel::AVX512:
+    return __builtin_cpu_supports("avx512f");
+  case IntersectKernel::AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  case IntersectKernel::Scalar:
+    return true;
+  default:
+    return false;
+  }
+}
+
+galois::IntersectKernel galois::intersectKernel() { return kernel.kind; }
+
+bool galois::setIntersectKernel(IntersectKernel k) {
+  if (!intersectKernelSupported(k))
+    return false;
+  kernel = makeKernel(k);
+  return true;
+}
+
+const char* galois::intersectKernelName(IntersectKernel k) {
+  switch (k) {
+  case IntersectKernel::AVX512:
+    return "AVX512";
+  case IntersectKernel::AVX2:
+    return "AVX2";
+  default:
+    return "Scalar";
+  }
+}
+
+size_t galois::intersectCount(const uint32_t* a, size_t na, const uint32_t* b,
+                              size_t nb) {
+  if (na * gallopRatio < nb)
+    return countGallop(a, na, b, nb);
+  if (nb * gallopRatio < na)
+    return countGallop(b, nb, a, na);
+  return kernel.count(a, na, b, nb);
+}
+
+size_t galois::intersectPositions(const uint32_t* a, size_t na,
+                                  const uint32_t* b, size_t nb,
+                                  uint32_t* posA, uint32_t* posB) {
+  if (na * gallopRatio < nb)
+    return positionsGallop(a, na, b, nb, posA, posB);
+  if (nb * gallopRatio < na)
+    return positionsGallop(b, nb, a, na, posB, posA);
+  return kernel.positions(a, na, b, nb, posA, posB);
+}
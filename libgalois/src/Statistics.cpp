@@ -19,6 +19,7 @@
 
 #include "galois/runtime/Statistics.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/PageAlloc.h"
 
 #include <iostream>
 #include <fstream>
@@ -133,6 +134,17 @@ void galois::runtime::reportPageAlloc(const char* category) {
         reportStat_Tsum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+
+  // bytes held by large arrays, split by the pages backing them
+  for (unsigned b = 0; b < substrate::numPageBackings; ++b) {
+    auto backing = static_cast<substrate::PageBacking>(b);
+    size_t bytes = substrate::largePageBytes(backing);
+    if (bytes)
+      reportStat_Single("LargeAlloc",
+                        std::string(category) + "_" +
+                            substrate::pageBackingName(backing),
+                        bytes);
+  }
 }
 
 void galois::runtime::reportNumaAlloc(const char* category) {
@@ -40,7 +40,7 @@ thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
     : mi(getHWTopo().first), reserved(0), masterFastmode(false),
-      running(false) {
+      running(false), moreRounds(false) {
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -54,6 +54,40 @@ ThreadPool::ThreadPool()
                      [](per_signal* p) { return !p || !p->done; })) {
     std::atomic_thread_fence(std::memory_order_seq_cst);
   }
+
+  computeStealOrder();
+
+  socketThreads.resize(getMaxSockets());
+  socketActive.resize(getMaxSockets());
+  for (unsigned i = 0; i < mi.maxThreads; ++i)
+    socketThreads[getSocket(i)].push_back(i);
+}
+
+void ThreadPool::computeStealOrder() {
+  unsigned numSockets = getMaxSockets();
+  std::vector<unsigned> leaders(numSockets);
+  for (unsigned i = 0; i < numSockets; ++i)
+    leaders[i] = getLeaderForSocket(i);
+
+  stealOrder.resize(numSockets);
+  for (unsigned pid = 0; pid < numSockets; ++pid) {
+    unsigned node = signals[leaders[pid]]->topo.osNumaNode;
+    std::vector<std::pair<unsigned, unsigned>> victims; // (distance, socket)
+    for (unsigned off = 1; off < numSockets; ++off) {
+      unsigned other = (pid + off) % numSockets;
+      victims.emplace_back(
+          getNumaDistance(node, signals[leaders[other]]->topo.osNumaNode),
+          other);
+    }
+    // stable: ties keep the cyclic order
+    std::stable_sort(victims.begin(), victims.end(),
+                     [](const std::pair<unsigned, unsigned>& a,
+                        const std::pair<unsigned, unsigned>& b) {
+                       return a.first < b.first;
+                     });
+    for (auto& v : victims)
+      stealOrder[pid].push_back(leaders[v.second]);
+  }
 }
 
 ThreadPool::~ThreadPool() {
@@ -152,51 +186,128 @@ void ThreadPool::threadLoop(unsigned tid) {
   } while (true);
 }
 
+unsigned ThreadPool::treeChildren(const per_signal& me,
+                                  per_signal* children[4]) {
+  unsigned num = 0;
+  // the threads of my socket
+  if (me.wbegin != me.wend) {
+    auto& mine      = socketThreads[me.topo.socket];
+    auto midpoint   = me.wbegin + (1 + me.wend - me.wbegin) / 2;
+    children[num++] = signals[mine[me.wbegin]];
+    if (midpoint < me.wend)
+      children[num++] = signals[mine[midpoint]];
+  }
+  // the sockets I woke
+  if (me.sbegin != me.send) {
+    auto midpoint   = me.sbegin + (1 + me.send - me.sbegin) / 2;
+    children[num++] = signals[socketThreads[me.sbegin][0]];
+    if (midpoint < me.send)
+      children[num++] = signals[socketThreads[midpoint][0]];
+  }
+  return num;
+}
+
 void ThreadPool::decascade() {
   auto& me = my_box;
-  // nothing to wake up
-  if (me.wbegin != me.wend) {
-    auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-    auto& c1done  = signals[me.wbegin]->done;
-    while (!c1done) {
+  per_signal* children[4];
+  unsigned num = treeChildren(me, children);
+  for (unsigned i = 0; i < num; ++i) {
+    while (!children[i]->done) {
       asmPause();
     }
-    if (midpoint < me.wend) {
-      auto& c2done = signals[midpoint]->done;
-      while (!c2done) {
+  }
+  me.done = 1;
+}
+
+void ThreadPool::roundLoop(const std::function<void(unsigned)>& fn,
+                           const std::function<bool(unsigned)>& more) {
+  auto& me = my_box;
+  per_signal* children[4];
+  unsigned num = treeChildren(me, children);
+
+  for (unsigned round = 0;; ++round) {
+    fn(round);
+
+    // arrive once my subtree has
+    for (unsigned i = 0; i < num; ++i) {
+      while (children[i]->arrived.load(std::memory_order_acquire) <= round) {
+        asmPause();
+      }
+    }
+    me.arrived.store(round + 1, std::memory_order_release);
+
+    // everyone has arrived when the master gets here; the others wait for
+    // their parent to pass the master's decision down
+    if (&me == signals[0]) {
+      moreRounds = more(round);
+    } else {
+      while (me.released.load(std::memory_order_acquire) <= round) {
         asmPause();
       }
     }
+    for (unsigned i = 0; i < num; ++i)
+      children[i]->released.store(round + 1, std::memory_order_release);
+
+    if (!moreRounds)
+      return;
   }
-  me.done = 1;
+}
+
+void ThreadPool::runRounds(unsigned num,
+                           const std::function<void(unsigned)>& fn,
+                           const std::function<bool(unsigned)>& more) {
+  GALOIS_ASSERT(!running, "recursive thread pool execution not supported");
+  // threads are parked, and run publishes these stores to them
+  for (auto* s : signals) {
+    s->arrived  = 0;
+    s->released = 0;
+  }
+  run(num, [&]() { roundLoop(fn, more); });
+}
+
+void ThreadPool::wakeSocket(unsigned pid, unsigned sbegin, unsigned send,
+                            bool fastmode) {
+  auto leader    = signals[socketThreads[pid][0]];
+  leader->sbegin = sbegin;
+  leader->send   = send;
+  leader->wbegin = 1;
+  leader->wend   = socketActive[pid];
+  leader->wakeup(fastmode);
 }
 
 void ThreadPool::cascade(bool fastmode) {
   auto& me = my_box;
   assert(me.wbegin <= me.wend);
+  assert(me.sbegin <= me.send);
 
-  // nothing to wake up
+  // Wakeup is a binary tree over the socket leaders, and below each leader a
+  // binary tree over the threads of its socket, so only leaders signal across
+  // sockets. Other sockets go first since their wakeups take longest.
+  if (me.sbegin != me.send) {
+    auto midpoint = me.sbegin + (1 + me.send - me.sbegin) / 2;
+    wakeSocket(me.sbegin, me.sbegin + 1, midpoint, fastmode);
+    if (midpoint < me.send)
+      wakeSocket(midpoint, midpoint + 1, me.send, fastmode);
+  }
+
+  // nothing to wake up in my socket
   if (me.wbegin == me.wend)
     return;
 
+  auto& mine    = socketThreads[me.topo.socket];
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-  // static std::mutex m;
-  // {
-  //   std::lock_guard<std::mutex> lg(m);
-  //   std::cout << getTID() << "\t" << me.wbegin << ": (" << me.wbegin + 1 << "
-  //   " << midpoint << ")\t" << midpoint << ": (" << midpoint+1 << " " <<
-  //   me.wend << ")\n";
-  // }
-
-  auto child1    = signals[me.wbegin];
+
+  auto child1    = signals[mine[me.wbegin]];
   child1->wbegin = me.wbegin + 1;
   child1->wend   = midpoint;
+  child1->sbegin = child1->send = 0;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
-    auto child2    = signals[midpoint];
+    auto child2    = signals[mine[midpoint]];
     child2->wbegin = midpoint + 1;
     child2->wend   = me.wend;
+    child2->sbegin = child2->send = 0;
     child2->wakeup(fastmode);
   }
 }
@@ -207,10 +318,20 @@ void ThreadPool::runInternal(unsigned num) {
   GALOIS_ASSERT(!running, "recursive thread pool execution not supported");
   running = true;
   num     = std::min(std::max(1U, num), mi.maxThreads - reserved);
-  // my_box is tid 0
+  // threads [0, num) are active; they are the first threads of sockets
+  // [0, getCumulativeMaxSocket(num - 1)]
+  unsigned numSockets = getCumulativeMaxSocket(num - 1) + 1;
+  for (unsigned i = 0; i < numSockets; ++i) {
+    auto& threads   = socketThreads[i];
+    socketActive[i] = std::lower_bound(threads.begin(), threads.end(), num) -
+                      threads.begin();
+  }
+  // my_box is tid 0, the leader of socket 0
   auto& me  = my_box;
   me.wbegin = 1;
-  me.wend   = num;
+  me.wend   = socketActive[0];
+  me.sbegin = 1;
+  me.send   = numSockets;
 
   assert(!masterFastmode || masterFastmode == num);
   // launch threads
@@ -238,6 +359,8 @@ void ThreadPool::runDedicated(std::function<void(void)>& f) {
   auto child    = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
   child->wend   = 0;
+  child->sbegin = 0;
+  child->send   = 0;
   child->done   = 0;
   child->wakeup(masterFastmode);
   while (!child->done) {
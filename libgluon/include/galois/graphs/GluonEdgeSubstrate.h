@@ -35,6 +35,7 @@
 #include "galois/runtime/DistStats.h"
 #include "galois/runtime/SyncStructures.h"
 #include "galois/runtime/DataCommMode.h"
+#include "galois/runtime/CompressedOffsets.h"
 #include "galois/DynamicBitset.h"
 
 #ifdef __GALOIS_HET_CUDA__
@@ -100,6 +101,9 @@ private:
   // Used for efficient comms
   galois::DynamicBitSet syncBitset;
   galois::PODResizeableArray<unsigned int> syncOffsets;
+  //! Block ends and bytes of compressed offsets being sent or received
+  galois::PODResizeableArray<uint32_t> syncBlockEnds;
+  galois::PODResizeableArray<uint8_t> syncCodedOffsets;
 
   void reset_bitset(SyncType syncType,
                     void (*bitset_reset_range)(size_t, size_t)) {
@@ -362,6 +366,12 @@ public:
       edgeSubstrateSetupTimer.start();
 
       enforce_data_mode = enforce_metadata;
+#ifdef __GALOIS_HET_CUDA__
+    // the GPU batch (de)serializers only know the uncompressed modes
+    GALOIS_ASSERT(enforce_data_mode != deltaOffsetsData &&
+                      enforce_data_mode != bitsetRunsData,
+                  "Compressed metadata is not supported with GPUs");
+#endif
       initBareMPI();
       // master setup from mirrors done by setupCommunication call
       masterEdges.resize(numHosts);
@@ -409,71 +419,9 @@ private:
 
     Toffsets.start();
 
-    auto activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> t_prefix_bit_counts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each([&](unsigned tid, unsigned nthreads) {
-      // TODO use block_range instead
-      unsigned int block_size = bitset_comm.size() / nthreads;
-      if ((bitset_comm.size() % nthreads) > 0) ++block_size;
-      assert((block_size * nthreads) >= bitset_comm.size());
-
-      unsigned int start = tid * block_size;
-      unsigned int end   = (tid + 1) * block_size;
-      if (end > bitset_comm.size())
-        end = bitset_comm.size();
-
-      unsigned int count = 0;
-      for (unsigned int i = start; i < end; ++i) {
-        if (bitset_comm.test(i))
-          ++count;
-      }
-
-      t_prefix_bit_counts[tid] = count;
-    });
-
-    // calculate prefix sum of bits per thread
-    for (unsigned int i = 1; i < activeThreads; ++i) {
-      t_prefix_bit_counts[i] += t_prefix_bit_counts[i - 1];
-    }
-    // total num of set bits
-    bit_set_count = t_prefix_bit_counts[activeThreads - 1];
-
-    // calculate the indices of the set bits and save them to the offset
-    // vector
-    if (bit_set_count > 0) {
-      offsets.resize(bit_set_count);
-      galois::on_each([&](unsigned tid, unsigned nthreads) {
-        // TODO use block_range instead
-        // TODO this is same calculation as above; maybe refactor it
-        // into function?
-        unsigned int block_size = bitset_comm.size() / nthreads;
-        if ((bitset_comm.size() % nthreads) > 0)
-          ++block_size;
-        assert((block_size * nthreads) >= bitset_comm.size());
-
-        unsigned int start = tid * block_size;
-        unsigned int end   = (tid + 1) * block_size;
-        if (end > bitset_comm.size())
-          end = bitset_comm.size();
-
-        unsigned int count = 0;
-        unsigned int t_prefix_bit_count;
-        if (tid == 0) {
-          t_prefix_bit_count = 0;
-        } else {
-          t_prefix_bit_count = t_prefix_bit_counts[tid - 1];
-        }
+    // word-at-a-time scan of the bitset
+    bit_set_count = bitset_comm.getOffsets(offsets);
 
-        for (unsigned int i = start; i < end; ++i) {
-          if (bitset_comm.test(i)) {
-            offsets[t_prefix_bit_count + count] = i;
-            ++count;
-          }
-        }
-      });
-    }
     Toffsets.stop();
   }
 
@@ -534,6 +482,19 @@ private:
                                      bit_set_count);
     }
 
+#ifndef __GALOIS_HET_CUDA__
+    // measure the compressed modes only where they could win
+    if (enforce_data_mode == noData && bit_set_count > 0 &&
+        bit_set_count < indices.size()) {
+      size_t delta_offsets_size, bitset_runs_size;
+      galois::runtime::compressedOffsetsSizes(
+          offsets, bit_set_count, delta_offsets_size, bitset_runs_size);
+      data_mode = get_data_mode<typename FnTy::ValTy>(
+          bit_set_count, indices.size(), delta_offsets_size,
+          bitset_runs_size);
+      return;
+    }
+#endif
     data_mode = get_data_mode<typename FnTy::ValTy>(bit_set_count,
                                                     indices.size());
   }
@@ -684,6 +645,15 @@ private:
       Tserialize.start();
       gSerialize(b, data_mode, bit_set_count, offsets, val_vec);
       Tserialize.stop();
+    } else if (data_mode == deltaOffsetsData ||
+               data_mode == bitsetRunsData) {
+      val_vec.resize(bit_set_count);
+      Tserialize.start();
+      galois::runtime::compressOffsets(data_mode, offsets, bit_set_count,
+                                       syncBlockEnds, syncCodedOffsets);
+      gSerialize(b, data_mode, bit_set_count, syncBlockEnds, syncCodedOffsets,
+                 val_vec);
+      Tserialize.stop();
     } else if (data_mode == bitsetData) {
       val_vec.resize(bit_set_count);
       Tserialize.start();
@@ -743,6 +713,12 @@ private:
         convertGIDToLID<syncType>(loopName, offsets);
       } else if (data_mode == offsetsData) {
         galois::runtime::gDeserialize(buf, offsets);
+      } else if (data_mode == deltaOffsetsData ||
+                 data_mode == bitsetRunsData) {
+        galois::runtime::gDeserialize(buf, syncBlockEnds, syncCodedOffsets);
+        galois::runtime::decompressOffsets(data_mode, bit_set_count,
+                                           syncBlockEnds, syncCodedOffsets,
+                                           offsets);
       } else if (data_mode == bitsetData) {
         bit_set_comm.resize(num);
         galois::runtime::gDeserialize(buf, bit_set_comm);
@@ -1854,7 +1830,7 @@ private:
                       async, true, true>(
                             loopName, offsets, bit_set_count, offsets, val_vec,
                             bit_set_compute);
-          } else { // bitsetData or offsetsData
+          } else { // bitsetData, offsetsData or compressed offsets
             setSubset<decltype(sharedEdges[from_id]), SyncFnTy, syncType,
                       async, false, true>(
                             loopName, sharedEdges[from_id], bit_set_count,
@@ -28,12 +28,15 @@
 
 #include <unordered_map>
 #include <fstream>
+#include <atomic>
 
 #include "galois/runtime/GlobalObj.h"
 #include "galois/runtime/DistStats.h"
 #include "galois/runtime/SyncStructures.h"
 #include "galois/runtime/DataCommMode.h"
+#include "galois/runtime/CompressedOffsets.h"
 #include "galois/DynamicBitset.h"
+#include "galois/AtomicHelpers.h"
 
 #ifdef __GALOIS_HET_CUDA__
 #include "galois/cuda/HostDecls.h"
@@ -46,6 +49,8 @@ namespace cll = llvm::cl;
 
 //! Specifies if synchronization should be partition agnostic
 extern cll::opt<bool> partitionAgnostic;
+//! Number of blocks do_all_sync cuts its loop into to overlap communication
+extern cll::opt<unsigned> overlapSync;
 //! Specifies what format to send metadata in
 extern cll::opt<DataCommMode> enforce_metadata;
 #ifdef __GALOIS_BARE_MPI_COMMUNICATION__
@@ -130,6 +135,14 @@ private:
   // Used for efficient comms
   galois::DynamicBitSet syncBitset;
   galois::PODResizeableArray<unsigned int> syncOffsets;
+  //! Block ends and bytes of compressed offsets being sent or received
+  galois::PODResizeableArray<uint32_t> syncBlockEnds;
+  galois::PODResizeableArray<uint8_t> syncCodedOffsets;
+  //! Loop range that overlapHostReady was computed for
+  std::pair<size_t, size_t> overlapRange;
+  //! For reduce (0) and broadcast (1), the node of the loop of overlapRange
+  //! after which the proxies shared with each host are no longer touched
+  std::vector<size_t> overlapHostReady[2];
 
   /**
    * Reset a provided bitset given the type of synchronization performed
@@ -181,6 +194,17 @@ private:
   void exchangeProxyInfo() {
     auto& net = galois::runtime::getSystemNetworkInterface();
 
+    // a graph read from local graph files already has its masters; all hosts
+    // read their files or none does, so either all skip the exchange or none
+    auto& savedMasters = userGraph.getMasterNodes();
+    if (savedMasters.size() == numHosts) {
+      for (unsigned x = 0; x < numHosts; ++x) {
+        masterNodes[x] = std::move(savedMasters[x]);
+      }
+      savedMasters.clear();
+      return;
+    }
+
     // send off the mirror nodes
     for (unsigned x = 0; x < numHosts; ++x) {
       if (x == id) continue;
@@ -430,6 +454,12 @@ public:
     }
 
     enforce_data_mode = enforce_metadata;
+#ifdef __GALOIS_HET_CUDA__
+    // the GPU batch (de)serializers only know the uncompressed modes
+    GALOIS_ASSERT(enforce_data_mode != deltaOffsetsData &&
+                      enforce_data_mode != bitsetRunsData,
+                  "Compressed metadata is not supported with GPUs");
+#endif
     initBareMPI();
     // master setup from mirrors done by setupCommunication call
     masterNodes.resize(numHosts);
@@ -473,71 +503,9 @@ private:
 
     Toffsets.start();
 
-    auto activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> t_prefix_bit_counts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each([&](unsigned tid, unsigned nthreads) {
-      // TODO use block_range instead
-      unsigned int block_size = bitset_comm.size() / nthreads;
-      if ((bitset_comm.size() % nthreads) > 0) ++block_size;
-      assert((block_size * nthreads) >= bitset_comm.size());
-
-      unsigned int start = tid * block_size;
-      unsigned int end   = (tid + 1) * block_size;
-      if (end > bitset_comm.size())
-        end = bitset_comm.size();
-
-      unsigned int count = 0;
-      for (unsigned int i = start; i < end; ++i) {
-        if (bitset_comm.test(i))
-          ++count;
-      }
-
-      t_prefix_bit_counts[tid] = count;
-    });
-
-    // calculate prefix sum of bits per thread
-    for (unsigned int i = 1; i < activeThreads; ++i) {
-      t_prefix_bit_counts[i] += t_prefix_bit_counts[i - 1];
-    }
-    // total num of set bits
-    bit_set_count = t_prefix_bit_counts[activeThreads - 1];
-
-    // calculate the indices of the set bits and save them to the offset
-    // vector
-    if (bit_set_count > 0) {
-      offsets.resize(bit_set_count);
-      galois::on_each([&](unsigned tid, unsigned nthreads) {
-        // TODO use block_range instead
-        // TODO this is same calculation as above; maybe refactor it
-        // into function?
-        unsigned int block_size = bitset_comm.size() / nthreads;
-        if ((bitset_comm.size() % nthreads) > 0)
-          ++block_size;
-        assert((block_size * nthreads) >= bitset_comm.size());
-
-        unsigned int start = tid * block_size;
-        unsigned int end   = (tid + 1) * block_size;
-        if (end > bitset_comm.size())
-          end = bitset_comm.size();
-
-        unsigned int count = 0;
-        unsigned int t_prefix_bit_count;
-        if (tid == 0) {
-          t_prefix_bit_count = 0;
-        } else {
-          t_prefix_bit_count = t_prefix_bit_counts[tid - 1];
-        }
+    // word-at-a-time scan of the bitset
+    bit_set_count = bitset_comm.getOffsets(offsets);
 
-        for (unsigned int i = start; i < end; ++i) {
-          if (bitset_comm.test(i)) {
-            offsets[t_prefix_bit_count + count] = i;
-            ++count;
-          }
-        }
-      });
-    }
     Toffsets.stop();
   }
 
@@ -598,6 +566,19 @@ private:
                                      bit_set_count);
     }
 
+#ifndef __GALOIS_HET_CUDA__
+    // measure the compressed modes only where they could win
+    if (enforce_data_mode == noData && bit_set_count > 0 &&
+        bit_set_count < indices.size()) {
+      size_t delta_offsets_size, bitset_runs_size;
+      galois::runtime::compressedOffsetsSizes(
+          offsets, bit_set_count, delta_offsets_size, bitset_runs_size);
+      data_mode = get_data_mode<typename FnTy::ValTy>(
+          bit_set_count, indices.size(), delta_offsets_size,
+          bitset_runs_size);
+      return;
+    }
+#endif
     data_mode = get_data_mode<typename FnTy::ValTy>(bit_set_count,
                                                     indices.size());
   }
@@ -762,6 +743,15 @@ private:
       Tserialize.start();
       gSerialize(b, data_mode, bit_set_count, offsets, val_vec);
       Tserialize.stop();
+    } else if (data_mode == deltaOffsetsData ||
+               data_mode == bitsetRunsData) {
+      val_vec.resize(bit_set_count);
+      Tserialize.start();
+      galois::runtime::compressOffsets(data_mode, offsets, bit_set_count,
+                                       syncBlockEnds, syncCodedOffsets);
+      gSerialize(b, data_mode, bit_set_count, syncBlockEnds, syncCodedOffsets,
+                 val_vec);
+      Tserialize.stop();
     } else if (data_mode == bitsetData) {
       val_vec.resize(bit_set_count);
       Tserialize.start();
@@ -821,6 +811,12 @@ private:
         convertGIDToLID<syncType>(loopName, offsets);
       } else if (data_mode == offsetsData) {
         galois::runtime::gDeserialize(buf, offsets);
+      } else if (data_mode == deltaOffsetsData ||
+                 data_mode == bitsetRunsData) {
+        galois::runtime::gDeserialize(buf, syncBlockEnds, syncCodedOffsets);
+        galois::runtime::decompressOffsets(data_mode, bit_set_count,
+                                           syncBlockEnds, syncCodedOffsets,
+                                           offsets);
       } else if (data_mode == bitsetData) {
         bit_set_comm.resize(num);
         galois::runtime::gDeserialize(buf, bit_set_comm);
@@ -2253,7 +2249,7 @@ private:
                       async, true, true>(
                             loopName, offsets, bit_set_count, offsets, val_vec,
                             bit_set_compute);
-          } else { // bitsetData or offsetsData
+          } else { // bitsetData, offsetsData or compressed offsets
             setSubset<decltype(sharedNodes[from_id]), SyncFnTy, syncType, VecTy,
                       async, false, true>(
                             loopName, sharedNodes[from_id], bit_set_count,
@@ -2357,7 +2353,7 @@ private:
                                   loopName, offsets, bit_set_count,
                                   offsets, val_vec,
                                   bit_set_compute, i);
-          } else { // bitsetData or offsetsData
+          } else { // bitsetData, offsetsData or compressed offsets
             setSubset<decltype(sharedNodes[from_id]), SyncFnTy, syncType, VecTy,
                       async, false, true, true>(
                                   loopName, sharedNodes[from_id],
@@ -3057,6 +3053,261 @@ public:
     Tsync.stop();
   }
 
+////////////////////////////////////////////////////////////////////////////////
+// Compute overlapped with sync
+////////////////////////////////////////////////////////////////////////////////
+private:
+  /**
+   * Determines the phases of a sync; mirrors the sync_* functions.
+   *
+   * @param writeLocation Location data is written (src or dst)
+   * @param readLocation Location data is read (src or dst)
+   * @param reduceNeeded OUTPUT: true if sync reduces
+   * @param broadcastNeeded OUTPUT: true if sync broadcasts
+   */
+  void syncPhases(WriteLocation writeLocation, ReadLocation readLocation,
+                  bool& reduceNeeded, bool& broadcastNeeded) const {
+    if (partitionAgnostic) {
+      writeLocation = writeAny;
+      readLocation  = readAny;
+    }
+
+    if (writeLocation == writeSource) {
+      if (readLocation == readSource) {
+        reduceNeeded = broadcastNeeded = transposed || isVertexCut;
+      } else if (readLocation == readDestination) {
+        reduceNeeded    = transposed || isVertexCut;
+        broadcastNeeded = !transposed || isVertexCut;
+      } else {
+        reduceNeeded    = transposed || isVertexCut;
+        broadcastNeeded = true;
+      }
+    } else if (writeLocation == writeDestination) {
+      if (readLocation == readSource) {
+        reduceNeeded    = !transposed || isVertexCut;
+        broadcastNeeded = transposed || isVertexCut;
+      } else if (readLocation == readDestination) {
+        reduceNeeded = broadcastNeeded = !transposed || isVertexCut;
+      } else {
+        reduceNeeded    = !transposed || isVertexCut;
+        broadcastNeeded = true;
+      }
+    } else {
+      reduceNeeded = true;
+      if (readLocation == readSource) {
+        broadcastNeeded = transposed || isVertexCut;
+      } else if (readLocation == readDestination) {
+        broadcastNeeded = !transposed || isVertexCut;
+      } else {
+        broadcastNeeded = true;
+      }
+    }
+  }
+
+  /**
+   * Computes overlapHostReady for a loop over [begin, end). The loop touches
+   * the node it is called on and the destinations of its edges, so a proxy
+   * is final once the loop has passed the last node that touches it. Kept
+   * until called with a different range.
+   *
+   * @param begin first node of the loop
+   * @param end one past the last node of the loop
+   */
+  void computeOverlapHostReady(size_t begin, size_t end) {
+    if (!overlapHostReady[0].empty() && overlapRange.first == begin &&
+        overlapRange.second == end) {
+      return;
+    }
+
+    // one past the last node of the loop that touches each node, or 0
+    std::vector<std::atomic<uint32_t>> lastTouch(userGraph.size());
+    galois::do_all(
+        galois::iterate((size_t)0, lastTouch.size()),
+        [&](size_t n) { lastTouch[n].store(0, std::memory_order_relaxed); },
+        galois::no_stats());
+    galois::do_all(
+        galois::iterate(begin, end),
+        [&](size_t src) {
+          uint32_t touch = src + 1;
+          galois::atomicMax(lastTouch[src], touch);
+          for (auto e : userGraph.edges(src)) {
+            galois::atomicMax(lastTouch[userGraph.getEdgeDst(e)], touch);
+          }
+        },
+        galois::steal(), galois::no_stats());
+
+    for (unsigned t = 0; t < 2; ++t) {
+      auto& sharedNodes = (t == 0) ? mirrorNodes : masterNodes;
+      overlapHostReady[t].assign(numHosts, begin);
+      for (unsigned x = 0; x < numHosts; ++x) {
+        galois::GReduceMax<uint32_t> ready;
+        galois::do_all(galois::iterate((size_t)0, sharedNodes[x].size()),
+                       [&](size_t i) {
+                         ready.update(lastTouch[sharedNodes[x][i]].load(
+                             std::memory_order_relaxed));
+                       },
+                       galois::no_stats());
+        overlapHostReady[t][x] = std::max(begin, (size_t)ready.reduce());
+      }
+    }
+    overlapRange = std::make_pair(begin, end);
+  }
+
+  /**
+   * Runs a loop over [begin, end) in overlapSync blocks and does the given
+   * phase of a sync: after each block, messages go out to the hosts whose
+   * shared proxies the rest of the loop does not touch. The network layer
+   * sends them while the next blocks run. Then resets the bitset and
+   * receives as syncSend and syncRecv do.
+   *
+   * @param loopName used to name timers for statistics
+   * @param begin first node of the loop
+   * @param end one past the last node of the loop
+   * @param Tsync timer of the sync; stopped while the loop runs
+   * @param fn operator to apply
+   * @param args loop parameters passed on to do_all
+   */
+  template <WriteLocation writeLocation, ReadLocation readLocation,
+            SyncType syncType, typename SyncFnTy, typename BitsetFnTy,
+            typename FnTy, typename... Args>
+  void overlapPhase(std::string loopName, size_t begin, size_t end,
+                    galois::StatTimer& Tsync, const FnTy& fn,
+                    const Args&... args) {
+    typedef typename SyncFnTy::ValTy T;
+    typedef typename std::conditional<
+        galois::runtime::is_memory_copyable<T>::value,
+        galois::PODResizeableArray<T>, galois::gstl::Vector<T>>::type VecTy;
+    static galois::runtime::SendBuffer b;
+
+    auto& net = galois::runtime::getSystemNetworkInterface();
+    std::string syncTypeStr = (syncType == syncReduce) ? "Reduce" : "Broadcast";
+    galois::CondStatTimer<MORE_COMM_STATS> TSendTime(
+        (syncTypeStr + "Send_" + get_run_identifier(loopName)).c_str(), RNAME);
+    std::string statNumMessages_str(syncTypeStr + "NumMessages_" +
+                                    get_run_identifier(loopName));
+    std::string statEarlyMessages_str(syncTypeStr + "OverlappedMessages_" +
+                                      get_run_identifier(loopName));
+
+    const std::vector<size_t>& hostReady =
+        overlapHostReady[(syncType == syncReduce) ? 0 : 1];
+    std::vector<bool> sent(numHosts, false);
+    sent[id] = true;
+    size_t numBlocks   = std::min<size_t>(overlapSync, end - begin);
+    size_t numMessages = 0;
+    size_t numEarly    = 0;
+
+    for (size_t block = 0, blockBegin = begin; block < numBlocks; ++block) {
+      size_t blockEnd = begin + (end - begin) * (block + 1) / numBlocks;
+      Tsync.stop();
+      galois::do_all(galois::iterate(blockBegin, blockEnd), fn, args...);
+      Tsync.start();
+      blockBegin = blockEnd;
+
+      // the last block finalizes every proxy, so all hosts are sent to
+      TSendTime.start();
+      bool anySent = false;
+      for (unsigned h = 1; h < numHosts; ++h) {
+        unsigned x = (id + h) % numHosts;
+        if (sent[x] || hostReady[x] > blockEnd) {
+          continue;
+        }
+        sent[x] = true;
+        if (nothingToSend(x, syncType, writeLocation, readLocation)) {
+          continue;
+        }
+
+        getSendBuffer<syncType, SyncFnTy, BitsetFnTy, VecTy, false>(loopName,
+                                                                     x, b);
+        net.sendTagged(x, galois::runtime::evilPhase, b);
+        anySent = true;
+        ++numMessages;
+        if (blockEnd < end) {
+          ++numEarly;
+        }
+      }
+      if (anySent) {
+        net.flush();
+      }
+      TSendTime.stop();
+    }
+
+    if (BitsetFnTy::is_valid()) {
+      reset_bitset(syncType, &BitsetFnTy::reset_range);
+    }
+    galois::runtime::reportStat_Tsum(RNAME, statNumMessages_str, numMessages);
+    galois::runtime::reportStat_Tsum(RNAME, statEarlyMessages_str, numEarly);
+
+    syncRecv<writeLocation, readLocation, syncType, SyncFnTy, BitsetFnTy,
+             VecTy, false>(loopName);
+  }
+
+public:
+  /**
+   * Runs fn on the nodes of range in a do_all and then does the sync that
+   * sync<writeLocation, readLocation, SyncFnTy, BitsetFnTy, async> does.
+   *
+   * With -overlapSync=N for N > 1, the loop runs as N do_alls over blocks
+   * of ascending node IDs. After each block, the first phase of the sync
+   * (reduce, or broadcast if there is no reduce) is sent to each host whose
+   * shared proxies the rest of the loop cannot touch, which overlaps the
+   * tail of the compute with communication. fn must only touch the node it
+   * is called on and the destinations of that node's edges. The nodes of
+   * range must be contiguous (e.g. allNodesWithEdgesRange()).
+   *
+   * Async, bare MPI and sync on demand do not overlap.
+   *
+   * @tparam writeLocation Location data is written (src or dst)
+   * @tparam readLocation Location data is read (src or dst)
+   * @tparam SyncFnTy sync structure for the field
+   * @tparam BitsetFnTy struct that has info on how to access the bitset
+   *
+   * @param loopName used to name timers for statistics
+   * @param range nodes to run fn on
+   * @param fn operator to apply
+   * @param args loop parameters passed on to do_all
+   */
+  template <WriteLocation writeLocation, ReadLocation readLocation,
+            typename SyncFnTy, typename BitsetFnTy = galois::InvalidBitsetFnTy,
+            bool async = false, typename RangeTy, typename FnTy,
+            typename... Args>
+  void do_all_sync(std::string loopName, const RangeTy& range, const FnTy& fn,
+                   const Args&... args) {
+    bool reduceNeeded, broadcastNeeded;
+    syncPhases(writeLocation, readLocation, reduceNeeded, broadcastNeeded);
+
+    bool overlap = overlapSync > 1 && !async && currentBVFlag == nullptr &&
+                   (reduceNeeded || broadcastNeeded) &&
+                   range.begin() != range.end();
+#ifdef __GALOIS_BARE_MPI_COMMUNICATION__
+    overlap = overlap && bare_mpi == noBareMPI;
+#endif
+    if (!overlap) {
+      galois::do_all(galois::iterate(range), fn, args...);
+      sync<writeLocation, readLocation, SyncFnTy, BitsetFnTy, async>(loopName);
+      return;
+    }
+
+    std::string timer_str("Sync_" + loopName + "_" + get_run_identifier());
+    galois::StatTimer Tsync(timer_str.c_str(), RNAME);
+
+    size_t begin = *range.begin();
+    size_t end   = *range.end();
+    Tsync.start();
+    computeOverlapHostReady(begin, end);
+    if (reduceNeeded) {
+      overlapPhase<writeLocation, readLocation, syncReduce, SyncFnTy,
+                   BitsetFnTy>(loopName, begin, end, Tsync, fn, args...);
+      if (broadcastNeeded) {
+        broadcast<writeLocation, readLocation, SyncFnTy, BitsetFnTy, false>(
+            loopName);
+      }
+    } else {
+      overlapPhase<writeLocation, readLocation, syncBroadcast, SyncFnTy,
+                   BitsetFnTy>(loopName, begin, end, Tsync, fn, args...);
+    }
+    Tsync.stop();
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 // Sync on demand code (unmaintained, may not work)
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,235 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file CompressedOffsets.h
+ *
+ * Encoding of the sorted offsets of a sync message for the deltaOffsetsData
+ * and bitsetRunsData modes.
+ *
+ * Offsets are cut into blocks of compressedOffsetsBlock entries that are
+ * coded independently, so that threads can encode and decode blocks in
+ * parallel. A message carries the end of each block in the byte stream
+ * followed by the bytes. All values are LEB128 varints:
+ *
+ * - deltaOffsetsData: the first offset of a block, then for each following
+ * offset the gap to its predecessor minus one
+ * - bitsetRunsData: for each run of consecutive offsets (set bits), the gap
+ * from the end of the previous run in the block (or from 0) and the run
+ * length minus one
+ */
+
+#ifndef _GALOIS_RUNTIME_COMPRESSEDOFFSETS_H_
+#define _GALOIS_RUNTIME_COMPRESSEDOFFSETS_H_
+
+#include "galois/Galois.h"
+#include "galois/PODResizeableArray.h"
+#include "galois/Reduction.h"
+#include "galois/runtime/DataCommMode.h"
+
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+
+namespace galois {
+namespace runtime {
+
+//! Number of offsets in each independently coded block
+constexpr size_t compressedOffsetsBlock = 4096;
+
+namespace internal {
+
+//! Writes v at out unless out is null; @returns its size in bytes
+inline size_t putVarint(uint8_t* out, uint32_t v) {
+  size_t n = 0;
+  for (; v >= 0x80; v >>= 7, ++n) {
+    if (out)
+      out[n] = static_cast<uint8_t>(v | 0x80);
+  }
+  if (out)
+    out[n] = static_cast<uint8_t>(v);
+  return n + 1;
+}
+
+inline const uint8_t* getVarint(const uint8_t* in, uint32_t& v) {
+  v = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    uint8_t byte = *in++;
+    v |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return in;
+  }
+}
+
+/**
+ * Codes n sorted offsets. With a null out, only measures.
+ *
+ * @returns number of bytes of the coded block
+ */
+inline size_t encodeOffsetsBlock(DataCommMode mode, const unsigned int* o,
+                                 size_t n, uint8_t* out) {
+  size_t bytes = 0;
+  if (mode == deltaOffsetsData) {
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t v = i ? o[i] - o[i - 1] - 1 : o[i];
+      bytes += putVarint(out ? out + bytes : nullptr, v);
+    }
+  } else {
+    assert(mode == bitsetRunsData);
+    uint32_t next = 0; // first offset after the previous run
+    for (size_t i = 0, j; i < n; i = j) {
+      for (j = i + 1; j < n && o[j] == o[j - 1] + 1; ++j)
+        ;
+      bytes += putVarint(out ? out + bytes : nullptr, o[i] - next);
+      bytes += putVarint(out ? out + bytes : nullptr, j - i - 1);
+      next = o[j - 1] + 1;
+    }
+  }
+  return bytes;
+}
+
+//! Decodes n offsets coded by encodeOffsetsBlock into o
+inline void decodeOffsetsBlock(DataCommMode mode, const uint8_t* in, size_t n,
+                               unsigned int* o) {
+  uint32_t v;
+  if (mode == deltaOffsetsData) {
+    for (size_t i = 0; i < n; ++i) {
+      in   = getVarint(in, v);
+      o[i] = i ? o[i - 1] + 1 + v : v;
+    }
+  } else {
+    assert(mode == bitsetRunsData);
+    uint32_t next = 0;
+    for (size_t i = 0; i < n;) {
+      uint32_t length;
+      in     = getVarint(in, v);
+      in     = getVarint(in, length);
+      next  += v;
+      for (uint32_t k = 0; k <= length; ++k)
+        o[i++] = next++;
+    }
+  }
+}
+
+} // namespace internal
+
+/**
+ * Measures the serialized metadata of both compressed modes for the first
+ * count sorted offsets.
+ *
+ * @param offsets sorted offsets of the elements to send
+ * @param count number of offsets
+ * @param deltaSize OUTPUT: bytes in deltaOffsetsData mode
+ * @param runsSize OUTPUT: bytes in bitsetRunsData mode
+ */
+inline void
+compressedOffsetsSizes(const galois::PODResizeableArray<unsigned int>& offsets,
+                       size_t count, size_t& deltaSize, size_t& runsSize) {
+  size_t numBlocks =
+      (count + compressedOffsetsBlock - 1) / compressedOffsetsBlock;
+  galois::GAccumulator<size_t> delta;
+  galois::GAccumulator<size_t> runs;
+  galois::do_all(
+      galois::iterate((size_t)0, numBlocks),
+      [&](size_t b) {
+        size_t begin = b * compressedOffsetsBlock;
+        size_t n     = std::min(count - begin, compressedOffsetsBlock);
+        delta += internal::encodeOffsetsBlock(
+            deltaOffsetsData, offsets.data() + begin, n, nullptr);
+        runs += internal::encodeOffsetsBlock(
+            bitsetRunsData, offsets.data() + begin, n, nullptr);
+      },
+      galois::no_stats());
+
+  // block ends and bytes are each serialized with their size
+  size_t header = numBlocks * sizeof(uint32_t) + 2 * sizeof(size_t);
+  deltaSize     = header + delta.reduce();
+  runsSize      = header + runs.reduce();
+}
+
+/**
+ * Codes the first count sorted offsets in a compressed mode.
+ *
+ * @param mode deltaOffsetsData or bitsetRunsData
+ * @param offsets sorted offsets of the elements to send
+ * @param count number of offsets
+ * @param blockEnds OUTPUT: end of each block in bytes
+ * @param bytes OUTPUT: coded blocks
+ */
+inline void
+compressOffsets(DataCommMode mode,
+                const galois::PODResizeableArray<unsigned int>& offsets,
+                size_t count, galois::PODResizeableArray<uint32_t>& blockEnds,
+                galois::PODResizeableArray<uint8_t>& bytes) {
+  size_t numBlocks =
+      (count + compressedOffsetsBlock - 1) / compressedOffsetsBlock;
+  blockEnds.resize(numBlocks);
+  galois::do_all(galois::iterate((size_t)0, numBlocks),
+                 [&](size_t b) {
+                   size_t begin = b * compressedOffsetsBlock;
+                   size_t n = std::min(count - begin, compressedOffsetsBlock);
+                   blockEnds[b] = internal::encodeOffsetsBlock(
+                       mode, offsets.data() + begin, n, nullptr);
+                 },
+                 galois::no_stats());
+  std::partial_sum(blockEnds.begin(), blockEnds.end(), blockEnds.begin());
+
+  bytes.resize(numBlocks ? blockEnds[numBlocks - 1] : 0);
+  galois::do_all(galois::iterate((size_t)0, numBlocks),
+                 [&](size_t b) {
+                   size_t begin = b * compressedOffsetsBlock;
+                   size_t n = std::min(count - begin, compressedOffsetsBlock);
+                   uint8_t* out = bytes.data() + (b ? blockEnds[b - 1] : 0);
+                   internal::encodeOffsetsBlock(mode, offsets.data() + begin,
+                                                n, out);
+                 },
+                 galois::no_stats());
+}
+
+/**
+ * Decodes offsets coded by compressOffsets.
+ *
+ * @param mode mode the offsets were coded in
+ * @param count number of offsets
+ * @param blockEnds end of each block in bytes
+ * @param bytes coded blocks
+ * @param offsets OUTPUT: the count decoded offsets
+ */
+inline void
+decompressOffsets(DataCommMode mode, size_t count,
+                  const galois::PODResizeableArray<uint32_t>& blockEnds,
+                  const galois::PODResizeableArray<uint8_t>& bytes,
+                  galois::PODResizeableArray<unsigned int>& offsets) {
+  offsets.resize(count);
+  galois::do_all(galois::iterate((size_t)0, blockEnds.size()),
+                 [&](size_t b) {
+                   size_t begin = b * compressedOffsetsBlock;
+                   size_t n = std::min(count - begin, compressedOffsetsBlock);
+                   const uint8_t* in =
+                       bytes.data() + (b ? blockEnds[b - 1] : 0);
+                   internal::decodeOffsetsBlock(mode, in, n,
+                                                offsets.data() + begin);
+                 },
+                 galois::no_stats());
+}
+
+} // namespace runtime
+} // namespace galois
+
+#endif
@@ -28,6 +28,10 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 //! Enumeration of data communication modes that can be used in synchronization
 //! @todo document the enums in doxygen
 enum DataCommMode {
@@ -37,7 +41,9 @@ enum DataCommMode {
   gidsData,
   onlyData,
   dataSplitFirst, // NOT USED
-  dataSplit // NOT USED
+  dataSplit, // NOT USED
+  deltaOffsetsData, //!< offsets as varint coded gaps (CompressedOffsets.h)
+  bitsetRunsData    //!< runs of set bits as varint coded (gap, length) pairs
 };
 
 //! If this is set, then always used the data mode it is set to
@@ -84,3 +90,41 @@ DataCommMode get_data_mode(size_t num_selected, size_t num_total) {
   }
   return data_mode;
 }
+
+/**
+ * Variant of get_data_mode that also weighs the compressed metadata modes,
+ * whose sizes depend on the positions of the selected elements and so have
+ * to be measured by the caller (see compressedOffsetsSizes).
+ *
+ * @tparam DataType type of the data to be synchronized
+ *
+ * @param num_selected number of elements to send out (subset of num_total)
+ * @param num_total total number of elements that exist
+ * @param delta_offsets_size serialized size of the deltaOffsetsData metadata
+ * @param bitset_runs_size serialized size of the bitsetRunsData metadata
+ *
+ * @returns an appropriate DataCommMode to use for synchronization
+ */
+template <typename DataType>
+DataCommMode get_data_mode(size_t num_selected, size_t num_total,
+                           size_t delta_offsets_size,
+                           size_t bitset_runs_size) {
+  DataCommMode data_mode = get_data_mode<DataType>(num_selected, num_total);
+  if (enforce_data_mode != noData ||
+      (data_mode != bitsetData && data_mode != offsetsData)) {
+    return data_mode;
+  }
+
+  // the data is the same in all of these modes, so compare the metadata only
+  size_t bitsetSize =
+      ((num_total + 63) / 64) * sizeof(uint64_t) + (2 * sizeof(size_t));
+  size_t offsetsSize = (num_selected * sizeof(unsigned int)) + sizeof(size_t);
+  size_t plainSize   = std::min(bitsetSize, offsetsSize);
+  if (delta_offsets_size < plainSize &&
+      delta_offsets_size <= bitset_runs_size) {
+    data_mode = deltaOffsetsData;
+  } else if (bitset_runs_size < plainSize) {
+    data_mode = bitsetRunsData;
+  }
+  return data_mode;
+}
@@ -32,6 +32,14 @@ cll::opt<bool>
                       cll::desc("Do not use partition-aware optimizations"),
                       cll::init(false), cll::Hidden);
 
+//! Command line definition for overlapSync
+cll::opt<unsigned>
+    overlapSync("overlapSync",
+                cll::desc("Number of blocks to run do_all_sync loops in, "
+                          "sending to a host once its proxies are final "
+                          "(0 or 1 sends after the loop)"),
+                cll::init(0));
+
 // TODO: use enums
 //! Command line definition for enforce_metadata
 cll::opt<DataCommMode> enforce_metadata(
@@ -43,6 +51,10 @@ cll::opt<DataCommMode> enforce_metadata(
                 clEnumValN(offsetsData, "offsets",
                            "Use offsets metadata always"),
                 clEnumValN(gidsData, "gids", "Use global IDs metadata always"),
+                clEnumValN(deltaOffsetsData, "deltaoffsets",
+                           "Use varint coded offset gaps always"),
+                clEnumValN(bitsetRunsData, "bitsetruns",
+                           "Use run-length coded bitset always"),
                 clEnumValN(onlyData, "none",
                            "Do not use any metadata (sends "
                            "non-updated values)"),
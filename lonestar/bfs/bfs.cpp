@@ -22,7 +22,9 @@
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/Timer.h"
+#include "galois/DynamicBitset.h"
 #include "galois/graphs/LCGraph.h"
+#include "galois/graphs/B_LC_CSR_Graph.h"
 #include "galois/graphs/TypeTraits.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -61,10 +63,19 @@ static cll::opt<unsigned int>
 
 enum Exec { SERIAL, PARALLEL };
 
-enum Algo { AsyncTile = 0, Async, SyncTile, Sync, Sync2pTile, Sync2p };
+enum Algo {
+  AsyncTile = 0,
+  Async,
+  SyncTile,
+  Sync,
+  Sync2pTile,
+  Sync2p,
+  DirectionOpt
+};
 
-const char* const ALGO_NAMES[] = {"AsyncTile", "Async",      "SyncTile",
-                                  "Sync",      "Sync2pTile", "Sync2p"};
+const char* const ALGO_NAMES[] = {"AsyncTile", "Async",  "SyncTile",
+                                  "Sync",      "Sync2pTile", "Sync2p",
+                                  "DirectionOpt"};
 
 static cll::opt<Exec> execution(
     "exec",
@@ -78,20 +89,58 @@ static cll::opt<Algo> algo(
     cll::values(clEnumVal(AsyncTile, "AsyncTile"), clEnumVal(Async, "Async"),
                 clEnumVal(SyncTile, "SyncTile"), clEnumVal(Sync, "Sync"),
                 clEnumVal(Sync2pTile, "Sync2pTile"),
-                clEnumVal(Sync2p, "Sync2p"), clEnumValEnd),
+                clEnumVal(Sync2p, "Sync2p"),
+                clEnumVal(DirectionOpt,
+                          "DirectionOpt (push/pull switching; needs in-edges)"),
+                clEnumValEnd),
     cll::init(SyncTile));
 
-using Graph =
-    galois::graphs::LC_CSR_Graph<unsigned, void>::with_no_lockable<true>::type;
+//! Unsigned option parser that rejects 0 (alpha and beta are divisors)
+struct PositiveParser : public cll::parser<unsigned> {
+  bool parse(cll::Option& O, llvm::StringRef ArgName, llvm::StringRef Arg,
+             unsigned& Val) {
+    if (cll::parser<unsigned>::parse(O, ArgName, Arg, Val))
+      return true;
+    if (Val == 0)
+      return O.error("'" + Arg + "' value must be positive!");
+    return false;
+  }
+};
+
+static cll::opt<unsigned int, false, PositiveParser> alpha(
+    "alpha",
+    cll::desc("DirectionOpt: switch to bottom-up when frontier edges exceed "
+              "unexplored edges / alpha (default value 15)"),
+    cll::init(15));
+static cll::opt<unsigned int, false, PositiveParser> beta(
+    "beta",
+    cll::desc("DirectionOpt: switch back to top-down when frontier nodes "
+              "drop below nodes / beta (default value 18)"),
+    cll::init(18));
+
+static cll::opt<bool> compressed(
+    "compressed",
+    cll::desc("Load the graph delta/byte-coded (LC_Compressed_Graph); "
+              "supports Async and Sync only (default value false)"),
+    cll::init(false));
+
+// in-edges are only constructed when running DirectionOpt
+using Graph = galois::graphs::B_LC_CSR_Graph<unsigned, void, false, true>;
 //::with_numa_alloc<true>::type;
 
 using GNode = Graph::GraphNode;
 
+// used with -compressed; accepts .gr files and gr2compressedgr output
+using CompressedGraph =
+    galois::graphs::LC_Compressed_Graph<unsigned, void, true, true>;
+
 constexpr static const bool TRACK_WORK          = false;
 constexpr static const unsigned CHUNK_SIZE      = 256u;
 constexpr static const ptrdiff_t EDGE_TILE_SIZE = 256;
 
 using BFS = BFS_SSSP<Graph, unsigned int, false, EDGE_TILE_SIZE>;
+using CompressedBFS =
+    BFS_SSSP<CompressedGraph, unsigned int, false, EDGE_TILE_SIZE>;
 
 using UpdateRequest       = BFS::UpdateRequest;
 using Dist                = BFS::Dist;
@@ -158,8 +207,8 @@ struct OneTilePushWrap {
   }
 };
 
-template <bool CONCURRENT, typename T, typename P, typename R>
-void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
+template <bool CONCURRENT, typename T, typename P, typename R, typename G>
+void asyncAlgo(G& graph, GNode source, const P& pushWrap,
                const R& edgeRange) {
 
   namespace gwl = galois::worklists;
@@ -243,8 +292,8 @@ void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
   }
 }
 
-template <bool CONCURRENT, typename T, typename P, typename R>
-void syncAlgo(Graph& graph, GNode source, const P& pushWrap,
+template <bool CONCURRENT, typename T, typename P, typename R, typename G>
+void syncAlgo(G& graph, GNode source, const P& pushWrap,
               const R& edgeRange) {
 
   using Cont = typename std::conditional<CONCURRENT, galois::InsertBag<T>,
@@ -355,6 +404,153 @@ void sync2phaseAlgo(Graph& graph, GNode source, const P& pushWrap,
   }
 }
 
+/**
+ * Direction-optimizing BFS (Beamer et al., SC'12). Levels with a small
+ * frontier are expanded top-down (push over out-edges); once the frontier
+ * touches more than 1/alpha of the still unexplored edges, the search
+ * switches to bottom-up steps in which every unvisited node scans its
+ * in-edges for a parent in the current frontier. It switches back once the
+ * frontier shrinks below 1/beta of the nodes.
+ *
+ * Frontiers are kept as a node bag in top-down mode and as a bitset in
+ * bottom-up mode. Time spent on each level is reported as a stat.
+ */
+template <bool CONCURRENT>
+void directionOptAlgo(Graph& graph, GNode source) {
+
+  using Cont = typename std::conditional<CONCURRENT, galois::InsertBag<GNode>,
+                                         galois::SerStack<GNode>>::type;
+  using Loop = typename std::conditional<CONCURRENT, galois::DoAll,
+                                         galois::StdForEach>::type;
+
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  Loop loop;
+
+  Cont* curr = new Cont();
+  Cont* next = new Cont();
+
+  // allocated on the first switch to bottom-up
+  galois::DynamicBitSet* currBits = new galois::DynamicBitSet();
+  galois::DynamicBitSet* nextBits = new galois::DynamicBitSet();
+
+  galois::GAccumulator<size_t> awake;
+  galois::GAccumulator<size_t> frontierEdges;
+
+  auto outDegree = [&](GNode n) -> size_t {
+    return std::distance(graph.edge_begin(n, flag), graph.edge_end(n, flag));
+  };
+
+  const size_t numNodes = graph.size();
+  // edges still to be checked from unvisited nodes (m_u in the paper)
+  size_t unexploredEdges = graph.sizeEdges();
+  // edges to be checked from the current frontier (m_f)
+  size_t scoutEdges = outDegree(source);
+  size_t numActive  = 1;
+  size_t prevActive = 0;
+  bool bottomUp     = false;
+
+  Dist nextLevel              = 0u;
+  graph.getData(source, flag) = 0u;
+  next->push(source);
+
+  while (numActive != 0) {
+
+    if (!bottomUp && scoutEdges > unexploredEdges / alpha) {
+      if (currBits->size() != numNodes) {
+        currBits->resize(numNodes);
+        nextBits->resize(numNodes);
+      }
+      nextBits->reset();
+      loop(galois::iterate(*next), [&](const GNode& n) { nextBits->set(n); },
+           galois::loopname("DirOptBagToBitset"));
+      bottomUp = true;
+    } else if (bottomUp && numActive < numNodes / beta &&
+               numActive < prevActive) {
+      next->clear();
+      loop(galois::iterate(graph),
+           [&](const GNode& n) {
+             if (nextBits->test(n)) {
+               next->push(n);
+             }
+           },
+           galois::loopname("DirOptBitsetToBag"));
+      bottomUp = false;
+    }
+
+    ++nextLevel;
+    unexploredEdges -= std::min(unexploredEdges, scoutEdges);
+    awake.reset();
+    frontierEdges.reset();
+
+    galois::Timer levelTimer;
+    levelTimer.start();
+
+    if (bottomUp) {
+      std::swap(currBits, nextBits);
+      nextBits->reset();
+
+      loop(galois::iterate(graph),
+           [&](const GNode& n) {
+             auto& data = graph.getData(n, flag);
+             if (data != BFS::DIST_INFINITY) {
+               return;
+             }
+             for (auto e : graph.in_edges(n, flag)) {
+               if (currBits->test(graph.getInEdgeDst(e))) {
+                 data = nextLevel;
+                 nextBits->set(n);
+                 awake += 1;
+                 frontierEdges += outDegree(n);
+                 break;
+               }
+             }
+           },
+           galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+           galois::loopname("DirOptBottomUp"));
+    } else {
+      std::swap(curr, next);
+      next->clear();
+
+      loop(galois::iterate(*curr),
+           [&](const GNode& src) {
+             for (auto e : graph.edges(src, flag)) {
+               auto dst      = graph.getEdgeDst(e);
+               auto& dstData = graph.getData(dst, flag);
+
+               if (dstData == BFS::DIST_INFINITY) {
+                 dstData = nextLevel;
+                 next->push(dst);
+                 awake += 1;
+                 frontierEdges += outDegree(dst);
+               }
+             }
+           },
+           galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+           galois::loopname("DirOptTopDown"));
+    }
+
+    levelTimer.stop();
+
+    galois::runtime::reportStat_Single(
+        "BFS",
+        "Level" + std::to_string(nextLevel) +
+            (bottomUp ? "BottomUpTime" : "TopDownTime"),
+        levelTimer.get_usec());
+
+    prevActive = numActive;
+    numActive  = awake.reduce();
+    scoutEdges = frontierEdges.reduce();
+  }
+
+  galois::runtime::reportStat_Single("BFS", "Levels", nextLevel);
+
+  delete curr;
+  delete next;
+  delete currBits;
+  delete nextBits;
+}
+
 template <bool CONCURRENT>
 void runAlgo(Graph& graph, const GNode& source) {
 
@@ -383,22 +579,38 @@ void runAlgo(Graph& graph, const GNode& source) {
     sync2phaseAlgo<CONCURRENT>(graph, source, OneTilePushWrap{graph},
                                TileRangeFn());
     break;
+  case DirectionOpt:
+    directionOptAlgo<CONCURRENT>(graph, source);
+    break;
   default:
     std::cerr << "ERROR: unkown algo type" << std::endl;
   }
 }
 
-int main(int argc, char** argv) {
-  galois::SharedMemSys G;
-  LonestarStart(argc, argv, name, desc, url);
+//! Compressed edge iterators are forward-only, so tiling is not available
+template <bool CONCURRENT>
+void runAlgo(CompressedGraph& graph, const GNode& source) {
 
-  Graph graph;
-  GNode source, report;
+  switch (algo) {
+  case Async:
+    asyncAlgo<CONCURRENT, CompressedBFS::UpdateRequest>(
+        graph, source, CompressedBFS::ReqPushWrap(),
+        CompressedBFS::OutEdgeRangeFn{graph});
+    break;
+  case Sync:
+    syncAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
+                                CompressedBFS::OutEdgeRangeFn{graph});
+    break;
+  default:
+    GALOIS_DIE("-compressed supports only the Async and Sync algorithms");
+  }
+}
 
-  std::cout << "Reading from file: " << filename << std::endl;
-  galois::graphs::readGraph(graph, filename);
-  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
-            << " edges" << std::endl;
+template <typename G>
+void runBFS(G& graph) {
+  using Verifier = BFS_SSSP<G, unsigned int, false, EDGE_TILE_SIZE>;
+
+  GNode source, report;
 
   if (startNode >= graph.size() || reportNode >= graph.size()) {
     std::cerr << "failed to set report: " << reportNode
@@ -482,12 +694,42 @@ int main(int argc, char** argv) {
   galois::gInfo("Sum of visited distances is ", rDistanceSum);
 
   if (!skipVerify) {
-    if (BFS::verify(graph, source)) {
+    if (Verifier::verify(graph, source)) {
       std::cout << "Verification successful.\n";
     } else {
       GALOIS_DIE("Verification failed");
     }
   }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url);
+
+  if (compressed && algo != Async && algo != Sync) {
+    GALOIS_DIE("-compressed supports only the Async and Sync algorithms");
+  }
+
+  std::cout << "Reading from file: " << filename << std::endl;
+
+  if (compressed) {
+    CompressedGraph graph;
+    galois::graphs::readGraph(graph, filename);
+    std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+              << " edges (" << graph.sizeEdgeBytes() << " bytes coded)"
+              << std::endl;
+    runBFS(graph);
+  } else {
+    Graph graph;
+    galois::graphs::readGraph(graph, filename);
+    std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+              << " edges" << std::endl;
+
+    if (algo == DirectionOpt) {
+      graph.constructIncomingEdges();
+    }
+    runBFS(graph);
+  }
 
   return 0;
 }
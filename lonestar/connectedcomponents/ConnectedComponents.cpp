@@ -35,6 +35,8 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <random>
+#include <unordered_map>
 
 #include <ostream>
 #include <fstream>
@@ -50,7 +52,8 @@ enum Algo {
   blockedasync,
   labelProp,
   serial,
-  synchronous
+  synchronous,
+  afforest
 };
 
 enum OutputEdgeType { void_, int32_, int64_ };
@@ -90,9 +93,22 @@ static cll::opt<Algo> algo(
                            "Using label propagation algorithm"),
                 clEnumValN(Algo::serial, "Serial", "Serial"),
                 clEnumValN(Algo::synchronous, "Sync", "Synchronous"),
+                clEnumValN(Algo::afforest, "Afforest",
+                           "Using neighbor sampling and giant component "
+                           "skipping"),
 
                 clEnumValEnd),
     cll::init(Algo::edgetiledasync));
+static cll::opt<unsigned int>
+    neighborSampleSize("neighborSampleSize",
+                       cll::desc("Number of edges per node that Afforest "
+                                 "links before finding the giant component"),
+                       cll::init(2));
+static cll::opt<unsigned int>
+    componentSampleSize("componentSampleSize",
+                        cll::desc("Number of nodes Afforest samples to find "
+                                  "the giant component"),
+                        cll::init(1024));
 
 struct Node : public galois::UnionFindNode<Node> {
   using component_type = Node*;
@@ -578,6 +594,102 @@ struct BlockedAsyncAlgo {
   }
 };
 
+/**
+ * Afforest: link a few sampled edges of every node, which usually puts most
+ * of the nodes into one giant component, then find that component by
+ * sampling nodes and link the remaining edges only of nodes outside of it.
+ * Edges between the giant component and other nodes are still linked from
+ * the other side, which needs a symmetric graph.
+ */
+struct AfforestAlgo {
+  using Graph =
+      galois::graphs::LC_CSR_Graph<Node, void>::with_no_lockable<true>::type;
+  using GNode = Graph::GraphNode;
+
+  template <typename G>
+  void readGraph(G& graph) {
+    galois::graphs::readGraph(graph, inputFilename);
+  }
+
+  void compress(Graph& graph, const char* loopname) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          Node& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
+          sdata.compress();
+        },
+        galois::steal(), galois::loopname(loopname));
+  }
+
+  //! Most frequent component among sampled nodes; nodes are compressed
+  Node* approxLargestComponent(Graph& graph) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<GNode> dist(0, graph.size() - 1);
+    std::unordered_map<Node*, unsigned> counts;
+    for (unsigned i = 0; i < componentSampleSize; ++i) {
+      Node& sdata = graph.getData(dist(gen), galois::MethodFlag::UNPROTECTED);
+      ++counts[sdata.component()];
+    }
+    return std::max_element(counts.begin(), counts.end(),
+                            [](const std::pair<Node*, unsigned>& a,
+                               const std::pair<Node*, unsigned>& b) {
+                              return a.second < b.second;
+                            })
+        ->first;
+  }
+
+  void operator()(Graph& graph) {
+    if (graph.size() == 0)
+      return;
+
+    for (unsigned r = 0; r < neighborSampleSize; ++r) {
+      galois::do_all(
+          galois::iterate(graph),
+          [&](const GNode& src) {
+            Graph::edge_iterator ii =
+                graph.edge_begin(src, galois::MethodFlag::UNPROTECTED) + r;
+            if (ii >= graph.edge_end(src, galois::MethodFlag::UNPROTECTED))
+              return;
+            Node& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
+            Node& ddata = graph.getData(graph.getEdgeDst(ii),
+                                        galois::MethodFlag::UNPROTECTED);
+            sdata.merge(&ddata);
+          },
+          galois::loopname("CC-Afforest-Sample"));
+    }
+    compress(graph, "CC-Afforest-Sample-Compress");
+
+    Node* giant = approxLargestComponent(graph);
+    galois::GAccumulator<size_t> skipped;
+
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          Node& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
+          if (sdata.component() == giant) {
+            skipped += 1;
+            return;
+          }
+
+          Graph::edge_iterator ii =
+              graph.edge_begin(src, galois::MethodFlag::UNPROTECTED);
+          Graph::edge_iterator ei =
+              graph.edge_end(src, galois::MethodFlag::UNPROTECTED);
+          ii += std::min<ptrdiff_t>(neighborSampleSize, ei - ii);
+          for (; ii != ei; ++ii) {
+            Node& ddata = graph.getData(graph.getEdgeDst(ii),
+                                        galois::MethodFlag::UNPROTECTED);
+            sdata.merge(&ddata);
+          }
+        },
+        galois::steal(), galois::loopname("CC-Afforest-Finish"));
+    compress(graph, "CC-Afforest-Compress");
+
+    galois::runtime::reportStat_Single("CC-Afforest", "SkippedNodes",
+                                       skipped.reduce());
+  }
+};
+
 template <typename Graph>
 bool verify(
     Graph& graph,
@@ -759,6 +871,9 @@ int main(int argc, char** argv) {
   case Algo::synchronous:
     run<SynchronousAlgo>();
     break;
+  case Algo::afforest:
+    run<AfforestAlgo>();
+    break;
 
   default:
     std::cerr << "Unknown algorithm\n";
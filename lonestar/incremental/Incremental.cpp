@@ -0,0 +1,731 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/UnionFind.h"
+#include "galois/graphs/EdgeList.h"
+#include "galois/graphs/LC_Dynamic_Graph.h"
+#include "galois/graphs/Util.h"
+#include "llvm/Support/CommandLine.h"
+
+#include "Lonestar/BoilerPlate.h"
+#include "Lonestar/BFS_SSSP.h"
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Incremental BFS, SSSP and Connected Components";
+static const char* desc =
+    "Applies batches of edge updates, random or read from edge list files, "
+    "to a graph and maintains BFS levels, shortest path distances or "
+    "connected components by re-running only from the vertices affected by "
+    "each batch";
+static const char* url = 0;
+
+static cll::opt<std::string>
+    filename(cll::Positional, cll::desc("<input graph>"), cll::Required);
+
+enum Algo { bfs, sssp, cc };
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(clEnumVal(bfs, "BFS levels from startNode"),
+                clEnumVal(sssp, "Shortest path distances from startNode"),
+                clEnumVal(cc, "Connected components (symmetric input)"),
+                clEnumValEnd),
+    cll::init(sssp));
+
+static cll::opt<unsigned int>
+    startNode("startNode",
+              cll::desc("Node to start search from (default value 0)"),
+              cll::init(0));
+static cll::opt<unsigned int>
+    stepShift("delta",
+              cll::desc("Shift value for the deltastep (default value 13)"),
+              cll::init(13));
+static cll::opt<unsigned int>
+    numBatches("numBatches",
+               cll::desc("Number of update batches (default value 4)"),
+               cll::init(4));
+static cll::opt<unsigned int>
+    batchSize("batchSize",
+              cll::desc("Edge updates per batch (default value 1000)"),
+              cll::init(1000));
+static cll::opt<unsigned int> deletePercent(
+    "deletePercent",
+    cll::desc("Percentage of the updates in a batch that delete an existing "
+              "edge (default value 0)"),
+    cll::init(0));
+static cll::opt<unsigned int>
+    maxWeight("maxWeight",
+              cll::desc("Inserted SSSP edges get weights in [1, maxWeight] "
+                        "(default value 100)"),
+              cll::init(100));
+static cll::opt<unsigned int>
+    seed("seed", cll::desc("Seed for the random batches (default value 0)"),
+         cll::init(0));
+static cll::opt<std::string> updatesFile(
+    "updates",
+    cll::desc("Edge list (\"src dst [weight]\" per line; sssp needs the "
+              "weight) of edges to insert, -batchSize lines per batch, "
+              "instead of random batches"),
+    cll::init(""));
+static cll::opt<std::string> deletionsFile(
+    "deletions",
+    cll::desc("Edge list of edges to delete, -batchSize lines per batch, "
+              "instead of random batches"),
+    cll::init(""));
+static cll::opt<std::string> priorFile(
+    "prior",
+    cll::desc("\"node value\" lines holding the distances (bfs, sssp) or "
+              "component labels (cc) of the input graph; replaces the "
+              "initial computation"),
+    cll::init(""));
+static cll::opt<std::string> resultFile(
+    "resultFile",
+    cll::desc("Writes the final distances or labels in the format read by "
+              "-prior"),
+    cll::init(""));
+
+constexpr static const unsigned CHUNK_SIZE = 64u;
+
+namespace gwl = galois::worklists;
+
+/**
+ * Batch number batch of the update files: the edges on its batchSize lines
+ * of each list. Symmetric batches also update the reverse of every edge.
+ */
+template <typename Problem, typename UpdateList>
+void fileBatch(Problem& problem, const UpdateList& toInsert,
+               const galois::graphs::EdgeList<void>& toDelete,
+               unsigned batch,
+               std::vector<typename Problem::Graph::EdgeUpdate>& insertions,
+               std::vector<typename Problem::Graph::EdgeDeletion>& deletions) {
+  const uint64_t beg = uint64_t(batch) * batchSize;
+
+  insertions.clear();
+  deletions.clear();
+  for (uint64_t e = beg; e < std::min(beg + batchSize, toInsert.size()); ++e) {
+    uint32_t src = toInsert.src(e), dst = toInsert.dst(e);
+    insertions.push_back(problem.makeUpdate(src, dst, toInsert, e));
+    if (Problem::symmetric)
+      insertions.push_back(problem.makeUpdate(dst, src, toInsert, e));
+  }
+  for (uint64_t e = beg; e < std::min(beg + batchSize, toDelete.size()); ++e) {
+    deletions.emplace_back(toDelete.src(e), toDelete.dst(e));
+    if (Problem::symmetric)
+      deletions.emplace_back(toDelete.dst(e), toDelete.src(e));
+  }
+}
+
+/**
+ * Reads a file of "node value" lines, as written by writeResultFile, and
+ * calls setValue(node, value) for each. Dies on malformed lines and on
+ * nodes that are not in the graph.
+ */
+template <typename SetValue>
+void readResultFile(const std::string& filename, size_t numNodes,
+                    SetValue setValue) {
+  std::ifstream in(filename);
+  if (!in.is_open())
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+  uint64_t node, value;
+  while (in >> node >> value) {
+    if (node >= numNodes)
+      GALOIS_DIE("node ", node, " in ", filename, " is not in the graph");
+    setValue(node, value);
+  }
+  if (!in.eof())
+    GALOIS_DIE("malformed line in ", filename);
+}
+
+//! Writes "node value" lines for the nodes that have a value
+template <typename Graph, typename HasValue, typename Value>
+void writeResultFile(const std::string& filename, Graph& graph,
+                     HasValue hasValue, Value value) {
+  std::ofstream out(filename);
+  for (auto n : graph) {
+    if (hasValue(n))
+      out << n << " " << value(n) << "\n";
+  }
+  if (!out)
+    GALOIS_SYS_DIE("failed writing to ", "'", filename, "'");
+}
+
+/**
+ * Random batch of batchSize updates. A deletePercent share of them removes an
+ * edge that is in the graph; the rest insert edges made by makeUpdate.
+ * Symmetric batches also update the reverse of every edge.
+ */
+template <typename Graph, typename MakeUpdate>
+void makeBatch(Graph& graph, std::mt19937& gen, bool symmetric,
+               MakeUpdate makeUpdate,
+               std::vector<typename Graph::EdgeUpdate>& insertions,
+               std::vector<typename Graph::EdgeDeletion>& deletions) {
+  typedef typename Graph::GraphNode GNode;
+  std::uniform_int_distribution<GNode> node(0, graph.size() - 1);
+  std::uniform_int_distribution<unsigned> percent(0, 99);
+
+  insertions.clear();
+  deletions.clear();
+  for (unsigned i = 0; i < batchSize; ++i) {
+    GNode src = node(gen);
+    if (percent(gen) < deletePercent) {
+      // a few tries to find a node with edges
+      for (unsigned t = 0; t < 8 && !graph.getDegree(src); ++t)
+        src = node(gen);
+      if (!graph.getDegree(src))
+        continue;
+      std::uniform_int_distribution<uint64_t> edge(0, graph.getDegree(src) -
+                                                          1);
+      auto e    = graph.edge_begin(src, galois::MethodFlag::UNPROTECTED) +
+               edge(gen);
+      GNode dst = graph.getEdgeDst(e);
+      deletions.emplace_back(src, dst);
+      if (symmetric)
+        deletions.emplace_back(dst, src);
+    } else {
+      GNode dst = node(gen);
+      insertions.push_back(makeUpdate(src, dst));
+      if (symmetric)
+        insertions.push_back(makeUpdate(dst, src));
+    }
+  }
+}
+
+/**
+ * BFS levels or shortest path distances from a source kept in the node
+ * data. After insertions, only the targets of inserted edges that got
+ * shorter seed the delta-stepping loop.
+ *
+ * Deleting an edge that no shortest path uses changes nothing. Otherwise
+ * distances can only grow, which relaxation cannot do, so the nodes below
+ * the deleted edge in the shortest path DAG are reset and seeded from their
+ * unaffected in-neighbors before relaxing. The graph has no in-edges, so
+ * seeding scans the out-edges of all unaffected nodes once.
+ */
+template <bool UseWeights>
+struct Distances {
+  using Graph = typename galois::graphs::LC_Dynamic_Graph<
+      std::atomic<uint32_t>, uint32_t>::template with_no_lockable<true>::type::
+      template with_numa_alloc<true>::type;
+  using GNode                = typename Graph::GraphNode;
+  using BS                   = BFS_SSSP<Graph, uint32_t, UseWeights>;
+  using Dist                 = typename BS::Dist;
+  using UpdateRequest        = typename BS::UpdateRequest;
+  using UpdateRequestIndexer = typename BS::UpdateRequestIndexer;
+  using OBIM =
+      gwl::OrderedByIntegerMetric<UpdateRequestIndexer,
+                                  gwl::PerSocketChunkFIFO<CHUNK_SIZE>>;
+  //! edge list read with -updates; only sssp reads weights
+  using UpdateList = galois::graphs::EdgeList<
+      typename std::conditional<UseWeights, uint32_t, void>::type>;
+
+  static const bool symmetric = false;
+
+  Graph& graph;
+  GNode source;
+  //! targets of deleted edges that were on shortest paths
+  galois::InsertBag<GNode> lostParent;
+  //! nodes whose distance is being recomputed
+  galois::LargeArray<std::atomic<bool>> invalid;
+
+  Distances(Graph& g, GNode s) : graph(g), source(s) {
+    invalid.allocateInterleaved(graph.size());
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { invalid.constructAt(n, false); },
+                   galois::no_stats());
+  }
+
+  Dist weight(typename Graph::edge_iterator e) {
+    return UseWeights ? graph.getEdgeData(e) : 1;
+  }
+
+  Dist weight(const typename Graph::EdgeUpdate& u) {
+    return UseWeights ? u.get() : 1;
+  }
+
+  template <typename C>
+  void relax(C& initial) {
+    galois::for_each(
+        galois::iterate(initial),
+        [&](const UpdateRequest& req, auto& ctx) {
+          constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+          const Dist sdist = graph.getData(req.src, flag);
+          if (sdist < req.dist)
+            return;
+          for (auto e : graph.edges(req.src, flag)) {
+            GNode dst          = graph.getEdgeDst(e);
+            const Dist newDist = sdist + weight(e);
+            if (galois::atomicMin(graph.getData(dst, flag), newDist) >
+                newDist)
+              ctx.push(UpdateRequest(dst, newDist));
+          }
+        },
+        galois::wl<OBIM>(
+            UpdateRequestIndexer{UseWeights ? unsigned(stepShift) : 0u}),
+        galois::no_conflicts(), galois::loopname("Relax"));
+  }
+
+  void recompute() {
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n) = BS::DIST_INFINITY; },
+                   galois::no_stats(), galois::loopname("Reset"));
+    graph.getData(source) = 0;
+    std::vector<UpdateRequest> initial(1, UpdateRequest(source, 0));
+    relax(initial);
+  }
+
+  /**
+   * Called before the batch is applied. Remembers the targets of deleted
+   * edges that were on shortest paths.
+   *
+   * @returns false; deletions never need a recomputation
+   */
+  bool beforeBatch(const std::vector<typename Graph::EdgeDeletion>& del) {
+    galois::do_all(
+        galois::iterate(del),
+        [&](const typename Graph::EdgeDeletion& d) {
+          Dist sdist = graph.getData(d.first);
+          if (sdist == BS::DIST_INFINITY || d.second == source)
+            return;
+          for (auto e : graph.edges(d.first, galois::MethodFlag::UNPROTECTED)) {
+            if (graph.getEdgeDst(e) == d.second &&
+                sdist + weight(e) == graph.getData(d.second)) {
+              lostParent.push(d.second);
+              break;
+            }
+          }
+        },
+        galois::no_stats(), galois::loopname("CheckDeletions"));
+    return false;
+  }
+
+  //! Resets the nodes below lostParent and pushes their new distances
+  template <typename C>
+  void invalidate(C& initial) {
+    constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+    galois::InsertBag<GNode> affected;
+    galois::for_each(
+        galois::iterate(lostParent),
+        [&](GNode n, auto& ctx) {
+          if (n == source || invalid[n].exchange(true))
+            return;
+          affected.push(n);
+          const Dist sdist = graph.getData(n, flag);
+          for (auto e : graph.edges(n, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (!invalid[dst] && graph.getData(dst, flag) == sdist + weight(e))
+              ctx.push(dst);
+          }
+        },
+        galois::wl<gwl::PerSocketChunkFIFO<CHUNK_SIZE>>(),
+        galois::no_conflicts(), galois::loopname("Invalidate"));
+    lostParent.clear();
+
+    galois::GAccumulator<size_t> numAffected;
+    galois::do_all(galois::iterate(affected),
+                   [&](GNode n) {
+                     graph.getData(n) = BS::DIST_INFINITY;
+                     numAffected += 1;
+                   },
+                   galois::no_stats(), galois::loopname("ResetInvalid"));
+    galois::runtime::reportStat_Tsum("Incremental", "Invalidated",
+                                     numAffected.reduce());
+
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode src) {
+          const Dist sdist = graph.getData(src, flag);
+          if (invalid[src] || sdist == BS::DIST_INFINITY)
+            return;
+          for (auto e : graph.edges(src, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (!invalid[dst])
+              continue;
+            const Dist newDist = sdist + weight(e);
+            if (galois::atomicMin(graph.getData(dst, flag), newDist) >
+                newDist)
+              initial.push(UpdateRequest(dst, newDist));
+          }
+        },
+        galois::steal(), galois::no_stats(), galois::loopname("SeedInvalid"));
+
+    galois::do_all(galois::iterate(affected),
+                   [&](GNode n) { invalid[n] = false; }, galois::no_stats(),
+                   galois::loopname("ClearInvalid"));
+  }
+
+  void update(const std::vector<typename Graph::EdgeUpdate>& insertions) {
+    galois::InsertBag<UpdateRequest> initial;
+    if (!lostParent.empty())
+      invalidate(initial);
+    galois::do_all(galois::iterate(insertions),
+                   [&](const typename Graph::EdgeUpdate& u) {
+                     Dist sdist = graph.getData(u.src);
+                     if (sdist == BS::DIST_INFINITY)
+                       return;
+                     Dist newDist = sdist + weight(u);
+                     if (galois::atomicMin(graph.getData(u.dst), newDist) >
+                         newDist)
+                       initial.push(UpdateRequest(u.dst, newDist));
+                   },
+                   galois::no_stats(), galois::loopname("SeedInsertions"));
+    relax(initial);
+  }
+
+  //! Compares the maintained distances with a recomputation
+  bool verify() {
+    std::vector<Dist> maintained(graph.size());
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { maintained[n] = graph.getData(n); },
+                   galois::no_stats());
+    galois::StatTimer timer("Recompute");
+    timer.start();
+    recompute();
+    timer.stop();
+
+    galois::GAccumulator<size_t> wrong;
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     if (maintained[n] != graph.getData(n))
+                       wrong += 1;
+                   },
+                   galois::no_stats());
+    if (wrong.reduce())
+      std::cerr << wrong.reduce() << " nodes with incorrect distance\n";
+    return !wrong.reduce() && BS::verify(graph, source);
+  }
+
+  typename Graph::EdgeUpdate makeUpdate(GNode src, GNode dst,
+                                        std::mt19937& gen) {
+    std::uniform_int_distribution<uint32_t> w(1, maxWeight);
+    return typename Graph::EdgeUpdate(src, dst, UseWeights ? w(gen) : 1);
+  }
+
+  typename Graph::EdgeUpdate
+  makeUpdate(GNode src, GNode dst, const galois::graphs::EdgeList<uint32_t>& l,
+             uint64_t e) {
+    return typename Graph::EdgeUpdate(src, dst, l.data(e));
+  }
+
+  typename Graph::EdgeUpdate
+  makeUpdate(GNode src, GNode dst, const galois::graphs::EdgeList<void>&,
+             uint64_t) {
+    return typename Graph::EdgeUpdate(src, dst, 1);
+  }
+
+  //! Nodes missing from the file are unreached
+  void readResults(const std::string& filename) {
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n) = BS::DIST_INFINITY; },
+                   galois::no_stats());
+    readResultFile(filename, graph.size(), [&](GNode n, uint64_t d) {
+      if (d > BS::DIST_INFINITY)
+        GALOIS_DIE("distance ", d, " of node ", n, " is out of range");
+      graph.getData(n) = d;
+    });
+  }
+
+  void writeResults(const std::string& filename) {
+    writeResultFile(
+        filename, graph,
+        [&](GNode n) { return graph.getData(n) != BS::DIST_INFINITY; },
+        [&](GNode n) { return Dist(graph.getData(n)); });
+  }
+
+  void report() {
+    galois::GReduceMax<Dist> maxDist;
+    galois::GAccumulator<size_t> reached;
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     Dist d = graph.getData(n);
+                     if (d != BS::DIST_INFINITY) {
+                       maxDist.update(d);
+                       reached += 1;
+                     }
+                   },
+                   galois::no_stats());
+    galois::gInfo("# visited nodes is ", reached.reduce());
+    galois::gInfo("Max distance is ", maxDist.reduce());
+  }
+};
+
+struct Component : public galois::UnionFindNode<Component> {
+  Component() : galois::UnionFindNode<Component>(this) {}
+  void reset() { m_component = this; }
+};
+
+/**
+ * Connected components as union-find trees in the node data. Inserted
+ * edges merge the trees of their endpoints. A deleted edge may split a
+ * component, which union-find cannot undo, so batches with deletions
+ * recompute from scratch.
+ */
+struct Components {
+  using Graph = galois::graphs::LC_Dynamic_Graph<Component, void>::
+      with_no_lockable<true>::type::with_numa_alloc<true>::type;
+  using GNode      = Graph::GraphNode;
+  using UpdateList = galois::graphs::EdgeList<void>;
+
+  static const bool symmetric = true;
+
+  Graph& graph;
+
+  Components(Graph& g, GNode) : graph(g) {}
+
+  void recompute() {
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n).reset(); },
+                   galois::no_stats(), galois::loopname("Reset"));
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode src) {
+          auto& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
+          for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (src < dst)
+              sdata.merge(&graph.getData(dst, galois::MethodFlag::UNPROTECTED));
+          }
+        },
+        galois::steal(), galois::loopname("Merge"));
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n).compress(); },
+                   galois::no_stats(), galois::loopname("Compress"));
+  }
+
+  //! @returns true if the batch must be recomputed from scratch
+  bool beforeBatch(const std::vector<Graph::EdgeDeletion>& deletions) {
+    return !deletions.empty();
+  }
+
+  void update(const std::vector<Graph::EdgeUpdate>& insertions) {
+    galois::do_all(galois::iterate(insertions),
+                   [&](const Graph::EdgeUpdate& u) {
+                     graph.getData(u.src).merge(&graph.getData(u.dst));
+                   },
+                   galois::no_stats(), galois::loopname("MergeInsertions"));
+    galois::do_all(galois::iterate(insertions),
+                   [&](const Graph::EdgeUpdate& u) {
+                     graph.getData(u.src).compress();
+                     graph.getData(u.dst).compress();
+                   },
+                   galois::no_stats(), galois::loopname("CompressInsertions"));
+  }
+
+  size_t numComponents() {
+    galois::GAccumulator<size_t> reps;
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     if (graph.getData(n).isRep())
+                       reps += 1;
+                   },
+                   galois::no_stats());
+    return reps.reduce();
+  }
+
+  /**
+   * The endpoints of every edge must share a component and there must be
+   * as many components as after a recomputation.
+   */
+  bool verify() {
+    galois::GReduceLogicalOR split;
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode src) {
+                     auto* rep = graph.getData(src).find();
+                     for (auto e : graph.edges(src)) {
+                       if (graph.getData(graph.getEdgeDst(e)).find() != rep)
+                         split.update(true);
+                     }
+                   },
+                   galois::no_stats());
+    size_t maintained = numComponents();
+
+    galois::StatTimer timer("Recompute");
+    timer.start();
+    recompute();
+    timer.stop();
+
+    size_t expected = numComponents();
+    if (split.reduce())
+      std::cerr << "edge between different components\n";
+    if (maintained != expected)
+      std::cerr << maintained << " components, expected " << expected << "\n";
+    return !split.reduce() && maintained == expected;
+  }
+
+  Graph::EdgeUpdate makeUpdate(GNode src, GNode dst, std::mt19937&) {
+    return Graph::EdgeUpdate(src, dst);
+  }
+
+  Graph::EdgeUpdate makeUpdate(GNode src, GNode dst, const UpdateList&,
+                               uint64_t) {
+    return Graph::EdgeUpdate(src, dst);
+  }
+
+  //! A label is any node of the component; nodes missing from the file are
+  //! alone in theirs
+  void readResults(const std::string& filename) {
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n).reset(); },
+                   galois::no_stats());
+    readResultFile(filename, graph.size(), [&](GNode n, uint64_t label) {
+      if (label >= graph.size())
+        GALOIS_DIE("label ", label, " of node ", n, " is not a node");
+      graph.getData(n).merge(&graph.getData(label));
+    });
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) { graph.getData(n).compress(); },
+                   galois::no_stats());
+  }
+
+  //! Labels each node with the smallest node of its component
+  void writeResults(const std::string& filename) {
+    std::unordered_map<const Component*, GNode> label;
+    writeResultFile(
+        filename, graph, [](GNode) { return true; },
+        [&](GNode n) {
+          return label.emplace(graph.getData(n).find(), n).first->second;
+        });
+  }
+
+  void report() { galois::gInfo("# components is ", numComponents()); }
+};
+
+template <typename Problem>
+void run() {
+  typename Problem::Graph graph;
+  std::cout << "Reading from file: " << filename << std::endl;
+  galois::graphs::readGraph(graph, filename);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges" << std::endl;
+
+  if (startNode >= graph.size()) {
+    std::cerr << "failed to set source: " << startNode << "\n";
+    abort();
+  }
+
+  Problem problem(graph, startNode);
+  if (!priorFile.empty()) {
+    galois::StatTimer load("LoadPrior");
+    load.start();
+    problem.readResults(priorFile);
+    load.stop();
+    if (!skipVerify && !problem.verify())
+      GALOIS_DIE("results in ", priorFile, " do not match ", filename);
+  } else {
+    galois::StatTimer initial("Initial");
+    initial.start();
+    problem.recompute();
+    initial.stop();
+  }
+  problem.report();
+
+  // update files replace the random batches; each batch takes the next
+  // batchSize lines of both files until they run out
+  const bool fromFiles = !updatesFile.empty() || !deletionsFile.empty();
+  typename Problem::UpdateList toInsert;
+  galois::graphs::EdgeList<void> toDelete;
+  unsigned batches = numBatches;
+  if (fromFiles) {
+    if (!batchSize)
+      GALOIS_DIE("-batchSize must be positive with update files");
+    if (!updatesFile.empty())
+      toInsert.readText(updatesFile);
+    if (!deletionsFile.empty())
+      toDelete.readText(deletionsFile);
+    uint64_t lines = std::max(toInsert.size(), toDelete.size());
+    batches        = (lines + batchSize - 1) / batchSize;
+  }
+
+  std::mt19937 gen(seed);
+  std::vector<typename Problem::Graph::EdgeUpdate> insertions;
+  std::vector<typename Problem::Graph::EdgeDeletion> deletions;
+  galois::StatTimer update("Update");
+  size_t recomputed = 0;
+
+  for (unsigned batch = 0; batch < batches; ++batch) {
+    if (fromFiles) {
+      fileBatch(problem, toInsert, toDelete, batch, insertions, deletions);
+    } else {
+      makeBatch(graph, gen, Problem::symmetric,
+                [&](uint32_t src, uint32_t dst) {
+                  return problem.makeUpdate(src, dst, gen);
+                },
+                insertions, deletions);
+    }
+
+    update.start();
+    bool full = problem.beforeBatch(deletions);
+    graph.applyBatch(insertions, deletions);
+    if (full) {
+      problem.recompute();
+      ++recomputed;
+    } else {
+      problem.update(insertions);
+    }
+    update.stop();
+
+    std::cout << "Batch " << batch << ": " << insertions.size()
+              << " insertions, " << deletions.size() << " deletions"
+              << (full ? ", recomputed" : "") << "\n";
+
+    if (!skipVerify) {
+      if (!problem.verify())
+        GALOIS_DIE("Verification failed after batch ", batch);
+    }
+  }
+
+  galois::runtime::reportStat_Single("Incremental", "Recomputed", recomputed);
+  problem.report();
+  if (!resultFile.empty())
+    problem.writeResults(resultFile);
+  if (!skipVerify)
+    std::cout << "Verification successful.\n";
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url);
+
+  switch (algo) {
+  case bfs:
+    run<Distances<false>>();
+    break;
+  case sssp:
+    run<Distances<true>>();
+    break;
+  case cc:
+    run<Components>();
+    break;
+  default:
+    std::abort();
+  }
+  return 0;
+}
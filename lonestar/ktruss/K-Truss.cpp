@@ -23,7 +23,9 @@
 #include "galois/Timer.h"
 #include "galois/Timer.h"
 #include "galois/graphs/Graph.h"
+#include "galois/graphs/EdgeIndex.h"
 #include "galois/graphs/TypeTraits.h"
+#include "galois/SetIntersection.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/BoilerPlate.h"
 
@@ -32,6 +34,7 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 enum Algo {
   bspJacobi,
@@ -153,43 +156,58 @@ void reportKTruss(Graph& g) {
   }
 }
 
-template <typename G>
-bool isSupportNoLessThanJ(G& g, typename G::GraphNode src,
-                          typename G::GraphNode dst, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI            = g.edge_begin(src, galois::MethodFlag::UNPROTECTED),
-       srcE            = g.edge_end(src, galois::MethodFlag::UNPROTECTED),
-       dstI            = g.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
-       dstE            = g.edge_end(dst, galois::MethodFlag::UNPROTECTED);
-
-  while (true) {
-    // find the first valid edge
-    while (srcI != srcE && (g.getEdgeData(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.getEdgeData(dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
+/**
+ * Calls fn on each common neighbor of src and dst whose edges from both src
+ * and dst are still valid, in increasing order, until fn returns false.
+ * Edges must be sorted by destination.
+ */
+template <typename G, typename F>
+void forValidCommonNeighbors(G& g, typename G::GraphNode src,
+                             typename G::GraphNode dst, F fn,
+                             galois::MethodFlag flag) {
+  using GNode = typename G::GraphNode;
+  // intersect windows of the shorter list so that fn can stop early
+  constexpr size_t window = 64;
+  uint32_t posA[window], posB[window];
+
+  auto aI = g.edge_begin(src, flag), aE = g.edge_end(src, flag),
+       bI = g.edge_begin(dst, flag), bE = g.edge_end(dst, flag);
+  const GNode* a = g.edge_dst_begin(src);
+  const GNode* b = g.edge_dst_begin(dst);
+  size_t na = std::distance(aI, aE), nb = std::distance(bI, bE);
+  if (nb < na) {
+    std::swap(aI, bI);
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
 
-    // check for intersection
-    auto sN = g.getEdgeDst(srcI), dN = g.getEdgeDst(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
+  for (size_t i = 0, j = 0; i < na && j < nb;) {
+    size_t wa  = std::min(window, na - i);
+    size_t end = std::upper_bound(b + j, b + nb, a[i + wa - 1]) - b;
+    size_t num =
+        galois::intersectPositions(a + i, wa, b + j, end - j, posA, posB);
+
+    for (size_t k = 0; k < num; ++k) {
+      if (!(g.getEdgeData(aI + i + posA[k]) & removed) &&
+          !(g.getEdgeData(bI + j + posB[k]) & removed) &&
+          !fn(a[i + posA[k]])) {
+        return;
       }
-      ++srcI;
-      ++dstI;
     }
+    i += wa;
+    j = end;
   }
+}
+
+template <typename G>
+bool isSupportNoLessThanJ(G& g, typename G::GraphNode src,
+                          typename G::GraphNode dst, unsigned int j) {
+  size_t numValidEqual = 0;
+  forValidCommonNeighbors(g, src, dst,
+                          [&](typename G::GraphNode) {
+                            return ++numValidEqual < j;
+                          },
+                          galois::MethodFlag::UNPROTECTED);
   return numValidEqual >= j;
 }
 
@@ -247,6 +265,10 @@ struct BSPTrussJacobiAlgo {
                    },
                    galois::steal());
 
+    galois::graphs::EdgeIndex<Graph> index(g);
+    std::vector<Edge> queries;
+    std::vector<Graph::edge_iterator> edges;
+
     while (true) {
       galois::do_all(galois::iterate(*cur), PickUnsupportedEdges{g, k - 2, unsupported, *next},
                      galois::steal());
@@ -256,12 +278,15 @@ struct BSPTrussJacobiAlgo {
       }
 
       // mark unsupported edges as removed
-      galois::do_all(galois::iterate(unsupported),
-                     [&g](Edge e) {
-                       g.getEdgeData(g.findEdgeSortedByDst(e.first, e.second)) =
-                           removed;
-                       g.getEdgeData(g.findEdgeSortedByDst(e.second, e.first)) =
-                           removed;
+      queries.clear();
+      for (Edge e : unsupported) {
+        queries.push_back(e);
+        queries.emplace_back(e.second, e.first);
+      }
+      index.findEdges(queries, edges);
+      galois::do_all(galois::iterate(edges),
+                     [&g](Graph::edge_iterator e) {
+                       g.getEdgeData(e) = removed;
                      },
                      galois::steal());
 
@@ -290,18 +315,20 @@ struct BSPTrussAlgo {
 
   struct KeepSupportedEdges {
     Graph& g;
+    galois::graphs::EdgeIndex<Graph>& index;
     unsigned int j;
     EdgeVec& s;
 
-    KeepSupportedEdges(Graph& g, unsigned int j, EdgeVec& s)
-        : g(g), j(j), s(s) {}
+    KeepSupportedEdges(Graph& g, galois::graphs::EdgeIndex<Graph>& index,
+                       unsigned int j, EdgeVec& s)
+        : g(g), index(index), j(j), s(s) {}
 
     void operator()(Edge e) {
       if (isSupportNoLessThanJ(g, e.first, e.second, j)) {
         s.push_back(e);
       } else {
-        g.getEdgeData(g.findEdgeSortedByDst(e.first, e.second)) = removed;
-        g.getEdgeData(g.findEdgeSortedByDst(e.second, e.first)) = removed;
+        g.getEdgeData(index.findEdge(e.first, e.second)) = removed;
+        g.getEdgeData(index.findEdge(e.second, e.first)) = removed;
       }
     }
   };
@@ -330,9 +357,12 @@ struct BSPTrussAlgo {
                    galois::steal());
     curSize = std::distance(cur->begin(), cur->end());
 
+    galois::graphs::EdgeIndex<Graph> index(g);
+
     // remove unsupported edges until no more edges can be removed
     while (true) {
-      galois::do_all(galois::iterate(*cur), KeepSupportedEdges{g, k - 2, *next},
+      galois::do_all(galois::iterate(*cur),
+                     KeepSupportedEdges{g, index, k - 2, *next},
                      galois::steal());
       nextSize = std::distance(next->begin(), next->end());
 
@@ -461,35 +491,13 @@ getValidCommonNeighbors(G& g, typename G::GraphNode src,
                         galois::MethodFlag flag = galois::MethodFlag::WRITE) {
   using GNode = typename G::GraphNode;
 
-  auto srcI = g.edge_begin(src, flag), srcE = g.edge_end(src, flag),
-       dstI = g.edge_begin(dst, flag), dstE = g.edge_end(dst, flag);
   std::deque<GNode, PerIterAlloc<GNode>> commonNeighbors(a);
-
-  while (true) {
-    // find the first valid edge
-    while (srcI != srcE && (g.getEdgeData(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.getEdgeData(dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      break;
-    }
-
-    // check for intersection
-    auto sN = g.getEdgeDst(srcI), dN = g.getEdgeDst(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      commonNeighbors.push_back(sN);
-      ++srcI;
-      ++dstI;
-    }
-  }
+  forValidCommonNeighbors(g, src, dst,
+                          [&](GNode n) {
+                            commonNeighbors.push_back(n);
+                            return true;
+                          },
+                          flag);
   return commonNeighbors;
 }
 
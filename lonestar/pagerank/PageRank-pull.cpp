@@ -22,21 +22,33 @@
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
 #include "galois/Timer.h"
+#include "galois/graphs/GraphHelpers.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/TypeTraits.h"
 #include "galois/gstl.h"
 
+#include <vector>
+
 const char* desc =
     "Computes page ranks a la Page and Brin. This is a pull-style algorithm.";
 
-enum Algo { Topo = 0, Residual };
-const char* const ALGO_NAMES[] = {"Topological", "Residual"};
+enum Algo { Topo = 0, Residual, PB };
+const char* const ALGO_NAMES[] = {"Topological", "Residual",
+                                  "PropagationBlocking"};
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(clEnumVal(Topo, "Topological"),
+                clEnumVal(Residual, "Residual"),
+                clEnumVal(PB, "Topological with propagation blocking"),
+                clEnumValEnd),
+    cll::init(Residual));
 
-static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
-                           cll::values(clEnumVal(Topo, "Topological"),
-                                       clEnumVal(Residual, "Residual"),
-                                       clEnumValEnd),
-                           cll::init(Residual));
+static cll::opt<unsigned> blockSize(
+    "blockSize",
+    cll::desc("Destination nodes per block for -algo=PB, rounded down to a "
+              "power of 2; ranks of a block should fit in L2 (default 65536)"),
+    cll::init(1 << 16));
 
 constexpr static const unsigned CHUNK_SIZE = 32;
 
@@ -228,6 +240,160 @@ void computePRTopological(Graph& graph) {
   }
 }
 
+/**
+ * Contribution bins for propagation blocking. Destinations are split into
+ * blocks of 2^blockShift nodes; bin (b, t) holds the contributions thread t
+ * makes to nodes of block b. The bins of a block are adjacent, so a block is
+ * accumulated from a single contiguous range, and the destination of every
+ * entry is fixed by the topology and filled in once.
+ */
+struct PBBins {
+  unsigned numThreads;
+  uint32_t numBlocks;
+  unsigned blockShift;
+  //! nodes whose contributions thread t bins
+  std::vector<uint32_t> threadRanges;
+  //! start of bin (b, t) at b * numThreads + t
+  std::vector<uint64_t> offsets;
+  galois::LargeArray<uint32_t> dst;
+  galois::LargeArray<PRTy> contrib;
+
+  uint32_t block(GNode n) const { return n >> blockShift; }
+
+  //! @returns write position of each of thread tid's bins
+  std::vector<uint64_t> cursors(unsigned tid) const {
+    std::vector<uint64_t> c(numBlocks);
+    for (uint32_t b = 0; b < numBlocks; ++b) {
+      c[b] = offsets[b * numThreads + tid];
+    }
+    return c;
+  }
+};
+
+//! graph must hold out-edges (i.e., the transpose of the input)
+void initBins(Graph& graph, PBBins& bins) {
+  galois::StatTimer binTimer("initBinsFunc");
+  binTimer.start();
+
+  bins.numThreads = galois::getActiveThreads();
+  bins.blockShift = 0;
+  while (bins.blockShift < 31 && (2u << bins.blockShift) <= blockSize) {
+    ++bins.blockShift;
+  }
+  bins.numBlocks =
+      (graph.size() + (1ul << bins.blockShift) - 1) >> bins.blockShift;
+  bins.threadRanges =
+      galois::graphs::determineUnitRangesFromGraph(graph, bins.numThreads);
+
+  const unsigned numThreads = bins.numThreads;
+  std::vector<uint64_t> counts(bins.numBlocks * numThreads + 1, 0);
+  galois::on_each([&](unsigned tid, unsigned) {
+    for (GNode src = bins.threadRanges[tid]; src < bins.threadRanges[tid + 1];
+         ++src) {
+      for (auto nbr : graph.edges(src)) {
+        counts[bins.block(graph.getEdgeDst(nbr)) * numThreads + tid] += 1;
+      }
+    }
+  });
+
+  bins.offsets.resize(counts.size());
+  uint64_t total = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    bins.offsets[i] = total;
+    total += counts[i];
+  }
+
+  bins.dst.allocateInterleaved(graph.sizeEdges());
+  bins.contrib.allocateInterleaved(graph.sizeEdges());
+  galois::on_each([&](unsigned tid, unsigned) {
+    std::vector<uint64_t> cursor = bins.cursors(tid);
+    for (GNode src = bins.threadRanges[tid]; src < bins.threadRanges[tid + 1];
+         ++src) {
+      for (auto nbr : graph.edges(src)) {
+        GNode dst                           = graph.getEdgeDst(nbr);
+        bins.dst[cursor[bins.block(dst)]++] = dst;
+      }
+    }
+  });
+
+  binTimer.stop();
+}
+
+/**
+ * Topological PageRank with propagation blocking. Instead of gathering the
+ * ranks of in-neighbors from random addresses, each node's contribution is
+ * pushed along its out-edges into bins by destination block (sequential
+ * writes to a few streams per thread), and the bins are then summed one
+ * block at a time so the sums being updated stay in cache. Unlike
+ * computePRTopological, a round only sees ranks from the previous round.
+ */
+void computePRBlocked(Graph& graph, PBBins& bins, DeltaArray& sum) {
+  unsigned int iteration = 0;
+  galois::GReduceMax<float> max_delta;
+  constexpr const galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  while (true) {
+    galois::on_each(
+        [&](unsigned tid, unsigned) {
+          std::vector<uint64_t> cursor = bins.cursors(tid);
+          for (GNode src = bins.threadRanges[tid];
+               src < bins.threadRanges[tid + 1]; ++src) {
+            auto ii = graph.edge_begin(src, flag);
+            auto ei = graph.edge_end(src, flag);
+            if (ii == ei) {
+              continue;
+            }
+            LNode& sdata = graph.getData(src, flag);
+            PRTy contrib = sdata.value / sdata.nout;
+            for (; ii != ei; ++ii) {
+              bins.contrib[cursor[bins.block(graph.getEdgeDst(ii))]++] =
+                  contrib;
+            }
+          }
+        },
+        galois::loopname("PageRank_bin"));
+
+    galois::do_all(
+        galois::iterate(0u, bins.numBlocks),
+        [&](uint32_t b) {
+          uint64_t end = bins.offsets[(b + 1) * bins.numThreads];
+          for (uint64_t i = bins.offsets[b * bins.numThreads]; i < end; ++i) {
+            sum[bins.dst[i]] += bins.contrib[i];
+          }
+
+          GNode first = b << bins.blockShift;
+          GNode last  = std::min<uint64_t>(graph.size(),
+                                          uint64_t(b + 1) << bins.blockShift);
+          for (GNode n = first; n < last; ++n) {
+            LNode& ndata = graph.getData(n, flag);
+            float value  = sum[n] * ALPHA + (1.0 - ALPHA);
+            max_delta.update(std::fabs(value - ndata.value));
+            ndata.value = value;
+            sum[n]      = 0;
+          }
+        },
+        galois::no_stats(), galois::steal(), galois::chunk_size<1>(),
+        galois::loopname("PageRank_accumulate"));
+
+    float delta = max_delta.reduce();
+
+#if DEBUG
+    std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
+#endif
+
+    iteration += 1;
+    if (delta <= tolerance || iteration >= maxIterations) {
+      break;
+    }
+    max_delta.reset();
+  } // end while(true)
+
+  if (iteration >= maxIterations) {
+    std::cerr << "ERROR: failed to converge in " << iteration << " iterations"
+              << std::endl;
+  }
+}
+
 void prTopological(Graph& graph) {
   initNodeDataTopological(graph);
   computeOutDeg(graph);
@@ -251,6 +417,30 @@ void prResidual(Graph& graph) {
   prTimer.stop();
 }
 
+void prBlocked(Graph& graph) {
+  initNodeDataTopological(graph);
+  // bins are filled along out-edges, so go back to the original graph
+  graph.transpose("PageRank");
+  galois::do_all(galois::iterate(graph),
+                 [&](const GNode& n) {
+                   graph.getData(n, galois::MethodFlag::UNPROTECTED).nout =
+                       std::distance(graph.edge_begin(n), graph.edge_end(n));
+                 },
+                 galois::no_stats(), galois::loopname("CopyDeg"));
+
+  PBBins bins;
+  initBins(graph, bins);
+  DeltaArray sum;
+  sum.allocateInterleaved(graph.size());
+  galois::do_all(galois::iterate(graph), [&](const GNode& n) { sum[n] = 0; },
+                 galois::no_stats(), galois::loopname("InitSum"));
+
+  galois::StatTimer prTimer;
+  prTimer.start();
+  computePRBlocked(graph, bins, sum);
+  prTimer.stop();
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url);
@@ -287,6 +477,14 @@ int main(int argc, char** argv) {
     prResidual(transposeGraph);
     break;
   }
+  case PB: {
+    std::cout << "Running Pull Topological version with propagation blocking, "
+                 "tolerance:"
+              << tolerance << ", maxIterations:" << maxIterations
+              << ", blockSize:" << blockSize << "\n";
+    prBlocked(transposeGraph);
+    break;
+  }
   default: { std::abort(); }
   }
 
@@ -64,12 +64,16 @@ enum Algo {
   dijkstraTile,
   dijkstra,
   topo,
-  topoTile
+  topoTile,
+  multiQueueTile,
+  multiQueue
 };
 
-const char* const ALGO_NAMES[] = {"deltaTile", "deltaStep",    "serDeltaTile",
-                                  "serDelta",  "dijkstraTile", "dijkstra",
-                                  "topo",      "topoTile"};
+const char* const ALGO_NAMES[] = {"deltaTile",      "deltaStep",
+                                  "serDeltaTile",   "serDelta",
+                                  "dijkstraTile",   "dijkstra",
+                                  "topo",           "topoTile",
+                                  "multiQueueTile", "multiQueue"};
 
 static cll::opt<Algo>
     algo("algo", cll::desc("Choose an algorithm:"),
@@ -79,7 +83,9 @@ static cll::opt<Algo>
                      clEnumVal(serDelta, "serDelta"),
                      clEnumVal(dijkstraTile, "dijkstraTile"),
                      clEnumVal(dijkstra, "dijkstra"), clEnumVal(topo, "topo"),
-                     clEnumVal(topoTile, "topoTile"), clEnumValEnd),
+                     clEnumVal(topoTile, "topoTile"),
+                     clEnumVal(multiQueueTile, "multiQueueTile"),
+                     clEnumVal(multiQueue, "multiQueue"), clEnumValEnd),
          cll::init(deltaTile));
 
 // typedef galois::graphs::LC_InlineEdge_Graph<std::atomic<unsigned int>,
@@ -105,7 +111,13 @@ using ReqPushWrap          = SSSP::ReqPushWrap;
 using OutEdgeRangeFn       = SSSP::OutEdgeRangeFn;
 using TileRangeFn          = SSSP::TileRangeFn;
 
-template <typename T, typename P, typename R>
+namespace gwl = galois::worklists;
+
+using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
+using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+using MQ      = gwl::MultiQueue<UpdateRequestIndexer>;
+
+template <typename WL, typename T, typename P, typename R>
 void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
                    const R& edgeRange) {
 
@@ -114,11 +126,6 @@ void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
   //! [reducible for self-defined stats]
   galois::GAccumulator<size_t> WLEmptyWork;
 
-  namespace gwl = galois::worklists;
-
-  using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
-  using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
-
   graph.getData(source) = 0;
 
   galois::InsertBag<T> initBag;
@@ -167,7 +174,7 @@ void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
                        }
                      }
                    },
-                   galois::wl<OBIM>(UpdateRequestIndexer{stepShift}),
+                   galois::wl<WL>(UpdateRequestIndexer{stepShift}),
                    galois::no_conflicts(), galois::loopname("SSSP"));
 
   if (TRACK_WORK) {
@@ -410,12 +417,20 @@ int main(int argc, char** argv) {
 
   switch (algo) {
   case deltaTile:
-    deltaStepAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
-                               TileRangeFn());
+    deltaStepAlgo<OBIM, SrcEdgeTile>(graph, source,
+                                     SrcEdgeTilePushWrap{graph}, TileRangeFn());
     break;
   case deltaStep:
-    deltaStepAlgo<UpdateRequest>(graph, source, ReqPushWrap(),
-                                 OutEdgeRangeFn{graph});
+    deltaStepAlgo<OBIM, UpdateRequest>(graph, source, ReqPushWrap(),
+                                       OutEdgeRangeFn{graph});
+    break;
+  case multiQueueTile:
+    deltaStepAlgo<MQ, SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
+                                   TileRangeFn());
+    break;
+  case multiQueue:
+    deltaStepAlgo<MQ, UpdateRequest>(graph, source, ReqPushWrap(),
+                                     OutEdgeRangeFn{graph});
     break;
   case serDeltaTile:
     serDeltaAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
@@ -23,6 +23,7 @@
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/ParallelSTL.h"
+#include "galois/SetIntersection.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/BoilerPlate.h"
 
@@ -90,30 +91,6 @@ Iterator lowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t countEqual(G& g, typename G::edge_iterator aa,
-                  typename G::edge_iterator ea, typename G::edge_iterator bb,
-                  typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::GraphNode a = g.getEdgeDst(aa);
-    typename G::GraphNode b = g.getEdgeDst(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   G& g;
@@ -236,7 +213,8 @@ void nodeIteratingAlgo(Graph& graph) {
 }
 
 /*
- * Simple counting loop, instead of binary searching.
+ * Simple counting loop, instead of binary searching: for each neighbor v <= n
+ * of n, counts the common neighbors of n and v that are no larger than v.
  */
 void orderedCountAlgo(Graph& graph) {
 
@@ -244,24 +222,20 @@ void orderedCountAlgo(Graph& graph) {
         galois::do_all(
             galois::iterate(graph),
             [&](const GNode& n) {
-              for(auto it_v : graph.edges(n)){
-                auto v = graph.getEdgeDst(it_v);
+              const GNode* nbegin = graph.edge_dst_begin(n);
+              const GNode* nend   = graph.edge_dst_end(n);
+
+              for (const GNode* it_v = nbegin; it_v != nend; ++it_v) {
+                auto v = *it_v;
                 if( v > n)
                   break;
-                Graph::edge_iterator it_n =
-                    graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
-
-                for(auto it_vv : graph.edges(v)){
-                  auto vv = graph.getEdgeDst(it_vv);
-                  //std::cout << "-- vv : " << vv << "\n";
-                  if( vv > v)
-                    break;
-                  while(graph.getEdgeDst(it_n) < vv)
-                    it_n++;
-                  if(vv == graph.getEdgeDst(it_n)) {
-                    numTriangles += 1;
-                  }
-                }
+                const GNode* vbegin = graph.edge_dst_begin(v);
+                const GNode* vend =
+                    std::upper_bound(vbegin, graph.edge_dst_end(v), v);
+
+                // neighbors of n up to and including v
+                numTriangles += galois::intersectCount(
+                    nbegin, it_v - nbegin + 1, vbegin, vend - vbegin);
               }
             },
             galois::chunk_size<CHUNK_SIZE>(),
@@ -315,25 +289,17 @@ void edgeIteratingAlgo(Graph& graph) {
             [&](const WorkItem& w) {
               // Compute intersection of range (w.src, w.dst) in neighbors of
               // w.src and w.dst
-              Graph::edge_iterator abegin =
-                  graph.edge_begin(w.src, galois::MethodFlag::UNPROTECTED);
-              Graph::edge_iterator aend =
-                  graph.edge_end(w.src, galois::MethodFlag::UNPROTECTED);
-              Graph::edge_iterator bbegin =
-                  graph.edge_begin(w.dst, galois::MethodFlag::UNPROTECTED);
-              Graph::edge_iterator bend =
-                  graph.edge_end(w.dst, galois::MethodFlag::UNPROTECTED);
-
-              Graph::edge_iterator aa = lowerBound(
-                  abegin, aend, GreaterThanOrEqual<Graph>(graph, w.src));
-              Graph::edge_iterator ea =
-                  lowerBound(abegin, aend, LessThan<Graph>(graph, w.dst));
-              Graph::edge_iterator bb = lowerBound(
-                  bbegin, bend, GreaterThanOrEqual<Graph>(graph, w.src));
-              Graph::edge_iterator eb =
-                  lowerBound(bbegin, bend, LessThan<Graph>(graph, w.dst));
+              const GNode* abegin = graph.edge_dst_begin(w.src);
+              const GNode* aend   = graph.edge_dst_end(w.src);
+              const GNode* bbegin = graph.edge_dst_begin(w.dst);
+              const GNode* bend   = graph.edge_dst_end(w.dst);
 
-              numTriangles += countEqual(graph, aa, ea, bb, eb);
+              const GNode* aa = std::upper_bound(abegin, aend, w.src);
+              const GNode* ea = std::lower_bound(aa, aend, w.dst);
+              const GNode* bb = std::upper_bound(bbegin, bend, w.src);
+              const GNode* eb = std::lower_bound(bb, bend, w.dst);
+
+              numTriangles += galois::intersectCount(aa, ea - aa, bb, eb - bb);
             },
             galois::loopname("edgeIteratingAlgo"),
             galois::chunk_size<CHUNK_SIZE>(),
@@ -423,6 +389,10 @@ int main(int argc, char** argv) {
                                     galois::runtime::pagePoolSize());
   galois::reportPageAlloc("MeminfoPre");
 
+  galois::runtime::reportParam(
+      "Triangles", "IntersectKernel",
+      galois::intersectKernelName(galois::intersectKernel()));
+
   galois::StatTimer T;
   T.start();
   // case by case preAlloc to avoid allocating unnecessarily
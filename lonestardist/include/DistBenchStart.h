@@ -148,10 +148,6 @@ loadDGraph(std::vector<unsigned>& scaleFactor,
 
   dGraphTimer.stop();
 
-  // Save local graph structure
-  //if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
-
   return loadedGraph;
 }
 
@@ -193,10 +189,6 @@ loadSymmetricDGraph(std::vector<unsigned>& scaleFactor,
 
   dGraphTimer.stop();
 
-  // Save local graph structure
-  //if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
-
   return loadedGraph;
 }
 
@@ -122,6 +122,28 @@ namespace graphs {
  * Graph-loading functions
  ******************************************************************************/
 
+/**
+ * Partitions the input graph of the command line with CuSP, reading and
+ * saving local graph files as the command line asks.
+ *
+ * @tparam PartitionPolicy CuSP policy to partition with
+ * @tparam NodeData node data to store in graph
+ * @tparam EdgeData edge data to store in graph
+ * @param inputType whether the input is the graph (CSR) or its transpose (CSC)
+ * @param outputType whether to construct the graph or its transpose
+ * @param symmetricGraph true if the input graph is symmetric
+ * @returns a pointer to a newly allocated DistGraph
+ */
+template <typename PartitionPolicy, typename NodeData, typename EdgeData>
+DistGraph<NodeData, EdgeData>*
+cuspPartitionInput(galois::CUSP_GRAPH_TYPE inputType,
+                   galois::CUSP_GRAPH_TYPE outputType, bool symmetricGraph) {
+  return cuspPartitionGraph<PartitionPolicy, NodeData, EdgeData>(
+      inputFile, inputType, outputType, symmetricGraph, inputFileTranspose,
+      true, 100, galois::graphs::BALANCED_EDGES_OF_MASTERS, 0, 0, readFromFile,
+      localGraphFileName, saveLocalGraph);
+}
+
 /**
  * Loads a symmetric graph file (i.e. directed graph with edges in both
  * directions)
@@ -143,19 +165,19 @@ constructSymmetricGraph(std::vector<unsigned>& scaleFactor) {
   switch (partitionScheme) {
   case OEC:
   case IEC:
-    return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
   case HOVC:
   case HIVC:
-    return cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
 
   case CART_VCUT:
   case CART_VCUT_IEC:
-    return cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
 
   //case CEC:
@@ -164,19 +186,19 @@ constructSymmetricGraph(std::vector<unsigned>& scaleFactor) {
 
   case GINGER_O:
   case GINGER_I:
-    return cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
 
   case FENNEL_O:
   case FENNEL_I:
-    return cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
 
   case SUGAR_O:
-    return cuspPartitionGraph<SugarP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    return cuspPartitionInput<SugarP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, true
     );
   default:
     GALOIS_DIE("Error: partition scheme specified is invalid");
@@ -204,20 +226,20 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
   // 1 host = no concept of cut; just load from edgeCut, no transpose
   auto& net = galois::runtime::getSystemNetworkInterface();
   if (net.Num == 1) {
-    return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
   }
 
   switch (partitionScheme) {
   case OEC:
-    return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
   case IEC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSR, false
       );
     } else {
       GALOIS_DIE("Error: attempting incoming edge cut without transpose "
@@ -226,13 +248,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case HOVC:
-    return cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
   case HIVC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSR, false
       );
     } else {
       GALOIS_DIE("Error: attempting incoming hybrid cut without transpose "
@@ -241,14 +263,14 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case CART_VCUT:
-    return cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
 
   case CART_VCUT_IEC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GenericCVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      return cuspPartitionInput<GenericCVC, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSR, false
       );
     } else {
       GALOIS_DIE("Error: attempting cvc incoming cut without "
@@ -261,13 +283,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
   //                                 scaleFactor, vertexIDMapFileName, false);
 
   case GINGER_O:
-    return cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
   case GINGER_I:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSR, false
       );
     } else {
       GALOIS_DIE("Error: attempting Ginger without transpose graph");
@@ -275,13 +297,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case FENNEL_O:
-    return cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
   case FENNEL_I:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSR, false
       );
     } else {
       GALOIS_DIE("Error: attempting Fennel incoming without transpose graph");
@@ -289,8 +311,8 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case SUGAR_O:
-    return cuspPartitionGraph<SugarP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    return cuspPartitionInput<SugarP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSR, false
     );
 
   default:
@@ -322,29 +344,29 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
   // 1 host = no concept of cut; just load from edgeCut
   if (net.Num == 1) {
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       fprintf(stderr, "WARNING: Loading transpose graph through in-memory "
                       "transpose to iterate over in-edges: pass in transpose "
                       "graph with -graphTranspose to avoid unnecessary "
                       "overhead.\n");
-      return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSR, galois::CUSP_CSC, false
       );
     }
   }
 
   switch (partitionScheme) {
   case OEC:
-    return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
   case IEC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<NoCommunication, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<NoCommunication, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       GALOIS_DIE("Error: attempting incoming edge cut without transpose "
@@ -353,13 +375,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case HOVC:
-    return cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
   case HIVC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GenericHVC, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<GenericHVC, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       GALOIS_DIE("Error: (hivc) iterate over in-edges without transpose graph");
@@ -367,13 +389,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case CART_VCUT:
-    return cuspPartitionGraph<GenericCVCColumnFlip, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<GenericCVCColumnFlip, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
   case CART_VCUT_IEC:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GenericCVCColumnFlip, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<GenericCVCColumnFlip, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       GALOIS_DIE("Error: (cvc) iterate over in-edges without transpose graph");
@@ -391,13 +413,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
   //  }
 
   case GINGER_O:
-    return cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
   case GINGER_I:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<GingerP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<GingerP, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       GALOIS_DIE("Error: attempting Ginger without transpose graph");
@@ -405,13 +427,13 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case FENNEL_O:
-    return cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
   case FENNEL_I:
     if (inputFileTranspose.size()) {
-      return cuspPartitionGraph<FennelP, NodeData, EdgeData>(
-        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      return cuspPartitionInput<FennelP, NodeData, EdgeData>(
+        galois::CUSP_CSC, galois::CUSP_CSC, false
       );
     } else {
       GALOIS_DIE("Error: attempting Fennel incoming without transpose graph");
@@ -419,8 +441,8 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
     }
 
   case SUGAR_O:
-    return cuspPartitionGraph<SugarColumnFlipP, NodeData, EdgeData>(
-      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    return cuspPartitionInput<SugarColumnFlipP, NodeData, EdgeData>(
+      galois::CUSP_CSR, galois::CUSP_CSC, false
     );
 
   default:
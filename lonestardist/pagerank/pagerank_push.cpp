@@ -244,18 +244,18 @@ struct PageRank {
         PageRank_nodesWithEdges_cuda(__retval, cuda_ctx);
         dga += __retval;
         StatTimer_cuda.stop();
+        syncSubstrate->sync<writeDestination, readSource, Reduce_add_residual,
+                    Bitset_residual, async>("PageRank");
       } else if (personality == CPU)
 #endif
       {
-        galois::do_all(
-            galois::iterate(nodesWithEdges), PageRank{&_graph, dga},
+        syncSubstrate->do_all_sync<writeDestination, readSource,
+                    Reduce_add_residual, Bitset_residual, async>(
+            "PageRank", nodesWithEdges, PageRank{&_graph, dga},
             galois::no_stats(), galois::steal(),
             galois::loopname(syncSubstrate->get_run_identifier("PageRank").c_str()));
       }
 
-      syncSubstrate->sync<writeDestination, readSource, Reduce_add_residual,
-                  Bitset_residual, async>("PageRank");
-
       galois::runtime::reportStat_Tsum(
           REGION_NAME, "NumWorkItems_" + (syncSubstrate->get_run_identifier()),
           (unsigned long)dga.read_local());
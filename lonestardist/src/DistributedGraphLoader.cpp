@@ -66,18 +66,19 @@ cll::opt<PARTITIONING_SCHEME> partitionScheme(
 //                        cll::init(""), cll::Hidden);
 
 cll::opt<bool> readFromFile("readFromFile",
-                            cll::desc("Set this flag if graph is to be "
-                                      "constructed from file (file must be "
-                                      "created by Abelian CSR)"),
-                            cll::init(false), cll::Hidden);
+                            cll::desc("Load the partition of each host from "
+                                      "the local graph files of an earlier "
+                                      "-saveLocalGraph run with the same "
+                                      "input, hosts and partitioning"),
+                            cll::init(false));
 
 cll::opt<std::string>
     localGraphFileName("localGraphFileName",
-                       cll::desc("Name of the local file to construct "
-                                 "local graph (file must be created by "
-                                 "Abelian CSR)"),
-                       cll::init("local_graph"), cll::Hidden);
+                       cll::desc("Prefix of the local graph files; the host "
+                                 "ID is appended to it"),
+                       cll::init("local_graph"));
 
 cll::opt<bool> saveLocalGraph("saveLocalGraph",
-                              cll::desc("Set to save the local CSR graph"),
-                              cll::init(false), cll::Hidden);
+                              cll::desc("Save the partition of each host to a "
+                                        "local graph file"),
+                              cll::init(false));
@@ -225,19 +225,19 @@ struct SSSP {
         dga += __retval;
         work_edges += __retval2;
         StatTimer_cuda.stop();
+        syncSubstrate->sync<writeDestination, readSource,
+                    Reduce_min_dist_current, Bitset_dist_current, async>("SSSP");
       } else if (personality == CPU)
 #endif
       {
-        galois::do_all(
-            galois::iterate(nodesWithEdges), SSSP{priority, &_graph, dga, work_edges},
+        syncSubstrate->do_all_sync<writeDestination, readSource,
+                    Reduce_min_dist_current, Bitset_dist_current, async>(
+            "SSSP", nodesWithEdges, SSSP{priority, &_graph, dga, work_edges},
             galois::no_stats(),
             galois::loopname(syncSubstrate->get_run_identifier("SSSP").c_str()),
             galois::steal());
       }
 
-      syncSubstrate->sync<writeDestination, readSource, Reduce_min_dist_current,
-                  Bitset_dist_current, async>("SSSP");
-
       galois::runtime::reportStat_Tsum(
           "SSSP", "NumWorkItems_" + (syncSubstrate->get_run_identifier()),
           (unsigned long)work_edges.read_local());
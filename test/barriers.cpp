@@ -20,6 +20,7 @@
 #include "galois/Timer.h"
 #include "galois/Galois.h"
 #include "galois/substrate/Barrier.h"
+#include "galois/substrate/ThreadPool.h"
 
 #include <iostream>
 #include <cstdlib>
@@ -54,6 +55,8 @@ struct emp {
 };
 
 void test(std::unique_ptr<galois::substrate::Barrier> b) {
+  if (!b) // not available on this platform
+    return;
   unsigned M = numThreads;
   if (M > 16)
     M /= 2;
@@ -65,8 +68,32 @@ void test(std::unique_ptr<galois::substrate::Barrier> b) {
     emp e{*b.get()};
     galois::on_each(e);
     t.stop();
+    // total ms and per-round latency in ns
     std::cout << bname << "," << b->name() << "," << M << "," << t.get()
-              << "\n";
+              << "," << t.get_usec() * 1000.0 / iter << "\n";
+    M -= 1;
+  }
+}
+
+//! Rounds of ThreadPool::runRounds, whose barrier release starts each round
+void testRounds() {
+  auto& pool = galois::substrate::getThreadPool();
+  unsigned M = numThreads;
+  if (M > 16)
+    M /= 2;
+  while (M) {
+    std::atomic<unsigned> work(0);
+    galois::Timer t;
+    t.start();
+    pool.runRounds(M, [&](unsigned) { work += 1; },
+                   [&](unsigned round) {
+                     // every thread must have finished this round
+                     GALOIS_ASSERT(work == M * (round + 1));
+                     return round + 1 < iter;
+                   });
+    t.stop();
+    std::cout << bname << ",FusedRounds," << M << "," << t.get() << ","
+              << t.get_usec() * 1000.0 / iter << "\n";
     M -= 1;
   }
 }
@@ -79,6 +106,9 @@ int main(int argc, char** argv) {
     iter = 16 * 1024;
   if (argc > 2)
     numThreads = galois::substrate::getThreadPool().getMaxThreads();
+  // barriers index per-thread state, so never go beyond the machine
+  numThreads = std::min(numThreads,
+                        galois::substrate::getThreadPool().getMaxThreads());
 
   gethostname(bname, sizeof(bname));
   using namespace galois::substrate;
@@ -87,5 +117,6 @@ int main(int argc, char** argv) {
   test(createMCSBarrier(1));
   test(createTopoBarrier(1));
   test(createDisseminationBarrier(1));
+  testRounds();
   return 0;
 }
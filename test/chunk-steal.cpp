@@ -0,0 +1,112 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/worklists/Chunk.h"
+#include "galois/gIO.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+//! Every socket steals from every other socket exactly once, nearest first
+void testStealOrder() {
+  auto& tp = galois::substrate::getThreadPool();
+  for (unsigned pid = 0; pid < tp.getMaxSockets(); ++pid) {
+    auto& order = tp.getStealOrder(pid);
+    GALOIS_ASSERT(order.size() == tp.getMaxSockets() - 1);
+    unsigned node = galois::substrate::getHWTopo()
+                        .second[tp.getLeaderForSocket(pid)]
+                        .osNumaNode;
+    std::set<unsigned> seen;
+    unsigned last = 0;
+    for (unsigned leader : order) {
+      GALOIS_ASSERT(tp.isLeader(leader) && tp.getSocket(leader) != pid);
+      GALOIS_ASSERT(seen.insert(tp.getSocket(leader)).second);
+      unsigned d = galois::substrate::getNumaDistance(
+          node, galois::substrate::getHWTopo().second[leader].osNumaNode);
+      GALOIS_ASSERT(last <= d, "socket ", pid, " steals far before near");
+      last = d;
+    }
+  }
+}
+
+//! Pushes all items from one thread and pops them from all threads, so that
+//! threads on other sockets have to steal; each item must come out once
+template <typename WL>
+void testWorklist(unsigned numThreads, unsigned numItems) {
+  galois::setActiveThreads(numThreads);
+  WL wl;
+  std::vector<std::atomic<unsigned>> seen(numItems);
+  for (auto& s : seen)
+    s = 0;
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    if (tid != 0)
+      return;
+    for (unsigned i = 0; i < numItems; ++i)
+      wl.push(i);
+    wl.flush();
+  });
+  galois::on_each([&](unsigned, unsigned) {
+    while (auto item = wl.pop())
+      seen[*item] += 1;
+  });
+
+  GALOIS_ASSERT(!wl.pop());
+  for (unsigned i = 0; i < numItems; ++i)
+    GALOIS_ASSERT(seen[i] == 1, "item ", i, " popped ", seen[i].load(),
+                  " times with ", numThreads, " threads");
+}
+
+//! A loop with stats reports where its chunks came from
+void testForEach(unsigned numThreads, unsigned numItems) {
+  galois::setActiveThreads(numThreads);
+  galois::GAccumulator<unsigned> count;
+  galois::for_each(galois::iterate(0U, numItems),
+                   [&](unsigned i, auto& ctx) {
+                     count += 1;
+                     if (i < numItems / 2)
+                       ctx.push(i + numItems);
+                   },
+                   galois::wl<galois::worklists::PerSocketChunkFIFO<8>>(),
+                   galois::loopname("ChunkSteal"));
+  GALOIS_ASSERT(count.reduce() == numItems + numItems / 2);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned maxThreads = galois::substrate::getThreadPool().getMaxThreads();
+
+  testStealOrder();
+  for (unsigned t = 1; t <= maxThreads; t *= 2) {
+    testWorklist<galois::worklists::PerSocketChunkFIFO<4, unsigned>>(t,
+                                                                     1 << 16);
+    testWorklist<galois::worklists::PerSocketChunkLIFO<4, unsigned>>(t,
+                                                                     1 << 16);
+    testWorklist<galois::worklists::PerSocketChunkBag<4, unsigned>>(t,
+                                                                    1 << 16);
+    testWorklist<galois::worklists::ChunkFIFO<4, unsigned>>(t, 1 << 16);
+  }
+  testWorklist<galois::worklists::PerSocketChunkFIFO<4, unsigned>>(maxThreads,
+                                                                   1 << 16);
+  testForEach(maxThreads, 1 << 16);
+
+  return 0;
+}
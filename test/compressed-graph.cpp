@@ -0,0 +1,97 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LC_Compressed_Graph.h"
+#include "galois/graphs/Util.h"
+#include "galois/gIO.h"
+#include "graph-fixture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+typedef galois::graphs::FileGraph FileGraph;
+typedef galois::graphs::LC_Compressed_Graph<int, uint32_t> Graph;
+
+//! Random graph with duplicate edges, self loops and far-away neighbors
+void makeGraph(FileGraph& out, size_t numNodes, size_t numEdges) {
+  std::mt19937 gen(0);
+  EdgeVector edges = randomEdges(numNodes, numEdges, gen);
+  edges.emplace_back(0, numNodes - 1);
+  edges.emplace_back(numNodes - 1, 0);
+  edges.emplace_back(3, 3);
+  edges.emplace_back(3, 3);
+  makeGraph(out, numNodes, edges,
+            [](uint32_t src, uint32_t dst) { return src ^ dst; });
+}
+
+void checkGraph(FileGraph& f, Graph& g) {
+  GALOIS_ASSERT(g.size() == f.size());
+  GALOIS_ASSERT(g.sizeEdges() == f.sizeEdges());
+
+  for (auto n : g) {
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for (auto e : f.edges(n))
+      expected.emplace_back(f.getEdgeDst(e), f.getEdgeData<uint32_t>(e));
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::pair<uint32_t, uint32_t>> actual;
+    for (auto e : g.edges(n))
+      actual.emplace_back(g.getEdgeDst(e), g.getEdgeData(e));
+    GALOIS_ASSERT(g.getDegree(n) == actual.size());
+    GALOIS_ASSERT(expected == actual, "mismatched neighbors of ", n);
+
+    for (auto& p : expected) {
+      auto e = g.findEdge(n, p.first);
+      GALOIS_ASSERT(e != g.edge_end(n) && g.getEdgeDst(e) == p.first);
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  FileGraph f;
+  makeGraph(f, 1 << 13, 1 << 16);
+
+  Graph g;
+  galois::graphs::readGraph(g, f);
+  checkGraph(f, g);
+  GALOIS_ASSERT(g.sizeEdgeBytes() < g.sizeEdges() * sizeof(uint32_t));
+
+  std::string filename = makeTempFile("compressed-graph");
+  g.toFile(filename);
+  GALOIS_ASSERT(galois::graphs::isCompressedGraphFile(filename));
+
+  Graph h;
+  galois::graphs::readGraph(h, filename);
+  checkGraph(f, h);
+  std::remove(filename.c_str());
+
+  // a .gr file must not be mistaken for a compressed one
+  std::string grname = makeTempFile("compressed-graph-gr");
+  f.toFile(grname);
+  GALOIS_ASSERT(!galois::graphs::isCompressedGraphFile(grname));
+  std::remove(grname.c_str());
+
+  return 0;
+}
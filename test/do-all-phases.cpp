@@ -0,0 +1,76 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/gIO.h"
+
+#include <vector>
+
+//! The second phase reads what other threads wrote in the first one, which
+//! needs the barrier between phases
+void checkBarrier(unsigned numThreads, size_t num) {
+  galois::setActiveThreads(numThreads);
+  std::vector<size_t> a(num), b(num), c(num);
+
+  galois::do_all_phases(
+      galois::iterate((size_t)0, num),
+      galois::phases([&](size_t i) { a[i] = i; },
+                     [&](size_t i) { b[i] = a[num - 1 - i] + 1; },
+                     [&](size_t i) { c[i] = b[num - 1 - i] * 2; }),
+      galois::loopname("Phases"));
+
+  for (size_t i = 0; i < num; ++i)
+    GALOIS_ASSERT(c[i] == 2 * (i + 1), "index ", i, " is ", c[i], " with ",
+                  numThreads, " threads");
+}
+
+//! Without barriers phases only see their own item, but still in order
+void checkNoBarrier(unsigned numThreads) {
+  galois::setActiveThreads(numThreads);
+  galois::InsertBag<unsigned> bag;
+  galois::do_all(galois::iterate(0U, 10000U),
+                 [&](unsigned i) { bag.push(i); });
+  std::vector<unsigned> v(10000);
+
+  galois::do_all_phases(galois::iterate(bag),
+                        galois::phases([&](unsigned i) { v[i] = i; },
+                                       [&](unsigned i) { v[i] += 1; },
+                                       [&](unsigned i) { v[i] *= 3; }),
+                        galois::no_phase_barrier(), galois::no_stats());
+
+  for (unsigned i = 0; i < v.size(); ++i)
+    GALOIS_ASSERT(v[i] == 3 * (i + 1), "index ", i, " is ", v[i], " with ",
+                  numThreads, " threads");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned maxThreads = galois::substrate::getThreadPool().getMaxThreads();
+
+  for (unsigned t = 1; t <= maxThreads; t *= 2) {
+    checkBarrier(t, 100000);
+    checkBarrier(t, 3);
+    checkNoBarrier(t);
+  }
+  checkBarrier(maxThreads, 100000);
+  checkNoBarrier(maxThreads);
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/gIO.h"
+
+#include <atomic>
+#include <vector>
+
+//! Work that grows with the index, so early blocks finish first and their
+//! threads have to steal
+uint64_t unevenWork(uint64_t i) {
+  uint64_t x = i;
+  for (uint64_t k = 0; k < (i & 0xFFF) / 16; ++k)
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+  return x;
+}
+
+template <typename... Args>
+void checkOnce(size_t num, unsigned numThreads, const Args&... args) {
+  galois::setActiveThreads(numThreads);
+  std::vector<std::atomic<unsigned>> seen(num);
+  for (auto& s : seen)
+    s = 0;
+  std::atomic<uint64_t> sink(0);
+
+  galois::do_all(galois::iterate((size_t)0, num),
+                 [&](size_t i) {
+                   seen[i] += 1;
+                   if (unevenWork(i) == 0)
+                     sink += 1;
+                 },
+                 galois::steal(), args...);
+
+  for (size_t i = 0; i < num; ++i)
+    GALOIS_ASSERT(seen[i] == 1, "index ", i, " ran ", seen[i].load(),
+                  " times with ", numThreads, " threads");
+}
+
+//! Ranges whose values do not fit in 32 bits; the lock-free path packs
+//! offsets from the beginning of the range, not the values themselves
+void checkHighRange(uint64_t begin, unsigned numThreads) {
+  galois::setActiveThreads(numThreads);
+  const uint64_t num = 5000;
+  galois::GAccumulator<uint64_t> count;
+  galois::GAccumulator<uint64_t> sum;
+
+  galois::do_all(galois::iterate(begin, begin + num),
+                 [&](uint64_t i) {
+                   GALOIS_ASSERT(i >= begin && i - begin < num);
+                   count += 1;
+                   sum += i - begin;
+                 },
+                 galois::steal(), galois::chunk_size<16>());
+
+  GALOIS_ASSERT(count.reduce() == num);
+  GALOIS_ASSERT(sum.reduce() == num * (num - 1) / 2);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned maxThreads = galois::substrate::getThreadPool().getMaxThreads();
+
+  for (unsigned t = 1; t <= maxThreads; t *= 2) {
+    checkOnce(100000, t);
+    checkOnce(100000, t, galois::chunk_size<1>());
+    checkOnce(100000, t, galois::chunk_size<64>());
+    checkOnce(7, t);
+  }
+  checkOnce(100000, maxThreads);
+  checkOnce(100000, maxThreads, galois::chunk_size<1>());
+
+  checkHighRange(UINT32_MAX - 2500, maxThreads);
+  checkHighRange(1ull << 63, maxThreads);
+  checkHighRange(UINT64_MAX - 5000, maxThreads);
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+typedef std::vector<bool> Reference;
+
+//! Random bitset of the given size with about one bit in every density set
+void randomBitset(std::mt19937& gen, size_t size, unsigned density,
+                  galois::DynamicBitSet& bitset, Reference& ref) {
+  std::uniform_int_distribution<unsigned> dist(0, density - 1);
+  bitset.resize(size);
+  bitset.reset();
+  ref.assign(size, false);
+  for (size_t i = 0; i < size; ++i) {
+    if (dist(gen) == 0) {
+      bitset.set(i);
+      ref[i] = true;
+    }
+  }
+}
+
+void checkEqual(const galois::DynamicBitSet& bitset, const Reference& ref,
+                const char* what) {
+  GALOIS_ASSERT(bitset.size() == ref.size(), what, ": size");
+  for (size_t i = 0; i < ref.size(); ++i)
+    GALOIS_ASSERT(bitset.test(i) == ref[i], what, ": bit ", i, " of ",
+                  ref.size());
+}
+
+void checkQueries(const galois::DynamicBitSet& bitset, const Reference& ref) {
+  std::vector<uint32_t> expected;
+  for (size_t i = 0; i < ref.size(); ++i)
+    if (ref[i])
+      expected.push_back(i);
+
+  GALOIS_ASSERT(bitset.count() == expected.size(), "count of ", ref.size());
+
+  std::vector<uint32_t> offsets = bitset.getOffsets();
+  GALOIS_ASSERT(offsets == expected, "getOffsets of ", ref.size());
+
+  galois::PODResizeableArray<uint64_t> podOffsets;
+  GALOIS_ASSERT(bitset.getOffsets(podOffsets) == expected.size());
+  GALOIS_ASSERT(std::equal(podOffsets.begin(), podOffsets.end(),
+                           expected.begin()),
+                "getOffsets into array of ", ref.size());
+
+  // find_next from every bit
+  size_t next = ref.size();
+  for (size_t i = ref.size(); i-- > 0;) {
+    if (ref[i])
+      next = i;
+    GALOIS_ASSERT(bitset.find_next(i) == next, "find_next ", i, " of ",
+                  ref.size());
+  }
+  GALOIS_ASSERT(bitset.find_next(ref.size()) == ref.size());
+
+  // serial and parallel iteration over the set bits
+  auto bits = bitset.set_bits();
+  std::vector<uint32_t> serial(bits.begin(), bits.end());
+  GALOIS_ASSERT(serial == expected, "set_bits of ", ref.size());
+
+  galois::InsertBag<size_t> bag;
+  galois::do_all(galois::iterate(bits), [&](size_t i) { bag.push(i); },
+                 galois::no_stats());
+  std::vector<uint32_t> parallel(bag.begin(), bag.end());
+  std::sort(parallel.begin(), parallel.end());
+  GALOIS_ASSERT(parallel == expected, "parallel set_bits of ", ref.size());
+}
+
+void checkSize(std::mt19937& gen, size_t size, unsigned density) {
+  galois::DynamicBitSet a, b, c;
+  Reference ra, rb, rc(size);
+  randomBitset(gen, size, density, a, ra);
+  randomBitset(gen, size, 2, b, rb);
+  c.resize(size);
+
+  checkQueries(a, ra);
+  checkQueries(b, rb);
+
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = ra[i] && rb[i];
+  c.bitwise_and(a, b);
+  checkEqual(c, rc, "and");
+
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = ra[i] != rb[i];
+  c.bitwise_xor(a, b);
+  checkEqual(c, rc, "xor");
+
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = ra[i] && !rb[i];
+  c.bitwise_andnot(a, b);
+  checkEqual(c, rc, "andnot");
+  checkQueries(c, rc);
+
+  // in place versions
+  c.bitwise_or(b);
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = rc[i] || rb[i];
+  checkEqual(c, rc, "or");
+
+  c.bitwise_andnot(a);
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = rc[i] && !ra[i];
+  checkEqual(c, rc, "in place andnot");
+
+  c.bitwise_xor(a);
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = rc[i] != ra[i];
+  checkEqual(c, rc, "in place xor");
+
+  c.bitwise_and(b);
+  for (size_t i = 0; i < size; ++i)
+    rc[i] = rc[i] && rb[i];
+  checkEqual(c, rc, "in place and");
+  checkQueries(c, rc);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned maxThreads = galois::substrate::getThreadPool().getMaxThreads();
+  std::mt19937 gen(0);
+
+  for (unsigned t = 1; t <= maxThreads; t *= 2) {
+    galois::setActiveThreads(t);
+    for (size_t size : {0, 1, 63, 64, 65, 255, 257, 1000, 4099, 100003}) {
+      checkSize(gen, size, 2);
+      checkSize(gen, size, 100);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LC_Dynamic_Graph.h"
+#include "galois/graphs/Util.h"
+#include "galois/gIO.h"
+#include "graph-fixture.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+typedef galois::graphs::FileGraph FileGraph;
+typedef galois::graphs::LC_Dynamic_Graph<int, uint32_t>::with_no_lockable<
+    true>::type Graph;
+typedef galois::graphs::LC_Dynamic_Graph<int, void> VoidGraph;
+//! (src, dst) -> data of every edge, with duplicates
+typedef std::multimap<std::pair<uint32_t, uint32_t>, uint32_t> Reference;
+
+std::mt19937 gen(0);
+
+void makeGraph(FileGraph& out, Reference& ref, size_t numNodes,
+               size_t numEdges) {
+  EdgeVector edges = randomEdges(numNodes, numEdges, gen);
+  for (auto& e : edges)
+    ref.emplace(e, e.first ^ e.second);
+  makeGraph(out, numNodes, edges,
+            [](uint32_t src, uint32_t dst) { return src ^ dst; });
+}
+
+void checkGraph(Graph& g, const Reference& ref) {
+  GALOIS_ASSERT(g.sizeEdges() == ref.size(), "graph has ", g.sizeEdges(),
+                " edges, expected ", ref.size());
+  for (auto n : g) {
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for (auto ii = ref.lower_bound(std::make_pair(n, 0u));
+         ii != ref.end() && ii->first.first == n; ++ii)
+      expected.emplace_back(ii->first.second, ii->second);
+
+    std::vector<std::pair<uint32_t, uint32_t>> actual;
+    for (auto e : g.edges(n))
+      actual.emplace_back(g.getEdgeDst(e), g.getEdgeData(e));
+    GALOIS_ASSERT(g.getDegree(n) == actual.size());
+    if (g.isSortedByDst()) {
+      for (size_t i = 1; i < actual.size(); ++i)
+        GALOIS_ASSERT(actual[i - 1].first <= actual[i].first,
+                      "edges of ", n, " not sorted");
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    GALOIS_ASSERT(expected == actual, "mismatched neighbors of ", n);
+  }
+}
+
+//! Random batch; deletions mostly hit existing edges
+void makeBatch(const Reference& ref, size_t numNodes, size_t size,
+               std::vector<Graph::EdgeUpdate>& insertions,
+               std::vector<Graph::EdgeDeletion>& deletions) {
+  std::uniform_int_distribution<uint32_t> dist(0, numNodes - 1);
+  std::uniform_int_distribution<size_t> pick(0, ref.size() - 1);
+  insertions.clear();
+  deletions.clear();
+  // a few hubs get many insertions, forcing their blocks to move
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t src = (i % 4 == 0) ? dist(gen) % 8 : dist(gen);
+    uint32_t dst = dist(gen);
+    insertions.emplace_back(src, dst, src + dst);
+  }
+  for (size_t i = 0; i < size / 2; ++i) {
+    auto ii = ref.begin();
+    std::advance(ii, pick(gen) % ref.size());
+    deletions.push_back(ii->first);
+  }
+  deletions.emplace_back(dist(gen), dist(gen));
+}
+
+void applyReference(Reference& ref,
+                    const std::vector<Graph::EdgeUpdate>& insertions,
+                    const std::vector<Graph::EdgeDeletion>& deletions) {
+  for (auto& d : deletions)
+    ref.erase(d);
+  for (auto& e : insertions)
+    ref.emplace(std::make_pair(e.src, e.dst), e.get());
+}
+
+void testUpdates(bool sorted, double threshold) {
+  const size_t numNodes = 1 << 10;
+  FileGraph f;
+  Reference ref;
+  makeGraph(f, ref, numNodes, 1 << 13);
+
+  Graph g;
+  galois::graphs::readGraph(g, f);
+  if (sorted)
+    g.sortAllEdgesByDst();
+  g.setCompactionThreshold(threshold);
+  checkGraph(g, ref);
+
+  std::vector<Graph::EdgeUpdate> insertions;
+  std::vector<Graph::EdgeDeletion> deletions;
+  for (int round = 0; round < 20; ++round) {
+    makeBatch(ref, numNodes, 500, insertions, deletions);
+    applyReference(ref, insertions, deletions);
+    g.applyBatch(insertions, deletions);
+    checkGraph(g, ref);
+    if (round == 10) {
+      g.compact();
+      checkGraph(g, ref);
+    }
+  }
+
+  if (sorted) {
+    for (auto& p : ref) {
+      auto e = g.findEdgeSortedByDst(p.first.first, p.first.second);
+      GALOIS_ASSERT(e != g.edge_end(p.first.first));
+    }
+  }
+}
+
+void testVoid() {
+  FileGraph f;
+  Reference ref;
+  makeGraph(f, ref, 64, 256);
+  VoidGraph g;
+  galois::graphs::readGraph(g, f);
+  std::vector<VoidGraph::EdgeUpdate> insertions{{1, 2}, {1, 3}, {63, 0}};
+  std::vector<VoidGraph::EdgeDeletion> deletions;
+  for (auto e : g.edges(5))
+    deletions.emplace_back(5, g.getEdgeDst(e));
+  uint64_t before = g.sizeEdges();
+  uint64_t deg    = g.getDegree(5);
+  g.applyBatch(insertions, deletions);
+  GALOIS_ASSERT(g.getDegree(5) == 0);
+  GALOIS_ASSERT(g.sizeEdges() == before + insertions.size() - deg);
+  GALOIS_ASSERT(g.findEdge(63, 0) != g.edge_end(63));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  testUpdates(false, 0.5);
+  testUpdates(true, 0.5);
+  testUpdates(true, 0.0);
+  testUpdates(false, 0.05);
+  testVoid();
+
+  return 0;
+}
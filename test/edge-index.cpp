@@ -0,0 +1,95 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/EdgeIndex.h"
+#include "galois/gIO.h"
+#include "graph-fixture.h"
+
+#include <random>
+#include <vector>
+
+typedef galois::graphs::FileGraph FileGraph;
+typedef galois::graphs::LC_CSR_Graph<int, void> Graph;
+typedef Graph::GraphNode GNode;
+
+//! random graph where the first few nodes are hubs
+void makeGraph(FileGraph& out, size_t numNodes, size_t numEdges) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> dist(0, numNodes - 1);
+  std::uniform_int_distribution<uint32_t> hub(0, 7);
+
+  EdgeVector edges;
+  for (size_t i = 0; i < numEdges; ++i) {
+    uint32_t src = i % 2 ? hub(gen) : dist(gen);
+    edges.emplace_back(src, dist(gen));
+  }
+  // the graph read from it has no edge data
+  makeGraph(out, numNodes, edges, [](uint32_t, uint32_t) { return 0; });
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  FileGraph f;
+  makeGraph(f, 1 << 12, 1 << 16);
+
+  Graph g;
+  galois::graphs::readGraph(g, f);
+  g.sortAllEdgesByDst();
+
+  galois::graphs::EdgeIndex<Graph> index(g, 64);
+  GALOIS_ASSERT(index.numHubs() >= 8);
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<uint32_t> dist(0, g.size() - 1);
+  std::vector<galois::graphs::EdgeIndex<Graph>::Query> queries;
+  for (GNode n : g) {
+    // every edge and a random, mostly absent, one
+    for (auto e : g.edges(n))
+      queries.emplace_back(n, g.getEdgeDst(e));
+    queries.emplace_back(n, dist(gen));
+  }
+  for (GNode n = 0; n < 8; ++n)
+    for (GNode m : g)
+      queries.emplace_back(n, m);
+  std::shuffle(queries.begin(), queries.end(), gen);
+
+  std::vector<Graph::edge_iterator> edges;
+  std::vector<uint8_t> exists;
+  index.findEdges(queries, edges);
+  index.hasEdges(queries, exists);
+
+  for (size_t i = 0; i < queries.size(); ++i) {
+    GNode src = queries[i].first, dst = queries[i].second;
+    auto expected = g.findEdgeSortedByDst(src, dst);
+    bool found    = expected != g.edge_end(src);
+
+    GALOIS_ASSERT(index.findEdge(src, dst) == expected, src, " -> ", dst);
+    GALOIS_ASSERT(index.hasEdge(src, dst) == found);
+    GALOIS_ASSERT(edges[i] == expected, src, " -> ", dst);
+    GALOIS_ASSERT(exists[i] == found);
+    if (found) {
+      GALOIS_ASSERT(g.getEdgeDst(edges[i]) == dst);
+    }
+  }
+
+  return 0;
+}
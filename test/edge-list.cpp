@@ -0,0 +1,192 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/EdgeList.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <tuple>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <vector>
+
+typedef std::tuple<uint32_t, uint32_t, double> Edge;
+
+std::string tempFile(const char* prefix) {
+  std::string name = std::string(prefix) + "-XXXXXX";
+  int fd           = mkstemp(&name[0]);
+  GALOIS_ASSERT(fd != -1);
+  close(fd);
+  return name;
+}
+
+//! Random edge list over several parse chunks with comments, blank lines,
+//! extra fields and no line break at the end
+std::vector<Edge> writeEdgeList(const std::string& filename, size_t numNodes,
+                                size_t numEdges) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> dist(0, numNodes - 2);
+
+  std::vector<Edge> edges;
+  std::ofstream out(filename);
+  out << "# random graph\n% src dst weight\n\n";
+  for (size_t i = 0; i < numEdges; ++i) {
+    edges.emplace_back(dist(gen), dist(gen), dist(gen) / 4.0 - 1000);
+    if (i % 1000 == 0)
+      out << "  \t\r\n# " << i << "\n";
+    out << std::get<0>(edges.back()) << (i % 2 ? " " : "\t")
+        << std::get<1>(edges.back()) << " " << std::get<2>(edges.back());
+    if (i % 7 == 0)
+      out << " extra";
+    if (i + 1 != numEdges)
+      out << (i % 3 ? "\n" : "\r\n");
+  }
+  // largest node ID only appears as a destination
+  edges.emplace_back(0, numNodes - 1, 0.5);
+  out << "\n0 " << numNodes - 1 << " 0.5";
+  return edges;
+}
+
+double edgeValue(double v) { return v; }
+double edgeValue(void*) { return 0; }
+
+template <typename Graph>
+void checkGraph(Graph& g, std::vector<Edge> edges, bool hasData) {
+  std::sort(edges.begin(), edges.end());
+  GALOIS_ASSERT(g.sizeEdges() == edges.size());
+
+  std::vector<Edge> found;
+  for (auto n : g) {
+    uint32_t prev = 0;
+    for (auto e : g.edges(n)) {
+      uint32_t dst = g.getEdgeDst(e);
+      GALOIS_ASSERT(dst >= prev, "edges of ", n, " are not sorted");
+      prev = dst;
+      found.emplace_back(n, dst, edgeValue(g.getEdgeData(e)));
+    }
+  }
+  if (!hasData) {
+    for (auto& e : edges)
+      std::get<2>(e) = 0;
+  }
+  // parallel edges are ordered by their data
+  GALOIS_ASSERT(found == edges);
+}
+
+//! @returns true if reading a file with the given line dies
+bool readDies(const std::string& line) {
+  std::string text = tempFile("edge-list-bad");
+  std::ofstream(text) << line << "\n";
+  // forked before the parent starts its runtime threads
+  pid_t pid = fork();
+  GALOIS_ASSERT(pid != -1);
+  if (pid == 0) {
+    galois::SharedMemSys Galois_runtime;
+    galois::graphs::EdgeList<uint32_t> list;
+    list.readText(text);
+    _exit(0);
+  }
+  int status;
+  GALOIS_ASSERT(waitpid(pid, &status, 0) == pid);
+  std::remove(text.c_str());
+  return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+void checkParseValue() {
+  const char* big = "18446744073709551615 18446744073709551616";
+  const char* end = big + std::strlen(big);
+  uint64_t u;
+  const char* p = galois::graphs::internal::parseValue(big, end, u);
+  GALOIS_ASSERT(p && u == UINT64_MAX);
+  GALOIS_ASSERT(!galois::graphs::internal::parseValue(p, end, u));
+
+  const char* ints = "-128 128 -0 -1";
+  end              = ints + std::strlen(ints);
+  int8_t i;
+  p = galois::graphs::internal::parseValue(ints, end, i);
+  GALOIS_ASSERT(p && i == -128);
+  GALOIS_ASSERT(!galois::graphs::internal::parseValue(p, end, i));
+  uint32_t w;
+  p = galois::graphs::internal::parseValue(p + 4, end, w);
+  GALOIS_ASSERT(p && w == 0);
+  GALOIS_ASSERT(!galois::graphs::internal::parseValue(p, end, w));
+}
+
+int main() {
+  checkParseValue();
+  // 2^32 - 1 would make the number of nodes overflow 32 bits
+  GALOIS_ASSERT(!readDies("0 4294967294 1"));
+  GALOIS_ASSERT(readDies("0 4294967295 1"));
+  GALOIS_ASSERT(readDies("0 18446744073709551617 1"));
+  GALOIS_ASSERT(readDies("0 1 4294967296"));
+
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  const size_t numNodes = 1 << 14;
+  std::string text      = tempFile("edge-list");
+  std::vector<Edge> edges = writeEdgeList(text, numNodes, 1 << 18);
+
+  galois::graphs::EdgeList<double> list;
+  list.readText(text);
+  GALOIS_ASSERT(list.size() == edges.size());
+  GALOIS_ASSERT(list.sizeNodes() == numNodes);
+  for (size_t e = 0; e < edges.size(); ++e) {
+    GALOIS_ASSERT(list.src(e) == std::get<0>(edges[e]), "edge ", e);
+    GALOIS_ASSERT(list.dst(e) == std::get<1>(edges[e]), "edge ", e);
+    GALOIS_ASSERT(list.data(e) == std::get<2>(edges[e]), "edge ", e);
+  }
+
+  galois::graphs::LC_CSR_Graph<int, double> g;
+  g.constructFrom(list);
+  GALOIS_ASSERT(g.size() == numNodes);
+  checkGraph(g, edges, true);
+
+  // round trip through a .gr file
+  std::string gr = tempFile("edge-list-gr");
+  g.writeGraphToGRFile(gr);
+  galois::graphs::LC_CSR_Graph<int, double> h;
+  galois::graphs::readGraph(h, gr);
+  checkGraph(h, edges, true);
+
+  // without edge data, and with more nodes than the list mentions
+  galois::graphs::EdgeList<void> voidList;
+  voidList.readText(text);
+  galois::graphs::LC_CSR_Graph<int, void>::with_numa_alloc<true>::type v;
+  v.constructFrom(voidList, numNodes + 10);
+  GALOIS_ASSERT(v.size() == numNodes + 10);
+  checkGraph(v, edges, false);
+
+  v.writeGraphToGRFile(gr);
+  galois::graphs::LC_CSR_Graph<int, void> w;
+  galois::graphs::readGraph(w, gr);
+  GALOIS_ASSERT(w.size() == numNodes + 10);
+  checkGraph(w, edges, false);
+
+  std::remove(text.c_str());
+  std::remove(gr.c_str());
+
+  return 0;
+}
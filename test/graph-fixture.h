@@ -0,0 +1,98 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file graph-fixture.h
+ *
+ * Random graphs and temporary files shared by the graph tests.
+ */
+
+#ifndef GALOIS_TEST_GRAPH_FIXTURE_H
+#define GALOIS_TEST_GRAPH_FIXTURE_H
+
+#include "galois/graphs/FileGraph.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> EdgeVector;
+
+//! @returns numEdges edges between random nodes of [0, numNodes)
+inline EdgeVector randomEdges(size_t numNodes, size_t numEdges,
+                              std::mt19937& gen) {
+  std::uniform_int_distribution<uint32_t> dist(0, numNodes - 1);
+  EdgeVector edges;
+  for (size_t i = 0; i < numEdges; ++i)
+    edges.emplace_back(dist(gen), dist(gen));
+  return edges;
+}
+
+/**
+ * Builds a graph with uint32_t edge data from a list of edges.
+ *
+ * @param out graph to build
+ * @param numNodes number of nodes
+ * @param edges (source, destination) of every edge
+ * @param data function from the source and destination of an edge to its
+ * data
+ */
+template <typename EdgeDataFn>
+void makeGraph(galois::graphs::FileGraph& out, size_t numNodes,
+               const EdgeVector& edges, EdgeDataFn data) {
+  galois::graphs::FileGraphWriter p;
+  p.setNumNodes(numNodes);
+  p.setNumEdges(edges.size());
+  p.setSizeofEdgeData(sizeof(uint32_t));
+  p.phase1();
+  for (auto& e : edges)
+    p.incrementDegree(e.first);
+  p.phase2();
+  std::vector<uint32_t> edgeData(edges.size());
+  for (auto& e : edges)
+    edgeData[p.addNeighbor(e.first, e.second)] = data(e.first, e.second);
+  uint32_t* rawEdgeData = p.finish<uint32_t>();
+  std::copy(edgeData.begin(), edgeData.end(), rawEdgeData);
+  out = std::move(p);
+}
+
+//! Builds a graph of numEdges random edges; see randomEdges and makeGraph
+template <typename EdgeDataFn>
+void makeGraph(galois::graphs::FileGraph& out, size_t numNodes,
+               size_t numEdges, EdgeDataFn data) {
+  std::mt19937 gen(0);
+  makeGraph(out, numNodes, randomEdges(numNodes, numEdges, gen), data);
+}
+
+//! Creates an empty file named prefix-XXXXXX in the working directory
+//! @returns its name
+inline std::string makeTempFile(const std::string& prefix) {
+  std::string name = prefix + "-XXXXXX";
+  int fd           = mkstemp(&name[0]);
+  GALOIS_ASSERT(fd != -1);
+  close(fd);
+  return name;
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+// Runs the reordering conversions of graph-convert (passed as the only
+// argument) on a small symmetric graph and checks their output.
+
+#include "galois/Galois.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef galois::graphs::FileGraph FileGraph;
+typedef std::vector<std::vector<uint32_t>> AdjList;
+
+//! Random part (levels large enough to expand in parallel), a grid and a
+//! path (small levels), a star (a hub) and isolated nodes
+AdjList makeGraph() {
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  uint32_t base = 0;
+
+  const uint32_t numRandom = 20000;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> dist(0, numRandom - 1);
+  for (uint32_t i = 0; i < numRandom * 4; ++i)
+    edges.emplace_back(dist(gen), dist(gen));
+  base += numRandom;
+
+  const uint32_t side = 40;
+  for (uint32_t r = 0; r < side; ++r) {
+    for (uint32_t c = 0; c < side; ++c) {
+      uint32_t n = base + r * side + c;
+      if (c + 1 < side)
+        edges.emplace_back(n, n + 1);
+      if (r + 1 < side)
+        edges.emplace_back(n, n + side);
+    }
+  }
+  base += side * side;
+
+  for (uint32_t i = 0; i + 1 < 300; ++i)
+    edges.emplace_back(base + i, base + i + 1);
+  base += 300;
+
+  for (uint32_t i = 1; i < 200; ++i)
+    edges.emplace_back(base, base + i);
+  base += 200;
+
+  AdjList adj(base + 10);
+  for (auto& e : edges) {
+    adj[e.first].push_back(e.second);
+    adj[e.second].push_back(e.first);
+  }
+  return adj;
+}
+
+void writeGraph(const AdjList& adj, const std::string& filename) {
+  galois::graphs::FileGraphWriter p;
+  size_t numEdges = 0;
+  for (auto& nbrs : adj)
+    numEdges += nbrs.size();
+  p.setNumNodes(adj.size());
+  p.setNumEdges(numEdges);
+  p.phase1();
+  for (uint32_t n = 0; n < adj.size(); ++n)
+    p.incrementDegree(n, adj[n].size());
+  p.phase2();
+  for (uint32_t n = 0; n < adj.size(); ++n)
+    for (auto dst : adj[n])
+      p.addNeighbor(n, dst);
+  p.finish<void>();
+  p.toFile(filename);
+}
+
+std::vector<uint32_t> readPermutation(const std::string& filename,
+                                      size_t numNodes) {
+  std::ifstream in(filename);
+  GALOIS_ASSERT(in.is_open(), "missing permutation ", filename);
+  std::vector<uint32_t> perm(numNodes, ~0u);
+  std::vector<bool> used(numNodes, false);
+  size_t oldId, newId;
+  char comma;
+  size_t lines = 0;
+  while (in >> oldId >> comma >> newId) {
+    GALOIS_ASSERT(oldId < numNodes && newId < numNodes && comma == ',');
+    GALOIS_ASSERT(perm[oldId] == ~0u && !used[newId], "not a permutation");
+    perm[oldId]  = newId;
+    used[newId] = true;
+    ++lines;
+  }
+  GALOIS_ASSERT(lines == numNodes, "permutation has ", lines, " entries");
+  return perm;
+}
+
+//! The output graph must be the input graph with nodes renamed by perm
+void checkPermuted(const AdjList& adj, const std::vector<uint32_t>& perm,
+                   const std::string& filename) {
+  FileGraph out;
+  out.fromFile(filename);
+  GALOIS_ASSERT(out.size() == adj.size());
+  for (uint32_t n = 0; n < adj.size(); ++n) {
+    std::vector<uint32_t> expected;
+    for (auto dst : adj[n])
+      expected.push_back(perm[dst]);
+    std::vector<uint32_t> actual;
+    for (auto e : out.edges(perm[n]))
+      actual.push_back(out.getEdgeDst(e));
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    GALOIS_ASSERT(expected == actual, "edges of node ", n, " not permuted");
+  }
+}
+
+/**
+ * Serial reverse Cuthill-McKee with the tie breaking graph-convert
+ * documents: components start from their lowest (degree, id) node, moved
+ * to a pseudo-peripheral node; children are visited by (degree, id).
+ */
+std::vector<uint32_t> serialRCM(const AdjList& adj) {
+  const size_t numNodes = adj.size();
+  auto byDegree         = [&](uint32_t a, uint32_t b) {
+    return adj[a].size() < adj[b].size() ||
+           (adj[a].size() == adj[b].size() && a < b);
+  };
+  std::vector<bool> numbered(numNodes, false);
+
+  // levels of a BFS over unnumbered nodes and its last level
+  auto eccentricity = [&](uint32_t root, std::vector<uint32_t>& last) {
+    std::vector<bool> seen(numNodes, false);
+    std::vector<uint32_t> curr(1, root);
+    seen[root]      = true;
+    unsigned levels = 1;
+    while (true) {
+      std::vector<uint32_t> next;
+      for (auto n : curr)
+        for (auto dst : adj[n])
+          if (!seen[dst] && !numbered[dst]) {
+            seen[dst] = true;
+            next.push_back(dst);
+          }
+      if (next.empty())
+        break;
+      curr.swap(next);
+      ++levels;
+    }
+    last = curr;
+    return levels;
+  };
+
+  std::vector<uint32_t> starts(numNodes);
+  for (uint32_t n = 0; n < numNodes; ++n)
+    starts[n] = n;
+  std::sort(starts.begin(), starts.end(), byDegree);
+
+  std::vector<uint32_t> order;
+  for (auto start : starts) {
+    if (numbered[start])
+      continue;
+    uint32_t root = start;
+    if (!adj[start].empty()) {
+      std::vector<uint32_t> last;
+      unsigned ecc = eccentricity(root, last);
+      for (unsigned i = 0; i < 8; ++i) {
+        uint32_t candidate = *std::min_element(last.begin(), last.end(), byDegree);
+        std::vector<uint32_t> candidateLast;
+        unsigned candidateEcc = eccentricity(candidate, candidateLast);
+        if (candidateEcc <= ecc)
+          break;
+        root = candidate;
+        ecc  = candidateEcc;
+        last = candidateLast;
+      }
+    }
+
+    std::deque<uint32_t> queue(1, root);
+    numbered[root] = true;
+    while (!queue.empty()) {
+      uint32_t n = queue.front();
+      queue.pop_front();
+      order.push_back(n);
+      std::vector<uint32_t> children;
+      for (auto dst : adj[n])
+        if (!numbered[dst]) {
+          numbered[dst] = true;
+          children.push_back(dst);
+        }
+      std::sort(children.begin(), children.end(), byDegree);
+      queue.insert(queue.end(), children.begin(), children.end());
+    }
+  }
+
+  std::vector<uint32_t> perm(numNodes);
+  for (size_t pos = 0; pos < numNodes; ++pos)
+    perm[order[pos]] = numNodes - 1 - pos;
+  return perm;
+}
+
+std::vector<uint32_t> runConversion(const std::string& convert,
+                                    const std::string& mode, unsigned threads,
+                                    const std::string& in, const AdjList& adj) {
+  std::string out  = in + "." + mode + ".gr";
+  std::string perm = out + ".perm";
+  std::string cmd  = convert + " -" + mode + " -t=" + std::to_string(threads) +
+                    " " + in + " " + out + " > /dev/null";
+  GALOIS_ASSERT(std::system(cmd.c_str()) == 0, "failed: ", cmd);
+
+  std::vector<uint32_t> p = readPermutation(perm, adj.size());
+  checkPermuted(adj, p, out);
+  std::remove(out.c_str());
+  std::remove(perm.c_str());
+  return p;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  GALOIS_ASSERT(argc == 2, "usage: ", argv[0], " <graph-convert>");
+  std::string convert = argv[1];
+
+  char filename[] = "graph-reorder-XXXXXX";
+  int fd          = mkstemp(filename);
+  GALOIS_ASSERT(fd != -1);
+  close(fd);
+
+  AdjList adj = makeGraph();
+  writeGraph(adj, filename);
+
+  std::vector<uint32_t> reference = serialRCM(adj);
+  for (std::string mode :
+       {"gr2rcmgr", "gr2hubsortgr", "gr2hubclustergr", "gr2gordergr"}) {
+    std::vector<uint32_t> first;
+    for (unsigned threads : {1, 2, 4}) {
+      std::vector<uint32_t> p = runConversion(convert, mode, threads, filename,
+                                              adj);
+      if (mode == "gr2rcmgr")
+        GALOIS_ASSERT(p == reference, "RCM differs from serial reference with ",
+                      threads, " threads");
+      if (first.empty())
+        first = p;
+      GALOIS_ASSERT(p == first, mode, " depends on the number of threads");
+    }
+  }
+
+  std::remove(filename);
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/gIO.h"
+#include "graph-fixture.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+typedef galois::graphs::FileGraph FileGraph;
+
+template <typename Graph>
+void checkGraph(FileGraph& f, Graph& g) {
+  GALOIS_ASSERT(g.size() == f.size());
+  GALOIS_ASSERT(g.sizeEdges() == f.sizeEdges());
+  for (auto n : f) {
+    GALOIS_ASSERT(*g.edge_begin(n) == *f.edge_begin(n));
+    GALOIS_ASSERT(*g.edge_end(n) == *f.edge_end(n));
+    for (auto e : f.edges(n)) {
+      GALOIS_ASSERT(g.getEdgeDst(*e) == f.getEdgeDst(e), "edge ", *e);
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  typedef galois::graphs::LC_CSR_Graph<int, uint32_t> Graph;
+  typedef galois::graphs::LC_CSR_Graph<int, void> VoidGraph;
+
+  FileGraph f;
+  makeGraph(f, 1 << 12, 1 << 16,
+            [](uint32_t src, uint32_t dst) { return src * 31 + dst; });
+
+  std::string filename = makeTempFile("graph-snapshot");
+  f.toFile(filename);
+
+  struct stat buf;
+  std::string dir = stat("/dev/shm", &buf) == 0 ? "/dev/shm" : ".";
+  std::string path = Graph::snapshotPath(dir, filename);
+  GALOIS_ASSERT(path != VoidGraph::snapshotPath(dir, filename));
+
+  {
+    Graph g;
+    GALOIS_ASSERT(!g.attachSnapshot(path, filename));
+    galois::graphs::readGraph(g, filename);
+    g.publishSnapshot(path, filename);
+  }
+
+  {
+    Graph g;
+    GALOIS_ASSERT(g.attachSnapshot(path, filename));
+    checkGraph(f, g);
+    for (auto n : f) {
+      GALOIS_ASSERT(g.getData(n) == 0);
+      for (auto e : f.edges(n)) {
+        GALOIS_ASSERT(g.getEdgeData(*e) == f.getEdgeData<uint32_t>(e));
+      }
+    }
+    // writes stay private to this process
+    g.getEdgeData(*g.edge_begin(0)) = 7;
+    Graph h;
+    GALOIS_ASSERT(h.attachSnapshot(path, filename));
+    GALOIS_ASSERT(h.getEdgeData(*h.edge_begin(0)) ==
+                  f.getEdgeData<uint32_t>(f.edge_begin(0)));
+  }
+
+  // a snapshot without edge data is a separate snapshot
+  {
+    VoidGraph g;
+    GALOIS_ASSERT(!g.attachSnapshot(path, filename));
+  }
+
+  // changing the graph file invalidates the snapshot
+  struct timeval times[2] = {{1, 0}, {1, 0}};
+  GALOIS_ASSERT(utimes(filename.c_str(), times) == 0);
+  {
+    Graph g;
+    GALOIS_ASSERT(!g.attachSnapshot(path, filename));
+  }
+
+  std::remove(path.c_str());
+  std::remove(filename.c_str());
+
+  return 0;
+}
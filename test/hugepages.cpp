@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/substrate/PageAlloc.h"
+#include "galois/gIO.h"
+
+#include <initializer_list>
+
+using galois::substrate::HugePagePolicy;
+using galois::substrate::PageBacking;
+
+void testParse() {
+  HugePagePolicy p = HugePagePolicy::Default;
+  GALOIS_ASSERT(galois::substrate::parseHugePagePolicy("1G", p) &&
+                p == HugePagePolicy::Huge1G);
+  GALOIS_ASSERT(galois::substrate::parseHugePagePolicy("2M", p) &&
+                p == HugePagePolicy::Huge2M);
+  GALOIS_ASSERT(galois::substrate::parseHugePagePolicy("THP", p) &&
+                p == HugePagePolicy::THP);
+  GALOIS_ASSERT(galois::substrate::parseHugePagePolicy("none", p) &&
+                p == HugePagePolicy::None);
+  GALOIS_ASSERT(!galois::substrate::parseHugePagePolicy("4K", p) &&
+                p == HugePagePolicy::None);
+  GALOIS_ASSERT(!galois::substrate::parseHugePagePolicy("", p));
+}
+
+//! Whatever pages the system has, each policy may only end up on its own
+//! pages or those it falls back to
+bool allowed(HugePagePolicy policy, PageBacking backing) {
+  switch (policy) {
+  case HugePagePolicy::Huge1G:
+    return true;
+  case HugePagePolicy::Huge2M:
+    return backing != PageBacking::Huge1G;
+  case HugePagePolicy::THP:
+    return backing == PageBacking::THP || backing == PageBacking::Base;
+  default:
+    return backing == PageBacking::Base;
+  }
+}
+
+void testFallback() {
+  size_t unit = galois::substrate::allocSize();
+  for (auto policy : {HugePagePolicy::Huge1G, HugePagePolicy::Huge2M,
+                      HugePagePolicy::THP, HugePagePolicy::None}) {
+    for (bool preFault : {false, true}) {
+      size_t bytes = 3 * unit;
+      PageBacking backing;
+      void* p = galois::substrate::allocLargePages(bytes, policy, preFault,
+                                                   backing);
+      GALOIS_ASSERT(p && bytes >= 3 * unit);
+      GALOIS_ASSERT(allowed(policy, backing), "policy ", (int)policy,
+                    " got backing ",
+                    galois::substrate::pageBackingName(backing));
+      GALOIS_ASSERT(galois::substrate::largePageBytes(backing) >= bytes);
+      static_cast<char*>(p)[bytes - 1] = 1;
+      galois::substrate::freeLargePages(p, bytes, backing);
+    }
+
+    size_t zero        = 0;
+    PageBacking backing = PageBacking::Huge1G;
+    GALOIS_ASSERT(!galois::substrate::allocLargePages(zero, policy, false,
+                                                      backing));
+    GALOIS_ASSERT(backing == PageBacking::Base);
+  }
+}
+
+void testLargeArray() {
+  galois::LargeArray<int> empty;
+  empty.allocateInterleaved(0);
+  GALOIS_ASSERT(empty.pageBacking() == PageBacking::Base);
+
+  galois::LargeArray<int> none;
+  none.setHugePagePolicy(HugePagePolicy::None);
+  none.allocateBlocked(1 << 20);
+  GALOIS_ASSERT(none.pageBacking() == PageBacking::Base);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  testParse();
+  testFallback();
+  testLargeArray();
+  return 0;
+}
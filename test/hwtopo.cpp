@@ -20,6 +20,7 @@
 #include "galois/substrate/HWTopo.h"
 
 #include <iostream>
+#include <set>
 
 int main(int argc, char** argv) {
   auto t = galois::substrate::getHWTopo();
@@ -33,5 +34,14 @@ int main(int argc, char** argv) {
               << " osContext: " << c.osContext
               << " osNumaNode: " << c.osNumaNode << "\n";
   }
+  std::set<unsigned> nodes;
+  for (auto& c : t.second)
+    nodes.insert(c.osNumaNode);
+  for (unsigned a : nodes) {
+    std::cout << "numa distance " << a << ":";
+    for (unsigned b : nodes)
+      std::cout << " " << galois::substrate::getNumaDistance(a, b);
+    std::cout << "\n";
+  }
   return 0;
 }
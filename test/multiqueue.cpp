@@ -0,0 +1,90 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/worklists/MultiQueue.h"
+#include "galois/gIO.h"
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+struct Identity {
+  unsigned operator()(unsigned x) const { return x; }
+};
+
+//! Maps every item to the largest index, which must still be popped
+struct MaxIndex {
+  unsigned operator()(unsigned) const {
+    return std::numeric_limits<unsigned>::max();
+  }
+};
+
+//! Pushes and pops items directly from all threads and checks that each item
+//! comes out exactly once
+template <typename Indexer>
+void testWorklist(unsigned numThreads, unsigned numItems) {
+  galois::setActiveThreads(numThreads);
+  typedef galois::worklists::MultiQueue<Indexer, 4, unsigned> WL;
+  WL wl;
+  std::vector<std::atomic<unsigned>> seen(numItems);
+  for (auto& s : seen)
+    s = 0;
+
+  galois::on_each([&](unsigned tid, unsigned total) {
+    for (unsigned i = tid; i < numItems; i += total)
+      wl.push(i);
+  });
+  galois::on_each([&](unsigned, unsigned) {
+    while (auto item = wl.pop())
+      seen[*item] += 1;
+  });
+
+  GALOIS_ASSERT(!wl.pop());
+  for (unsigned i = 0; i < numItems; ++i)
+    GALOIS_ASSERT(seen[i] == 1, "item ", i, " popped ", seen[i].load(),
+                  " times with ", numThreads, " threads");
+}
+
+//! With a single heap the MultiQueue degenerates to an exact priority queue
+void testOrder() {
+  galois::setActiveThreads(1);
+  galois::worklists::MultiQueue<Identity, 1, unsigned, unsigned, false> wl;
+  for (unsigned i = 1000; i > 0; --i)
+    wl.push(i - 1);
+  for (unsigned i = 0; i < 1000; ++i) {
+    auto item = wl.pop();
+    GALOIS_ASSERT(item && *item == i, "out of order pop ", i);
+  }
+  GALOIS_ASSERT(!wl.pop());
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned maxThreads = galois::substrate::getThreadPool().getMaxThreads();
+
+  for (unsigned t = 1; t <= maxThreads; t *= 2) {
+    testWorklist<Identity>(t, 1 << 16);
+    testWorklist<MaxIndex>(t, 1 << 12);
+  }
+  testWorklist<Identity>(maxThreads, 1 << 16);
+  testOrder();
+
+  return 0;
+}
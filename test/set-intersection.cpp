@@ -0,0 +1,90 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/SetIntersection.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+std::mt19937 gen(0);
+
+std::vector<uint32_t> makeSet(size_t size, uint32_t range) {
+  std::uniform_int_distribution<uint32_t> dist(0, range);
+  std::vector<uint32_t> s;
+  while (s.size() < size) {
+    for (size_t i = s.size(); i < size; ++i)
+      s.push_back(dist(gen));
+    std::sort(s.begin(), s.end());
+    s.erase(std::unique(s.begin(), s.end()), s.end());
+  }
+  return s;
+}
+
+void check(const std::vector<uint32_t>& x, const std::vector<uint32_t>& y) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(x.begin(), x.end(), y.begin(), y.end(),
+                        std::back_inserter(expected));
+
+  size_t count = galois::intersectCount(x.data(), x.size(), y.data(), y.size());
+  GALOIS_ASSERT(count == expected.size(), "count ", count, " expected ",
+                expected.size());
+
+  std::vector<uint32_t> posA(std::min(x.size(), y.size()));
+  std::vector<uint32_t> posB(posA.size());
+  size_t num = galois::intersectPositions(x.data(), x.size(), y.data(),
+                                          y.size(), posA.data(), posB.data());
+  GALOIS_ASSERT(num == expected.size());
+  for (size_t k = 0; k < num; ++k) {
+    GALOIS_ASSERT(x[posA[k]] == expected[k] && y[posB[k]] == expected[k]);
+  }
+}
+
+int main() {
+  const galois::IntersectKernel kernels[] = {galois::IntersectKernel::Scalar,
+                                             galois::IntersectKernel::AVX2,
+                                             galois::IntersectKernel::AVX512};
+  const size_t sizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 33, 100, 1000, 5000};
+
+  for (auto k : kernels) {
+    if (!galois::setIntersectKernel(k)) {
+      std::cout << galois::intersectKernelName(k) << ": not supported\n";
+      continue;
+    }
+    std::cout << galois::intersectKernelName(k) << "\n";
+
+    for (size_t na : sizes) {
+      for (size_t nb : sizes) {
+        // dense ranges share many elements; sparse ones few
+        for (uint32_t range : {2 * (na + nb), 50 * (na + nb)}) {
+          auto a = makeSet(na, range);
+          auto b = makeSet(nb, range);
+          check(a, b);
+          check(b, a);
+          check(a, a);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
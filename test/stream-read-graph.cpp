@@ -0,0 +1,74 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/gIO.h"
+#include "graph-fixture.h"
+
+#include <cstdio>
+
+typedef galois::graphs::FileGraph FileGraph;
+
+template <typename Graph>
+void checkTopology(FileGraph& f, Graph& g) {
+  GALOIS_ASSERT(g.size() == f.size());
+  GALOIS_ASSERT(g.sizeEdges() == f.sizeEdges());
+  for (auto n : f) {
+    GALOIS_ASSERT(*g.edge_begin(n) == *f.edge_begin(n));
+    GALOIS_ASSERT(*g.edge_end(n) == *f.edge_end(n));
+  }
+  for (auto n : f) {
+    for (auto e : f.edges(n)) {
+      GALOIS_ASSERT(g.getEdgeDst(*e) == f.getEdgeDst(e), "edge ", *e);
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  FileGraph f;
+  // more than one read chunk of edges and an odd edge count so the edge data
+  // is preceded by padding
+  makeGraph(f, 1 << 16, (3 << 20) + 1,
+            [](uint32_t src, uint32_t dst) { return src * 31 + dst; });
+  GALOIS_ASSERT(f.sizeEdges() % 2 == 1);
+
+  std::string filename = makeTempFile("stream-read-graph");
+  f.toFile(filename);
+
+  galois::graphs::LC_CSR_Graph<int, uint32_t> g;
+  galois::graphs::readGraph(g, filename);
+  checkTopology(f, g);
+  for (auto n : f) {
+    for (auto e : f.edges(n)) {
+      GALOIS_ASSERT(g.getEdgeData(*e) == f.getEdgeData<uint32_t>(e));
+    }
+  }
+
+  galois::graphs::LC_CSR_Graph<int, void>::with_numa_alloc<true>::type h;
+  galois::graphs::readGraph(h, filename);
+  checkTopology(f, h);
+
+  std::remove(filename.c_str());
+
+  return 0;
+}
@@ -77,12 +77,22 @@ void runExplicitThread(int num) {
   });
 }
 
+//! Fork/join only: every round wakes all threads and waits for them
+void runOnEach(int) {
+  for (int r = 0; r < rounds; ++r) {
+    galois::on_each(
+        [&](unsigned, unsigned) { asm volatile("" ::: "memory"); });
+  }
+}
+
 void run(std::function<void(int)> fn, std::string name) {
   galois::Timer t;
   t.start();
   fn(size);
   t.stop();
-  std::cout << name << " time: " << t.get() << "\n";
+  std::cout << name << " threads: " << galois::getActiveThreads()
+            << " time: " << t.get()
+            << " us/round: " << double(t.get_usec()) / rounds << "\n";
 }
 
 std::atomic<int> EXIT;
@@ -105,10 +115,18 @@ int main(int argc, char* argv[]) {
   std::cout << "threads: " << galois::getActiveThreads()
             << " rounds: " << rounds << " size: " << size << "\n";
 
-  for (int t = 0; t < trials; ++t) {
-    run(runDoAll, "DoAll");
-    run(runDoAllBurn, "DoAllBurn");
-    run(runExplicitThread, "ExplicitThread");
+  // per-round latency at 1, 2, 4, ... threads up to the requested number
+  unsigned maxThreads = galois::getActiveThreads();
+  for (unsigned n = 1;; n = std::min(2 * n, maxThreads)) {
+    galois::setActiveThreads(n);
+    for (int t = 0; t < trials; ++t) {
+      run(runOnEach, "OnEach");
+      run(runDoAll, "DoAll");
+      run(runDoAllBurn, "DoAllBurn");
+      run(runExplicitThread, "ExplicitThread");
+    }
+    if (n == maxThreads)
+      break;
   }
   EXIT = 1;
   return 0;
@@ -17,18 +17,26 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/graphs/EdgeList.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/LC_CSR_Graph.h"
+#include "galois/graphs/LC_Compressed_Graph.h"
 
 #include "llvm/Support/CommandLine.h"
 
 #include <boost/mpl/if.hpp>
 #include <algorithm>
+#include <cmath>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <numeric>
 #include <stdint.h>
 #include <vector>
 #include <random>
@@ -48,10 +56,14 @@ enum ConvertMode {
   gr2binarypbbs64,
   gr2bsml,
   gr2cgr,
+  gr2compressedgr,
   gr2dimacs,
   gr2adjacencylist,
   gr2edgelist,
   gr2edgelist1ind,
+  gr2gordergr,
+  gr2hubclustergr,
+  gr2hubsortgr,
   gr2linegr,
   gr2lowdegreegr,
   gr2mtx,
@@ -61,6 +73,7 @@ enum ConvertMode {
   gr2pbbsedges,
   gr2randgr,
   gr2randomweightgr,
+  gr2rcmgr,
   gr2ringgr,
   gr2rmat,
   gr2metis,
@@ -135,10 +148,18 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2bsml, "Convert binary gr to binary sparse MATLAB matrix"),
         clEnumVal(gr2cgr,
                   "Clean up binary gr: remove self edges and multi-edges"),
+        clEnumVal(gr2compressedgr, "Convert binary gr to delta/byte-coded "
+                                   "compressed graph (LC_Compressed_Graph)"),
         clEnumVal(gr2dimacs, "Convert binary gr to dimacs"),
         clEnumVal(gr2adjacencylist, "Convert binary gr to adjacency list"),
         clEnumVal(gr2edgelist, "Convert binary gr to edgelist"),
         clEnumVal(gr2edgelist1ind, "Convert binary gr to edgelist, 1-indexed"),
+        clEnumVal(gr2gordergr, "Sort nodes by windowed Gorder order within "
+                               "each of numParts node ranges"),
+        clEnumVal(gr2hubclustergr,
+                  "Move nodes with above average degree to the front"),
+        clEnumVal(gr2hubsortgr, "Move nodes with above average degree to the "
+                                "front, sorted by decreasing degree"),
         clEnumVal(gr2linegr, "Overlay line graph"),
         clEnumVal(gr2lowdegreegr, "Remove high degree nodes from binary gr"),
         clEnumVal(gr2mtx, "Convert binary gr to matrix market format"),
@@ -150,6 +171,8 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2pbbsedges, "Convert binary gr to pbbs edge list"),
         clEnumVal(gr2randgr, "Randomly permute nodes of binary gr"),
         clEnumVal(gr2randomweightgr, "Add or Randomize edge weights"),
+        clEnumVal(gr2rcmgr, "Sort nodes by reverse Cuthill-McKee order of "
+                            "symmetric binary gr"),
         clEnumVal(gr2ringgr, "Convert binary gr to strongly connected graph by "
                              "adding ring overlay"),
         clEnumVal(gr2rmat, "Convert binary gr to RMAT graph"),
@@ -186,6 +209,13 @@ static cll::opt<uint32_t>
 static cll::opt<int>
     numParts("numParts", cll::desc("number of parts to partition graph into"),
              cll::init(64));
+static cll::opt<unsigned>
+    gorderWindow("gorderWindow",
+                 cll::desc("window size for gr2gordergr (default 5)"),
+                 cll::init(5));
+static cll::opt<unsigned>
+    numThreads("t", cll::desc("Number of threads for parallel conversions"),
+               cll::init(1));
 static cll::opt<int> maxValue("maxValue",
                               cll::desc("maximum weight to add for tree, line, "
                                         "ring and random weight conversions"),
@@ -320,10 +350,19 @@ int getEdgeValue(galois::graphs::FileGraph& g,
   return 1;
 }
 
+//! Reorderings write their permutation next to the output unless
+//! -outputNodePermutation is given
+std::string reorderPermutationFilename(const std::string& outfilename) {
+  if (!outputPermutationFilename.empty())
+    return outputPermutationFilename;
+  return outfilename + ".perm";
+}
+
 template <typename T>
-void outputPermutation(const T& perm) {
+void outputPermutation(const T& perm,
+                       const std::string& filename = outputPermutationFilename) {
   size_t oid = 0;
-  std::ofstream out(outputPermutationFilename);
+  std::ofstream out(filename);
   for (auto ii = perm.begin(), ei = perm.end(); ii != ei; ++ii, ++oid) {
     out << oid << "," << *ii << "\n";
   }
@@ -332,90 +371,25 @@ void outputPermutation(const T& perm) {
 /**
  * Just a bunch of pairs or triples:
  * src dst weight?
+ *
+ * Lines are parsed in parallel straight into edge arrays, which are then
+ * counting sorted by source into an in-memory graph; the edges of each node
+ * come out sorted by destination and then by weight. The graph has one more
+ * node than the largest node ID, so an empty list gives a graph with no
+ * nodes (the serial converter used to write one node).
  */
 struct Edgelist2Gr : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-    typedef galois::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
-
-    Writer p;
-    EdgeData edgeData;
-    std::ifstream infile(infilename.c_str());
-
-    size_t numNodes = 0;
-    size_t numEdges = 0;
-
-    while (infile) {
-      size_t src;
-      size_t dst;
-      edge_value_type data;
-
-      infile >> src >> dst;
-
-      if (EdgeData::has_value)
-        infile >> data;
-
-      if (infile) {
-        ++numEdges;
-        if (src > numNodes)
-          numNodes = src;
-        if (dst > numNodes)
-          numNodes = dst;
-      }
-    }
-
-    numNodes++;
-    p.setNumNodes(numNodes);
-    p.setNumEdges(numEdges);
-    p.setSizeofEdgeData(EdgeData::size_of::value);
-    edgeData.create(numEdges);
-
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase1();
-    while (infile) {
-      size_t src;
-      size_t dst;
-      edge_value_type data;
-
-      infile >> src >> dst;
-
-      if (EdgeData::has_value)
-        infile >> data;
-
-      if (infile) {
-        p.incrementDegree(src);
-      }
-    }
-
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase2();
-    while (infile) {
-      size_t src;
-      size_t dst;
-      edge_value_type data{};
-
-      infile >> src >> dst;
+    typedef galois::graphs::LC_CSR_Graph<void, EdgeTy, true> Graph;
 
-      if (EdgeData::has_value)
-        infile >> data;
-
-      if (infile) {
-        edgeData.set(p.addNeighbor(src, dst), data);
-      }
-    }
+    galois::graphs::EdgeList<EdgeTy> edges;
+    edges.readText(infilename);
 
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
-                              std::make_move_iterator(edgeData.end()),
-                              rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(numNodes, numEdges);
+    Graph graph;
+    graph.constructFrom(edges);
+    graph.writeGraphToGRFile(outfilename);
+    printStatus(graph.size(), graph.sizeEdges());
   }
 };
 
@@ -1341,6 +1315,495 @@ struct SortByDegree : public Conversion {
   }
 };
 
+/**
+ * Numbers the nodes for which pred holds first and the others after them,
+ * keeping the original relative order within each group.
+ *
+ * @returns number of nodes for which pred holds
+ */
+template <typename Permutation, typename Pred>
+size_t stablePartitionNodes(size_t numNodes, Permutation& perm, Pred pred) {
+  std::vector<size_t> counts(galois::getActiveThreads(), 0);
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto r = galois::block_range(size_t(0), numNodes, tid, total);
+    for (size_t n = r.first; n < r.second; ++n) {
+      if (pred(n))
+        counts[tid] += 1;
+    }
+  });
+
+  std::vector<size_t> before(counts.size() + 1, 0);
+  std::partial_sum(counts.begin(), counts.end(), before.begin() + 1);
+  size_t numTrue = before.back();
+
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto r          = galois::block_range(size_t(0), numNodes, tid, total);
+    size_t nextTrue = before[tid];
+    size_t nextFalse = numTrue + r.first - before[tid];
+    for (size_t n = r.first; n < r.second; ++n) {
+      perm[n] = pred(n) ? nextTrue++ : nextFalse++;
+    }
+  });
+  return numTrue;
+}
+
+/**
+ * Moves hubs, nodes with more than the average number of out-edges, to the
+ * front so that their data shares as few cache lines as possible. With
+ * SortHubs, hubs are ordered by decreasing degree (hub sorting); otherwise
+ * they keep their relative order (hub clustering). Other nodes keep their
+ * relative order after the hubs.
+ */
+template <bool SortHubs>
+struct HubReorder : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::FileGraph Graph;
+    typedef Graph::GraphNode GNode;
+    typedef galois::LargeArray<GNode> Permutation;
+
+    Graph graph;
+    graph.fromFile(infilename);
+    const uint64_t numNodes = graph.size();
+    const uint64_t numEdges = graph.sizeEdges();
+
+    auto degree = [&](GNode n) -> uint64_t {
+      return std::distance(graph.edge_begin(n), graph.edge_end(n));
+    };
+
+    Permutation perm;
+    perm.create(numNodes);
+    size_t numHubs = stablePartitionNodes(numNodes, perm, [&](size_t n) {
+      return degree(n) * numNodes > numEdges;
+    });
+
+    if (SortHubs) {
+      Permutation hubs;
+      hubs.create(numHubs);
+      galois::do_all(galois::iterate(size_t(0), size_t(numNodes)),
+                     [&](size_t n) {
+                       if (perm[n] < numHubs)
+                         hubs[perm[n]] = n;
+                     },
+                     galois::no_stats(), galois::loopname("CollectHubs"));
+      galois::ParallelSTL::sort(hubs.begin(), hubs.end(),
+                                [&](GNode a, GNode b) {
+                                  uint64_t da = degree(a), db = degree(b);
+                                  return da > db || (da == db && a < b);
+                                });
+      galois::do_all(galois::iterate(size_t(0), numHubs),
+                     [&](size_t i) { perm[hubs[i]] = i; }, galois::no_stats(),
+                     galois::loopname("NumberHubs"));
+    }
+    std::cout << "Hubs: " << numHubs << "\n";
+
+    Graph out;
+    galois::graphs::permute<EdgeTy>(graph, perm, out);
+    outputPermutation(perm, reorderPermutationFilename(outfilename));
+
+    out.toFile(outfilename);
+    printStatus(out.size(), out.sizeEdges());
+  }
+};
+
+/**
+ * Reverse Cuthill-McKee ordering. Each component is numbered breadth-first
+ * from a pseudo-peripheral node, visiting the unnumbered neighbors of each
+ * node in order of increasing degree, and the resulting order is reversed.
+ * Edges are followed in their direction, so the input should be symmetric.
+ *
+ * Levels are expanded in parallel. A node is claimed by the earliest
+ * numbered of its parents in the level, and sorting a new level by
+ * (parent, degree, id) gives the same order as the serial algorithm.
+ * Levels with fewer than serialCutoff edges are expanded serially, so small
+ * components and long, thin graphs (meshes, road networks) are not
+ * dominated by loop launches.
+ */
+struct ReverseCuthillMcKee : public Conversion {
+  typedef galois::graphs::FileGraph Graph;
+  typedef Graph::GraphNode GNode;
+
+  //! claim of a node that has not been reached yet
+  static const uint32_t unclaimed = std::numeric_limits<uint32_t>::max();
+  //! George-Liu iterations to find a pseudo-peripheral node
+  static const unsigned maxPeripheralSweeps = 8;
+  //! levels with fewer edges than this are expanded serially
+  static const uint64_t serialCutoff = 4096;
+
+  Graph graph;
+  galois::LargeArray<uint32_t> degree;
+  //! position of the parent that claimed each node
+  galois::LargeArray<std::atomic<uint32_t>> claim;
+  //! last breadth-first sweep that reached each node
+  galois::LargeArray<std::atomic<uint32_t>> mark;
+  uint32_t sweep = 0;
+
+  bool byDegree(GNode a, GNode b) const {
+    return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+  }
+
+  //! Number of edges out of the nodes in [b, e)
+  template <typename Iter>
+  uint64_t levelEdges(Iter b, Iter e) const {
+    uint64_t edges = 0;
+    for (; b != e && edges < serialCutoff; ++b)
+      edges += degree[*b];
+    return edges;
+  }
+
+  //! BFS over unclaimed nodes; returns number of levels and the last level
+  uint32_t eccentricity(GNode root, std::vector<GNode>& lastLevel) {
+    ++sweep;
+    mark[root] = sweep;
+    std::vector<GNode> curr(1, root);
+    uint32_t levels = 1;
+    std::vector<GNode> next;
+    while (true) {
+      if (levelEdges(curr.begin(), curr.end()) < serialCutoff) {
+        next.clear();
+        for (GNode n : curr) {
+          for (auto jj : graph.edges(n)) {
+            GNode dst = graph.getEdgeDst(jj);
+            if (mark[dst] != sweep && claim[dst] == unclaimed) {
+              mark[dst] = sweep;
+              next.push_back(dst);
+            }
+          }
+        }
+      } else {
+        galois::InsertBag<GNode> bag;
+        galois::do_all(
+            galois::iterate(curr),
+            [&](GNode n) {
+              for (auto jj : graph.edges(n)) {
+                GNode dst    = graph.getEdgeDst(jj);
+                uint32_t old = mark[dst].load(std::memory_order_relaxed);
+                if (old != sweep && claim[dst] == unclaimed &&
+                    mark[dst].compare_exchange_strong(old, sweep)) {
+                  bag.push(dst);
+                }
+              }
+            },
+            galois::steal(), galois::no_stats(),
+            galois::loopname("RCM_PeripheralBFS"));
+        next.assign(bag.begin(), bag.end());
+      }
+      if (next.empty())
+        break;
+      std::swap(curr, next);
+      ++levels;
+    }
+    lastLevel = std::move(curr);
+    return levels;
+  }
+
+  GNode pseudoPeripheral(GNode root) {
+    std::vector<GNode> lastLevel;
+    uint32_t ecc = eccentricity(root, lastLevel);
+    for (unsigned i = 0; i < maxPeripheralSweeps; ++i) {
+      GNode candidate =
+          *std::min_element(lastLevel.begin(), lastLevel.end(),
+                            [&](GNode a, GNode b) { return byDegree(a, b); });
+      std::vector<GNode> candidateLast;
+      uint32_t candidateEcc = eccentricity(candidate, candidateLast);
+      if (candidateEcc <= ecc)
+        break;
+      root      = candidate;
+      ecc       = candidateEcc;
+      lastLevel = std::move(candidateLast);
+    }
+    return root;
+  }
+
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::LargeArray<GNode> Permutation;
+
+    graph.fromFile(infilename);
+    const size_t numNodes = graph.size();
+    if (numNodes >= unclaimed) {
+      GALOIS_DIE("too many nodes for gr2rcmgr");
+    }
+
+    degree.create(numNodes);
+    claim.create(numNodes);
+    mark.create(numNodes);
+    Permutation starts;
+    starts.create(numNodes);
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     degree[n] = std::distance(graph.edge_begin(n),
+                                               graph.edge_end(n));
+                     claim[n]  = unclaimed;
+                     mark[n]   = 0;
+                     starts[n] = n;
+                   },
+                   galois::no_stats(), galois::loopname("RCM_Init"));
+
+    // each component is started from its lowest degree node
+    galois::ParallelSTL::sort(
+        starts.begin(), starts.end(),
+        [&](GNode a, GNode b) { return byDegree(a, b); });
+
+    // Cuthill-McKee order
+    Permutation order;
+    order.create(numNodes);
+    size_t numbered = 0;
+    for (GNode start : starts) {
+      if (claim[start] != unclaimed)
+        continue;
+
+      GNode root      = degree[start] ? pseudoPeripheral(start) : start;
+      claim[root]     = numbered;
+      order[numbered] = root;
+
+      size_t levelBegin = numbered;
+      size_t levelEnd   = ++numbered;
+      while (levelBegin != levelEnd) {
+        if (levelEdges(order.begin() + levelBegin,
+                       order.begin() + levelEnd) < serialCutoff) {
+          // children are appended in parent order already
+          for (size_t pos = levelBegin; pos < levelEnd; ++pos) {
+            for (auto jj : graph.edges(order[pos])) {
+              GNode dst = graph.getEdgeDst(jj);
+              if (claim[dst] == unclaimed) {
+                claim[dst]        = pos;
+                order[numbered++] = dst;
+              }
+            }
+          }
+        } else {
+          galois::InsertBag<GNode> children;
+          galois::do_all(
+              galois::iterate(levelBegin, levelEnd),
+              [&](size_t pos) {
+                for (auto jj : graph.edges(order[pos])) {
+                  GNode dst = graph.getEdgeDst(jj);
+                  if (galois::atomicMin(claim[dst], uint32_t(pos)) ==
+                      unclaimed)
+                    children.push(dst);
+                }
+              },
+              galois::steal(), galois::no_stats(),
+              galois::loopname("RCM_Expand"));
+
+          for (GNode n : children)
+            order[numbered++] = n;
+        }
+        galois::ParallelSTL::sort(
+            order.begin() + levelEnd, order.begin() + numbered,
+            [&](GNode a, GNode b) {
+              uint32_t ca = claim[a].load(std::memory_order_relaxed);
+              uint32_t cb = claim[b].load(std::memory_order_relaxed);
+              return ca < cb || (ca == cb && byDegree(a, b));
+            });
+        levelBegin = levelEnd;
+        levelEnd   = numbered;
+      }
+    }
+    assert(numbered == numNodes);
+
+    Permutation perm;
+    perm.create(numNodes);
+    galois::do_all(galois::iterate(size_t(0), numNodes),
+                   [&](size_t pos) { perm[order[pos]] = numNodes - 1 - pos; },
+                   galois::no_stats(), galois::loopname("RCM_Reverse"));
+
+    Graph out;
+    galois::graphs::permute<EdgeTy>(graph, perm, out);
+    outputPermutation(perm, reorderPermutationFilename(outfilename));
+
+    out.toFile(outfilename);
+    printStatus(out.size(), out.sizeEdges());
+  }
+};
+
+/**
+ * Gorder-style ordering (Wei et al., SIGMOD 2016) with a sliding window.
+ * Nodes are placed greedily: the next node is the one with the most edges
+ * to, plus in-neighbors in common with, the last -gorderWindow placed nodes.
+ * In-neighbors with more than sqrt(nodes) out-edges are not counted as
+ * common, as in Gorder.
+ *
+ * To run in parallel, the graph is cut into -numParts contiguous ranges of
+ * nodes that are ordered independently; edges between ranges are ignored.
+ */
+struct GorderLite : public Conversion {
+  typedef galois::graphs::FileGraph Graph;
+  typedef Graph::GraphNode GNode;
+
+  //! Max priority queue of nodes whose keys only change by one at a time
+  class UnitHeap {
+    static const uint32_t nil = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> key;
+    std::vector<uint32_t> prev;
+    std::vector<uint32_t> next;
+    //! first node of each key
+    std::vector<uint32_t> head;
+    std::vector<bool> removed;
+    uint32_t top = 0;
+
+    void unlink(uint32_t v) {
+      if (prev[v] != nil)
+        next[prev[v]] = next[v];
+      else
+        head[key[v]] = next[v];
+      if (next[v] != nil)
+        prev[next[v]] = prev[v];
+    }
+
+    void link(uint32_t v) {
+      if (head.size() <= key[v])
+        head.resize(key[v] + 1, uint32_t(nil));
+      prev[v] = nil;
+      next[v] = head[key[v]];
+      if (next[v] != nil)
+        prev[next[v]] = v;
+      head[key[v]] = v;
+    }
+
+  public:
+    explicit UnitHeap(uint32_t size)
+        : key(size, 0), prev(size), next(size), head(1, uint32_t(nil)),
+          removed(size, false) {
+      for (uint32_t v = size; v-- > 0;)
+        link(v);
+    }
+
+    void adjust(uint32_t v, int delta) {
+      if (removed[v])
+        return;
+      unlink(v);
+      key[v] += delta;
+      link(v);
+      top = std::max(top, key[v]);
+    }
+
+    void remove(uint32_t v) {
+      unlink(v);
+      removed[v] = true;
+    }
+
+    //! heap must not be empty
+    uint32_t pop() {
+      while (head[top] == nil)
+        --top;
+      uint32_t v = head[top];
+      remove(v);
+      return v;
+    }
+  };
+
+  //! adjacency of one range of nodes restricted to edges within the range
+  struct LocalGraph {
+    std::vector<uint64_t> outIdx, inIdx;
+    std::vector<uint32_t> outDst, inSrc;
+  };
+
+  Graph graph;
+
+  void buildLocal(GNode begin, GNode end, LocalGraph& g) {
+    uint32_t size = end - begin;
+    g.outIdx.assign(size + 1, 0);
+    g.inIdx.assign(size + 1, 0);
+    for (GNode n = begin; n < end; ++n) {
+      for (auto jj : graph.edges(n)) {
+        GNode dst = graph.getEdgeDst(jj);
+        if (dst >= begin && dst < end && dst != n) {
+          g.outDst.push_back(dst - begin);
+          g.inIdx[dst - begin + 1] += 1;
+        }
+      }
+      g.outIdx[n - begin + 1] = g.outDst.size();
+    }
+    std::partial_sum(g.inIdx.begin(), g.inIdx.end(), g.inIdx.begin());
+    g.inSrc.resize(g.outDst.size());
+    std::vector<uint64_t> cursor(g.inIdx.begin(), g.inIdx.end() - 1);
+    for (uint32_t v = 0; v < size; ++v) {
+      for (uint64_t e = g.outIdx[v]; e < g.outIdx[v + 1]; ++e)
+        g.inSrc[cursor[g.outDst[e]]++] = v;
+    }
+  }
+
+  //! adds delta to the score of every node related to v
+  void score(const LocalGraph& g, UnitHeap& heap, uint32_t v, int delta,
+             uint64_t hubDegree) {
+    for (uint64_t e = g.outIdx[v]; e < g.outIdx[v + 1]; ++e)
+      heap.adjust(g.outDst[e], delta);
+    for (uint64_t e = g.inIdx[v]; e < g.inIdx[v + 1]; ++e) {
+      uint32_t x = g.inSrc[e];
+      heap.adjust(x, delta);
+      if (g.outIdx[x + 1] - g.outIdx[x] > hubDegree)
+        continue;
+      for (uint64_t f = g.outIdx[x]; f < g.outIdx[x + 1]; ++f) {
+        if (g.outDst[f] != v)
+          heap.adjust(g.outDst[f], delta);
+      }
+    }
+  }
+
+  template <typename Permutation>
+  void orderRange(GNode begin, GNode end, Permutation& perm) {
+    uint32_t size = end - begin;
+    LocalGraph g;
+    buildLocal(begin, end, g);
+    uint64_t hubDegree = std::sqrt(double(size));
+
+    UnitHeap heap(size);
+    std::vector<uint32_t> placed;
+    placed.reserve(size);
+
+    uint32_t first = 0;
+    for (uint32_t v = 1; v < size; ++v) {
+      if (g.inIdx[v + 1] - g.inIdx[v] > g.inIdx[first + 1] - g.inIdx[first])
+        first = v;
+    }
+    heap.remove(first);
+    placed.push_back(first);
+    score(g, heap, first, 1, hubDegree);
+
+    const size_t window = std::max(1u, unsigned(gorderWindow));
+    while (placed.size() < size) {
+      if (placed.size() > window)
+        score(g, heap, placed[placed.size() - window - 1], -1, hubDegree);
+      uint32_t v = heap.pop();
+      placed.push_back(v);
+      score(g, heap, v, 1, hubDegree);
+    }
+
+    for (uint32_t i = 0; i < size; ++i)
+      perm[begin + placed[i]] = begin + i;
+  }
+
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::LargeArray<GNode> Permutation;
+
+    graph.fromFile(infilename);
+    const GNode numNodes = graph.size();
+    const unsigned parts = std::max(1, int(numParts));
+
+    Permutation perm;
+    perm.create(numNodes);
+    galois::do_all(galois::iterate(0u, parts),
+                   [&](unsigned part) {
+                     auto r =
+                         galois::block_range(GNode(0), numNodes, part, parts);
+                     if (r.first != r.second)
+                       orderRange(r.first, r.second, perm);
+                   },
+                   galois::steal(), galois::chunk_size<1>(),
+                   galois::no_stats(), galois::loopname("Gorder"));
+
+    Graph out;
+    galois::graphs::permute<EdgeTy>(graph, perm, out);
+    outputPermutation(perm, reorderPermutationFilename(outfilename));
+
+    out.toFile(outfilename);
+    printStatus(out.size(), out.sizeEdges());
+  }
+};
+
 struct ToBigEndian : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
@@ -1935,6 +2398,25 @@ struct Cleanup : public Conversion {
   }
 };
 
+struct Gr2CompressedGr : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::LC_Compressed_Graph<void, EdgeTy, true> Graph;
+
+    galois::graphs::FileGraph ingraph;
+    ingraph.fromFile(infilename);
+
+    Graph graph;
+    graph.constructFrom(ingraph);
+    graph.toFile(outfilename);
+
+    size_t inBytes = ingraph.sizeEdges() * sizeof(uint32_t);
+    std::cout << "Adjacency bytes: " << inBytes << " -> "
+              << graph.sizeEdgeBytes() << "\n";
+    printStatus(ingraph.size(), ingraph.sizeEdges());
+  }
+};
+
 template <template <typename, typename> class SortBy, bool NeedsEdgeData>
 struct SortEdges
     : public boost::mpl::if_c<NeedsEdgeData, HasNoVoidSpecialization,
@@ -2793,6 +3275,7 @@ int main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
   std::ios_base::sync_with_stdio(false);
+  galois::setActiveThreads(numThreads);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
     convert<Bipartitegr2Petsc<double, false>>();
@@ -2824,6 +3307,9 @@ int main(int argc, char** argv) {
   case gr2cgr:
     convert<Cleanup>();
     break;
+  case gr2compressedgr:
+    convert<Gr2CompressedGr>();
+    break;
   case gr2dimacs:
     convert<Gr2Dimacs>();
     break;
@@ -2836,6 +3322,15 @@ int main(int argc, char** argv) {
   case gr2edgelist1ind:
     convert<Gr2Edgelist1Ind>();
     break;
+  case gr2gordergr:
+    convert<GorderLite>();
+    break;
+  case gr2hubclustergr:
+    convert<HubReorder<false>>();
+    break;
+  case gr2hubsortgr:
+    convert<HubReorder<true>>();
+    break;
   case gr2linegr:
     convert<AddRing<true>>();
     break;
@@ -2863,6 +3358,9 @@ int main(int argc, char** argv) {
   case gr2randomweightgr:
     convert<RandomizeEdgeWeights>();
     break;
+  case gr2rcmgr:
+    convert<ReverseCuthillMcKee>();
+    break;
   case gr2ringgr:
     convert<AddRing<false>>();
     break;